@@ -0,0 +1,225 @@
+/*
+ * Copyright (C) 2022 Patrick Pedersen, TU-DO Makerspace
+
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * @file Adalight.h
+ * @author Patrick Pedersen
+ *
+ * @brief Provides the Adalight class.
+ *
+ * The following file provides the Adalight class, which streams
+ * frames received over serial straight to the strip.
+ *
+ */
+
+#pragma once
+
+#include <Arduino.h>
+
+#include <config.h>
+#include <Strip.h>
+
+#define ADALIGHT_RING_SIZE 64 /// Receive buffer size in bytes (power of 2)
+
+/**
+ * @brief Streams Adalight frames from the serial port to the strip.
+ *
+ * Frames are sent by the host in the Adalight format: The header
+ * "Ada", followed by the high and low byte of the LED count minus one,
+ * followed by their XOR with 0x55, followed by 3 bytes (RGB) per LED.
+ *
+ * With 2 KB of RAM, a long frame can't be buffered. Instead, the USART
+ * is polled before every pixel while the frame is transmitted, and
+ * received bytes only pass through a small ring buffer. The USART's
+ * 2 byte FIFO and shift register overrun once the start bit of a fourth
+ * byte arrives, so with bytes sent back to back, no more than 2 bytes may
+ * arrive while a pixel is transmitted (30 us, plus the time to poll and
+ * apply the pixel). At ADALIGHT_BAUD (500 kbaud, 20 us per byte) bytes
+ * thus arrive slower than the strip consumes them, and the transmission
+ * waits for each pixel once the buffer has run empty, which holds the
+ * data line low for up to ~30 us between pixels. A frame is only started
+ * once ADALIGHT_PREFILL pixels have been buffered, which absorbs jitter
+ * of the host. After each frame, ADALIGHT_ACK is sent so the host can
+ * pace its frames. If ADALIGHT_CTS_PIN is defined (see config.h), it is
+ * released whenever the buffer runs low on space.
+ *
+ * While streaming, the USART is taken over from Serial, so serial commands
+ * aren't available. Streaming ends once no data has been received for
+ * ADALIGHT_IDLE_TIMEOUT_MS (see quiet()).
+ *
+ * Timeouts within a frame are measured with Timer1, which must
+ * run freely at 16 us per tick (see FrameMeter::begin()). A frame is
+ * aborted if a pixel hasn't arrived ADALIGHT_RESET_MARGIN_US before the
+ * strip's reset time (see Strip::get_reset_time()) has passed, as the
+ * strip would otherwise latch the partial frame.
+ */
+class Adalight
+{
+private:
+	uint8_t ring[ADALIGHT_RING_SIZE];
+	uint8_t head = 0, tail = 0;
+	uint8_t hdr_idx = 0;
+	uint8_t hdr[3];
+	unsigned long frame_n = 0;
+	uint16_t pixel_timeout_us = 0; // Max. wait for a pixel within a frame
+	unsigned long last_rx_tstamp = 0;
+
+	uint16_t n_frames = 0;
+	uint16_t n_underruns = 0;
+	uint16_t n_overruns = 0;
+	uint16_t n_bad_headers = 0;
+
+#ifdef ADALIGHT_CTS_PIN
+	volatile uint8_t *cts_reg;
+	uint8_t cts_mask;
+#endif
+
+	/**
+	 * @brief Returns the number of buffered bytes.
+	 */
+	inline uint8_t available()
+	{
+		return head - tail;
+	}
+
+	/**
+	 * @brief Removes a byte from the buffer.
+	 */
+	inline uint8_t pop()
+	{
+		return ring[tail++ & (ADALIGHT_RING_SIZE - 1)];
+	}
+
+	/**
+	 * @brief Moves received bytes from the USART to the buffer.
+	 */
+	inline void poll()
+	{
+		while (UCSR0A & _BV(RXC0)) {
+			if (UCSR0A & _BV(DOR0))
+				n_overruns++;
+
+			uint8_t c = UDR0;
+			if (available() < ADALIGHT_RING_SIZE)
+				ring[head++ & (ADALIGHT_RING_SIZE - 1)] = c;
+			else
+				n_overruns++;
+		}
+
+#ifdef ADALIGHT_CTS_PIN
+		if (ADALIGHT_RING_SIZE - available() < ADALIGHT_CTS_MARGIN)
+			*cts_reg |= cts_mask;
+		else
+			*cts_reg &= ~cts_mask;
+#endif
+	}
+
+	/**
+	 * @brief Waits for bytes to be buffered.
+	 *
+	 * @param n The number of bytes to wait for.
+	 * @param timeout_us The max. time to wait (us).
+	 * @return bool True if the bytes have been buffered, false if the wait has timed out.
+	 */
+	bool wait(uint8_t n, uint16_t timeout_us);
+
+	/**
+	 * @brief Receives and transmits a frame.
+	 *
+	 * @param strip The strip to transmit the frame to.
+	 * @return bool True if the frame has been transmitted, false otherwise.
+	 */
+	bool stream(Strip &strip);
+
+public:
+	/**
+	 * @brief Starts streaming.
+	 *
+	 * The following function takes over the USART from Serial,
+	 * switches it to ADALIGHT_BAUD, and sends the Adalight
+	 * greeting ("Ada\n") to the host.
+	 *
+	 */
+	void begin();
+
+	/**
+	 * @brief Stops streaming and hands the USART back to Serial.
+	 */
+	void end();
+
+	/**
+	 * @brief Receives frames and transmits them. Call this function periodically!
+	 *
+	 * The following function parses the received data for a header,
+	 * and once a valid header has been received, transmits the frame
+	 * to the strip while receiving it.
+	 *
+	 * @param strip The strip to transmit the frame to.
+	 * @return bool True if a frame has been transmitted, false otherwise.
+	 *
+	 */
+	bool update(Strip &strip);
+
+	/**
+	 * @brief Returns if no data has been received for a while.
+	 *
+	 * @param ms The time without data in ms.
+	 * @return bool True if no data has been received for ms ms, false otherwise.
+	 *
+	 */
+	bool quiet(unsigned long ms);
+
+	/**
+	 * @brief Returns the number of LEDs of the last frame.
+	 */
+	unsigned long frame_len();
+
+	/**
+	 * @brief Prints the streaming statistics over serial.
+	 *
+	 * The following function prints the number of transmitted frames,
+	 * aborted frames (underruns), lost bytes (overruns) and invalid headers.
+	 *
+	 */
+	void print_stats();
+
+	/**
+	 * @brief Returns the next pixel of the frame (See Strip::stream_frame()).
+	 *
+	 * The following function is inlined into the strip's transmit loop.
+	 * The USART is polled on every call, even while the prefilled pixels
+	 * last, as its FIFO only holds the 3 bytes received per transmitted pixel.
+	 *
+	 * @param px Receives the next pixel.
+	 * @return bool True if a pixel has been received, false if it hasn't
+	 *              arrived in time (See class description).
+	 *
+	 */
+	inline bool next_pixel(ws2812_rgb &px)
+	{
+		poll();
+		if (available() < 3 && !wait(3, pixel_timeout_us))
+			return false;
+
+		px.r = pop();
+		px.g = pop();
+		px.b = pop();
+
+		return true;
+	}
+};
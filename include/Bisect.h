@@ -0,0 +1,127 @@
+/*
+ * Copyright (C) 2022 Patrick Pedersen, TU-DO Makerspace
+
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * @file Bisect.h
+ * @author Patrick Pedersen
+ *
+ * @brief Provides the Bisect class.
+ *
+ * The following file provides the Bisect class, which
+ * narrows down the position of a faulty LED by bisection.
+ *
+ */
+
+#pragma once
+
+#include <Arduino.h>
+
+/**
+ * @brief Narrows down the position of a faulty LED by bisection.
+ *
+ * WS2812 LEDs pass their data on to the next LED, so a dead or corrupting
+ * LED breaks every LED behind it. The Bisect class keeps track of the
+ * interval [lower(), upper()) that contains the first faulty LED. For each
+ * step, the first half of the interval is lit (see probe_first() and
+ * probe_len()), and the operator answers whether it is lit correctly
+ * (see answer()). As the LEDs in front of the interval are known to pass
+ * data correctly, a correctly lit half moves the search into the second
+ * half, otherwise the first half contains the faulty LED. After
+ * log2(n) steps, the interval is narrowed down to a single LED.
+ *
+ * If the operator never reports a fault, the search ends on the last LED
+ * of the initial interval, which should then be checked by hand.
+ */
+class Bisect
+{
+private:
+	unsigned long lo = 0;
+	unsigned long hi = 0;
+	uint8_t n_steps = 0;
+
+public:
+	/**
+	 * @brief Starts a new search.
+	 *
+	 * @param n The number of LEDs to search (LEDs 0 to n-1).
+	 *
+	 */
+	void start(unsigned long n);
+
+	/**
+	 * @brief Returns if the search has been narrowed down to a single LED.
+	 *
+	 * @return bool True if the faulty LED has been found, false otherwise.
+	 *
+	 */
+	bool done();
+
+	/**
+	 * @brief Returns the first LED to light for the current step.
+	 *
+	 * @return unsigned long The first LED to light.
+	 *
+	 */
+	unsigned long probe_first();
+
+	/**
+	 * @brief Returns the number of LEDs to light for the current step.
+	 *
+	 * Once the search is done, only the faulty LED is lit.
+	 *
+	 * @return unsigned long The number of LEDs to light.
+	 *
+	 */
+	unsigned long probe_len();
+
+	/**
+	 * @brief Narrows down the interval based on the operator's answer.
+	 *
+	 * The following function keeps the second half of the interval if the
+	 * probed LEDs are lit correctly, and the first half otherwise.
+	 * Answers are ignored once the search is done.
+	 *
+	 * @param lit True if the probed LEDs are lit correctly, false otherwise.
+	 *
+	 */
+	void answer(bool lit);
+
+	/**
+	 * @brief Returns the first LED of the remaining interval.
+	 *
+	 * @return unsigned long The first LED of the interval.
+	 *
+	 */
+	unsigned long lower();
+
+	/**
+	 * @brief Returns the end (exclusive) of the remaining interval.
+	 *
+	 * @return unsigned long The LED behind the last LED of the interval.
+	 *
+	 */
+	unsigned long upper();
+
+	/**
+	 * @brief Returns the number of answers given so far.
+	 *
+	 * @return uint8_t The number of completed steps.
+	 *
+	 */
+	uint8_t steps();
+};
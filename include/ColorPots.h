@@ -31,24 +31,57 @@
 
 #include <Arduino.h>
 
+#include <EventQueue.h>
+
 #define SHFT_ADC_TO_UINT8 2
 
 /**
  * @brief Provides a hardware abstraction to the color pots.
+ * 
+ * The pots are sampled round robin by the ADC interrupt, each
+ * across AVG_ADC_SAMPLES samples (see config.h). Whenever the average
+ * of a pot has been sampled, an EVENT_POT is posted to the event queue.
+ * Only a single ColorPots object may exist.
  */
 class ColorPots
 {
 private:
 	uint8_t pin_r, pin_g, pin_b;
-	uint8_t r, g, b;
+	uint16_t r, g, b; // 10-bit
 	unsigned long last_change_tstamp;
 
+	/**
+	 * @brief Applies new pot values if they have changed.
+	 * 
+	 * The following function stores the new pot values if any of them
+	 * differs from the stored value by at least POT_HYSTERESIS (see config.h),
+	 * so noise in the lowest bits doesn't register as a change.
+	 * 
+	 * @param _r New red value.
+	 * @param _g New green value.
+	 * @param _b New blue value.
+	 * @return bool True if any of the values have changed, false otherwise.
+	 * 
+	 */
+	bool apply(uint16_t _r, uint16_t _g, uint16_t _b);
+
+	/**
+	 * @brief Reads the pots and checks them for changes.
+	 * 
+	 * The following function reads all three pots, each averaged
+	 * across n_avg samples, and stores the results.
+	 * 
+	 * @param n_avg The number of samples to average over.
+	 * @return bool True if any of the values have changed, false otherwise.
+	 * 
+	 */
+	bool read(uint16_t n_avg);
+
 public:
 	/**
 	 * @brief Constructor for the ColorPots class.
 	 * 
-	 * The ColorPots constructor takes three potentiometer pins as an argument,
-	 * initializes the pins to input, and reads the initial potentiometer values.
+	 * The ColorPots constructor takes three potentiometer pins as an argument.
 	 *
 	 * @param pin_r The pin of the red potentiometer.
 	 * @param pin_g The pin of the green potentiometer.
@@ -58,12 +91,27 @@ public:
 	ColorPots(uint8_t pin_r, uint8_t pin_g, uint8_t pin_b);
 
 	/**
-	 * @brief Updates the ColorPots class. Call this function periodically!
+	 * @brief Initializes the ColorPots class.
+	 * 
+	 * The following function initializes the pins to input, and reads
+	 * the initial potentiometer values. To keep the boot time short,
+	 * the initial read only averages across AVG_ADC_SAMPLES_BOOT samples
+	 * (see config.h). Afterwards, the pots are sampled in the background.
+	 * It must be called once from setup() before using the class.
 	 * 
-	 * The following function is used to update the ColorPots class.
-	 * It should be called periodically and will read the latest
-	 * values from the potentiometers and check if they have changed
-	 * from the last call.
+	 * @param events The queue to post pot events to.
+	 * 
+	 */
+	void begin(EventQueue &events);
+
+	/**
+	 * @brief Updates the ColorPots class.
+	 * 
+	 * The following function applies the latest averages sampled in
+	 * the background, and checks if they have changed from the last call.
+	 * It only needs to be called once pot events have been received.
+	 * 
+	 * @return bool True if any of the values have changed, false otherwise.
 	 * 
 	 */
 	bool update();
@@ -78,6 +126,17 @@ public:
 	 * 
 	 */ 
 	bool zeroed();
+
+	/**
+	 * @brief Returns if all pots are set to their max position.
+	 * 
+	 * The following function is used to check if all pots are set 
+	 * to their max position.
+	 * 
+	 * @return bool True if all pots are set to their max position, false otherwise.
+	 * 
+	 */ 
+	bool maxed();
 	
 	/**
 	 * @brief Returns the values of the RGB pots from the last update() call.
@@ -92,6 +151,16 @@ public:
 	 */
 	void get_rgb(uint8_t &r, uint8_t &g, uint8_t &b);
 
+	/**
+	 * @brief Returns the 10-bit values of the RGB pots from the last update() call.
+	 * 
+	 * @param r Receives the fetched red value (0-1023).
+	 * @param g Receives the fetched green value (0-1023).
+	 * @param b Receives the fetched blue value (0-1023).
+	 * 
+	 */
+	void get_rgb10(uint16_t &r, uint16_t &g, uint16_t &b);
+
 	/**
 	 * @brief Returns the time (ms) since the last change in the RGB pots.
 	 * 
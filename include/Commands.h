@@ -0,0 +1,395 @@
+/*
+ * Copyright (C) 2022 Patrick Pedersen, TU-DO Makerspace
+
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * @file Commands.h
+ * @author Patrick Pedersen
+ *
+ * @brief Provides the tester's operating modes and serial commands.
+ *
+ * The following file provides the operating modes of the tester, the
+ * application of the inputs to the strip and display, and the handlers
+ * of the serial commands which control them. They are shared by the
+ * firmware (See main.cpp) and the firmware stand-in (See
+ * tools/client/standin), which define the objects declared below and
+ * list the handlers in their command tables (See SerialCmd).
+ *
+ */
+
+#pragma once
+
+#include <Arduino.h>
+
+#include <config.h>
+#include <Strip.h>
+#include <SizeEncoder.h>
+#include <ColorPots.h>
+#include <Display.h>
+#include <Bisect.h>
+#include <FrameMeter.h>
+#include <ResetCal.h>
+#include <Rle.h>
+#include <Adalight.h>
+#include <SerialCmd.h>
+
+// Encoder position held while the encoder answers yes/no questions
+// (bisection and calibration steps), leaves room to turn either way
+#define ANSWER_ENC_POS 1000
+
+/**
+ * @brief Operating modes of the tester.
+ */
+enum Mode : uint8_t {
+	MODE_SIZE,      /// Encoder sets the number of lit LEDs
+	MODE_WINDOW,    /// Encoder moves a window of win_len lit LEDs (see "win" command)
+	MODE_BISECT,    /// Encoder answers bisection steps (see "bisect" command)
+	MODE_RESET_CAL, /// Encoder answers reset time calibration steps (see "rstcal" command)
+	MODE_PATTERN    /// Strip shows an RLE frame, the encoder is ignored (see "pattern" and "rle" commands)
+};
+
+/**
+ * @brief Interpretations of the color pots.
+ */
+enum ColorInput : uint8_t {
+	COLOR_RGB,    /// Pots set red, green and blue
+	COLOR_HSV,    /// Pots set hue, saturation and value
+	COLOR_RAINBOW /// Pots set the hue increment per LED, saturation and value of a moving rainbow
+};
+
+// Defined by the firmware and the stand-in
+extern Strip strip;
+extern SizeEncoder size_enc;
+extern ColorPots color_pots;
+extern TesterDisplay display;
+extern Bisect bisect;
+extern FrameMeter frame_meter;
+extern ResetCal reset_cal;
+extern Adalight adalight;
+extern SerialCmd serial_cmd;
+
+extern Mode mode;
+extern unsigned long win_len;  /// Length of the window in MODE_WINDOW
+extern RlePattern rle_shown;   /// RLE frame shown in MODE_PATTERN
+extern bool rle_progmem;       /// rle_shown is stored in PROGMEM
+extern unsigned long rle_leds; /// Number of LEDs of rle_shown
+extern bool force_update;      /// Apply inputs on the next loop iteration, even if unchanged
+extern bool stress;            /// Refresh the strip back to back with alternating patterns (see "stress" command)
+extern ColorInput color_input;
+extern bool streaming;         /// Frames are streamed over serial (see "stream" command)
+extern bool stream_pending;    /// Start streaming once the command reply has been sent
+
+// Names of the shared commands (PROGMEM)
+extern const char cmd_leds_name[] PROGMEM;
+extern const char cmd_lat_name[] PROGMEM;
+extern const char cmd_win_name[] PROGMEM;
+extern const char cmd_bisect_name[] PROGMEM;
+extern const char cmd_stress_name[] PROGMEM;
+extern const char cmd_rstcal_name[] PROGMEM;
+extern const char cmd_dither_name[] PROGMEM;
+extern const char cmd_color_name[] PROGMEM;
+extern const char cmd_pattern_name[] PROGMEM;
+extern const char cmd_rle_name[] PROGMEM;
+extern const char cmd_stream_name[] PROGMEM;
+
+/**
+ * @brief Applies the color pots to the strip and display.
+ *
+ * Depending on the color input (See "color" command), the pots either set
+ * the RGB values, or the HSV values of a solid color or a moving rainbow.
+ *
+ */
+void apply_color();
+
+/**
+ * @brief Switches the operating mode.
+ *
+ * The following function switches the operating mode, and
+ * cancels an ongoing reset time calibration when leaving it,
+ * restoring the stored reset time.
+ *
+ * @param m The new mode.
+ *
+ */
+void set_mode(Mode m);
+
+/**
+ * @brief Handles the "lat" serial command.
+ *
+ * The following function prints the last measured
+ * input-to-light latency over serial.
+ *
+ * @param args Unused.
+ * @return bool Always true.
+ *
+ */
+bool cmd_lat(char *args);
+
+/**
+ * @brief Parses an LED count or index from serial command arguments.
+ *
+ * @param args The arguments, advanced past the parsed number.
+ * @param n Receives the parsed number.
+ * @return bool True if a number up to SIZE_ENC_MAX_POS (See config.h) has been parsed, false otherwise.
+ *
+ */
+bool parse_leds(char *&args, unsigned long &n);
+
+/**
+ * @brief Handles the "leds" serial command.
+ *
+ * The following function sets the number of lit LEDs, for
+ * chains too long to dial in with the encoder:
+ * 	"leds <n>"
+ * and returns to the size mode if a window is lit.
+ * Without arguments, the number of lit LEDs is printed.
+ *
+ * @param args The command arguments.
+ * @return bool True if the arguments are valid, false otherwise.
+ *
+ */
+bool cmd_leds(char *args);
+
+/**
+ * @brief Handles the "win" serial command.
+ *
+ * The following function enters the window mode, where only a
+ * window of LEDs is lit and the encoder moves the window:
+ * 	"win <first> <n>"
+ * or returns to the regular size mode:
+ * 	"win off"
+ *
+ * @param args The command arguments.
+ * @return bool True if the arguments are valid, false otherwise.
+ *
+ */
+bool cmd_win(char *args);
+
+/**
+ * @brief Handles the "bisect" serial command.
+ *
+ * The following function starts a bisection of the currently lit
+ * LEDs, or of the first n LEDs, to locate a faulty LED:
+ * 	"bisect [n]"
+ * Each step lights half of the remaining interval, and is answered by
+ * turning the encoder clockwise if the half is lit correctly, or
+ * counter-clockwise if it is not (See Bisect). The bisection is ended with:
+ * 	"bisect off"
+ * which returns to the size mode, lighting all LEDs up to the faulty one.
+ *
+ * @param args The command arguments.
+ * @return bool True if the arguments are valid, false otherwise.
+ *
+ */
+bool cmd_bisect(char *args);
+
+/**
+ * @brief Handles the "stress" serial command.
+ *
+ * The following function starts the stress mode, which refreshes
+ * the lit LEDs back to back as fast as possible, alternating
+ * between two patterns so every data bit toggles:
+ * 	"stress"
+ * The measured frame rate is shown on the display and logged
+ * every STRESS_REPORT_MSECS ms (See config.h and Log.h).
+ * The stress mode is stopped with:
+ * 	"stress off"
+ *
+ * @param args The command arguments.
+ * @return bool True if the arguments are valid, false otherwise.
+ *
+ */
+bool cmd_stress(char *args);
+
+/**
+ * @brief Ends the reset time calibration.
+ *
+ * The following function returns to the size mode, with
+ * all LEDs lit that have been lit during the calibration.
+ *
+ */
+void end_reset_cal();
+
+/**
+ * @brief Answers the current reset time calibration step.
+ *
+ * Once the calibration has completed, the minimum safe reset time
+ * is applied, stored in EEPROM and printed over serial.
+ *
+ * @param ok True if the strip latches correctly at the tested reset time, false otherwise.
+ *
+ */
+void reset_cal_answer(bool ok);
+
+/**
+ * @brief Handles the "rstcal" serial command.
+ *
+ * The following function starts the reset time calibration (See ResetCal):
+ * 	"rstcal"
+ * During the calibration, the lit LEDs are refreshed in bursts of back to
+ * back frames, separated only by the tested reset time. Each step is
+ * answered by turning the encoder clockwise if only the lit LEDs light up
+ * (the strip latches), or counter-clockwise if LEDs past them light up
+ * (it doesn't). Steps can also be answered over serial:
+ * 	"rstcal ok" or "rstcal fail"
+ * The calibration is cancelled with:
+ * 	"rstcal off"
+ * and the stored reset time is reset to WS2812_RESET_TIME with:
+ * 	"rstcal clear"
+ *
+ * @param args The command arguments.
+ * @return bool True if the arguments are valid, false otherwise.
+ *
+ */
+bool cmd_rstcal(char *args);
+
+/**
+ * @brief Handles the "dither" serial command.
+ *
+ * The following function enables or disables temporal dithering
+ * of the 10-bit pot values (See Strip::set_rgb10()):
+ * 	"dither on" or "dither off"
+ * or prints whether dithering is currently applied, along with the
+ * measured frame rate and the min. frame rate it requires:
+ * 	"dither"
+ *
+ * @param args The command arguments.
+ * @return bool True if the arguments are valid, false otherwise.
+ *
+ */
+bool cmd_dither(char *args);
+
+/**
+ * @brief Handles the "color" serial command.
+ *
+ * The following function selects how the color pots are read:
+ * 	"color rgb"     - Red, green and blue (default)
+ * 	"color hsv"     - Hue, saturation and value
+ * 	"color rainbow" - Moving rainbow, the hue pot sets the hue increment per LED
+ *
+ * @param args The command arguments.
+ * @return bool True if the arguments are valid, false otherwise.
+ *
+ */
+bool cmd_color(char *args);
+
+/**
+ * @brief Shows an RLE frame on the strip.
+ *
+ * The following function validates an RLE frame (See RleDecoder)
+ * and enters the pattern mode, where the strip shows the frame.
+ *
+ * @param data The encoded frame.
+ * @param len The size of the encoded frame in bytes.
+ * @param progmem True if the frame is stored in PROGMEM, false if it is stored in RAM.
+ * @return bool True if the frame is shown, false if it is invalid or can't be shown in the current mode.
+ *
+ */
+bool show_rle(const uint8_t *data, uint16_t len, bool progmem);
+
+/**
+ * @brief Handles the "pattern" serial command.
+ *
+ * The following function shows one of the RLE frames stored in
+ * PROGMEM (See patterns.h and scripts/rle_encode.py):
+ * 	"pattern <i>"
+ * The encoder is ignored while a frame is shown. The regular size
+ * mode is restored with:
+ * 	"pattern off"
+ *
+ * @param args The command arguments.
+ * @return bool True if the arguments are valid, false otherwise.
+ *
+ */
+bool cmd_pattern(char *args);
+
+/**
+ * @brief Handles the "rle" serial command.
+ *
+ * The following function receives an RLE frame of len bytes
+ * (up to RLE_BUF_SIZE, see config.h), which must directly follow
+ * the command line, and shows it like a stored frame (See cmd_pattern()):
+ * 	"rle <len>"
+ * Frames are encoded and sent by scripts/rle_encode.py. The frame is
+ * received by serial_cmd as it arrives (See SerialCmd::receive()), and
+ * the command is answered once it is shown, or has been rejected.
+ *
+ * @param args The command arguments.
+ * @return bool True if the frame is being received, false otherwise.
+ *
+ */
+bool cmd_rle(char *args);
+
+/**
+ * @brief Returns if the encoder position differs from the strip.
+ *
+ * Depending on the mode, the encoder either sets the number
+ * of lit LEDs, or the first LED of the lit window. While
+ * bisecting or calibrating, any turn of the encoder answers the current step.
+ * While an RLE frame is shown, the encoder is ignored.
+ *
+ * @return bool True if the strip doesn't reflect the encoder position, false otherwise.
+ *
+ */
+bool encoder_changed();
+
+/**
+ * @brief Applies the encoder position to the strip and display.
+ *
+ * See encoder_changed() for the meaning of the encoder position.
+ *
+ */
+void apply_encoder();
+
+/**
+ * @brief Handles the "stream" serial command.
+ *
+ * The following function switches the serial port to ADALIGHT_BAUD
+ * and shows the frames streamed by an Adalight compatible host
+ * (See Adalight and config.h):
+ * 	"stream"
+ * The reply is still sent at SERIAL_BAUD, streaming is started once it
+ * has been sent (See stream_pending). Streaming ends once the host
+ * has stopped sending data for ADALIGHT_IDLE_TIMEOUT_MS ms, after which
+ * the serial port is switched back and the streaming statistics are printed.
+ * Streaming isn't available in stress mode, or while bisecting or calibrating.
+ *
+ * @param args The command arguments.
+ * @return bool True if streaming is started, false otherwise.
+ *
+ */
+bool cmd_stream(char *args);
+
+/**
+ * @brief Starts streaming frames over serial.
+ */
+void start_stream();
+
+/**
+ * @brief Shows frames streamed over serial. Call this function on every loop iteration while streaming!
+ *
+ * While streaming, the USART is polled rather than interrupt driven, so
+ * bytes are lost whenever the firmware doesn't poll it for longer than
+ * the USART's FIFO lasts (~40 us at 500 kbaud). Instead of the regular loop,
+ * the following function thus only receives frames (See Adalight), and
+ * only renders the display after ADALIGHT_DISPLAY_GAP_MS ms without data
+ * (See config.h). The display shows the streamed LED count and the
+ * measured frame rate. Once the host has stopped streaming, the serial port
+ * is switched back and the inputs are applied to the strip again.
+ *
+ */
+void stream_frames();
@@ -30,10 +30,9 @@
 #pragma once
 
 #include <Arduino.h>
-#include <Adafruit_GFX.h>
-#include <Adafruit_SSD1306.h>
-#include <Wire.h>
 
+#include <config.h>
+#include <PagedSSD1306.h>
 #include <screensaver.h>
 
 /**
@@ -43,10 +42,32 @@ class Display
 {
 private:
 	bool show_screensaver = false;
-	String title_text;
+	bool show_diag = false;
+	bool redraw = false;
+	bool drawing = false;
+	uint8_t saver_frame = 0;         // Screensaver frame, 0: base image, else WaddleDeePatches[saver_frame - 1]
+	bool region_pending = false;     // A partial redraw of the region below is requested
+	uint8_t region_x0, region_x1;    // Columns of the region (x1 exclusive)
+	uint8_t region_p0, region_p1;    // Pages of the region (p1 exclusive)
+	uint16_t max_stack = 0, min_free = 0;
 	unsigned long n_leds = 0;
+	unsigned long first_led = 0;
+	bool window = false;
+	bool show_bisect_range = false;
+	unsigned long bisect_lo = 0, bisect_hi = 0;
+	bool show_reset_time = false;
+	uint16_t reset_time = 0;
+	bool show_streaming = false;
+	unsigned long frame_us = 0, frame_est_us = 0;
+	bool show_stress_stats = false;
+	uint16_t stress_fps = 0;
+	uint32_t stress_us = 0;
 	uint8_t r = 0, g = 0, b = 0;
-	Adafruit_SSD1306 *display;
+	bool show_hsv_values = false;
+	uint16_t hue = 0;
+	uint8_t sat = 0, val = 0;
+	bool gfx_text = false; // Draw the text fields through Adafruit_GFX instead of sprites (see set_gfx_text())
+	PagedSSD1306 display;
 
 	/**
 	 * @brief Handles the screensaver.
@@ -54,22 +75,98 @@ private:
 	 * The following function handles the Waddle Dee screensaver. 
 	 * It is called periodically by the update() function if the 
 	 * show_screensaver flag is set (See start_screensaver() and 
-	 * stop_screensaver()).
+	 * stop_screensaver()), and switches the frame whenever Waddle Dee
+	 * opens or closes its eyes (See set_saver_frame()).
 	 */
 	void screensaver();
 
+	/**
+	 * @brief Switches the screensaver frame.
+	 * 
+	 * The frames differ from the base image only in the rectangles of
+	 * their patches (See screensaver.h). Rather than redrawing the whole
+	 * screen, the following function requests a partial redraw of the
+	 * rectangles of the old and the new frame's patches (See add_region()).
+	 * 
+	 * @param frame The new frame, 0 for the base image.
+	 */
+	void set_saver_frame(uint8_t frame);
+
+	/**
+	 * @brief Adds a sprite's rectangle to the region to redraw.
+	 * 
+	 * The following function grows the pending partial redraw to the
+	 * bounding box of itself and the sprite. Partial redraws are skipped
+	 * while a full redraw is pending, which covers them.
+	 * 
+	 * @param sprite The sprite.
+	 */
+	void add_region(const PageSprite &sprite);
+
+	/**
+	 * @brief Draws the screensaver.
+	 * 
+	 * The following function draws the Waddle Dee screensaver
+	 * into the current page: The base image, XORed with the
+	 * patch of the current frame (See screensaver.h).
+	 */
+	void draw_screensaver();
+
+	/**
+	 * @brief Draws the diagnostics page.
+	 * 
+	 * The following function draws the hidden diagnostics page,
+	 * which shows the memory statistics set by set_mem_stats(),
+	 * into the current page. It is drawn instead of the main page
+	 * if the show_diag flag is set (See show_diagnostics()).
+	 */
+	void draw_diagnostics();
+
+	/**
+	 * @brief Draws the main page.
+	 * 
+	 * The following function draws the title, the LEDs count
+	 * and the RGB information into the current page. While
+	 * bisecting, the search interval is shown below the title,
+	 * and while calibrating, the tested reset time. Otherwise,
+	 * the frame time is shown there (See set_frame_time()).
+	 * In stress mode, the frame rate replaces the RGB information.
+	 * 
+	 * The LEDs count and the RGB information are redrawn on every change,
+	 * and are therefore drawn with pre-scaled sprites (see sprites.h)
+	 * rather than through Adafruit_GFX, which scales the font pixel by pixel.
+	 */
+	void draw_main();
+
+	/**
+	 * @brief Draws a string with a sprite font into the current page.
+	 * 
+	 * @param x The x coordinate of the string's left edge.
+	 * @param y The y coordinate of the string's top edge.
+	 * @param font The sprite font (see sprites.h).
+	 * @param str The string to draw.
+	 * 
+	 */
+	void blit_str(int16_t x, int16_t y, const SpriteFont &font, const char *str);
+
 public:
 	/**
 	 * @brief Constructor.
 	 * 
-	 * The constructor initializes the Adafruit_SSD1306 object,
-	 * and sets the title text which will be projected on the
-	 * top of the display.
+	 * The title on top of the display is composed from the
+	 * firmware info in config.h (FW_NAME, FW_REVISION and FW_AUTHORS).
+	 * 
+	 */
+	Display();
+
+	/**
+	 * @brief Initializes the display.
 	 * 
-	 * @param title_text The title text to be projected on the top of the display.
+	 * The following function initializes the PagedSSD1306 object.
+	 * It must be called once from setup() before using the class.
 	 * 
 	 */
-	Display(String title_text);
+	void begin();
 	
 	/**
 	 * @brief Starts the screensaver.
@@ -91,6 +188,27 @@ public:
 	 */
 	void stop_screensaver();
 
+	/**
+	 * @brief Shows or hides the diagnostics page.
+	 * 
+	 * The following function sets the show_diag flag. While the flag
+	 * is set, the update() function draws the diagnostics page instead
+	 * of the LED count and RGB information.
+	 * 
+	 * @param show True to show the diagnostics page, false to hide it.
+	 * 
+	 */
+	void show_diagnostics(bool show);
+
+	/**
+	 * @brief Sets/Updates the memory statistics of the diagnostics page.
+	 * 
+	 * @param max_stack Max. stack usage in bytes.
+	 * @param min_free Min. free RAM in bytes.
+	 * 
+	 */
+	void set_mem_stats(uint16_t max_stack, uint16_t min_free);
+
 	/**
 	 * @brief Sets/Updates the value of the LEDs count.
 	 * 
@@ -101,6 +219,113 @@ public:
 	 */
 	void set_n_leds(unsigned long n);
 
+	/**
+	 * @brief Sets/Updates the bounds of the lit window.
+	 * 
+	 * The following function sets/updates the bounds of the window
+	 * of lit LEDs, which are then shown below the LEDs count.
+	 * The bounds are hidden again by set_n_leds().
+	 * 
+	 * @param first The first LED of the window.
+	 * @param n The number of LEDs in the window.
+	 * 
+	 */
+	void set_window(unsigned long first, unsigned long n);
+
+	/**
+	 * @brief Shows or hides the bisection interval.
+	 * 
+	 * @param show True to show the interval set by set_bisect(), false to hide it.
+	 * 
+	 */
+	void show_bisect(bool show);
+
+	/**
+	 * @brief Sets/Updates the bisection interval.
+	 * 
+	 * The following function sets/updates the interval [lo, hi) that
+	 * contains the faulty LED (See Bisect). Once the interval has been
+	 * narrowed down to a single LED, the LED is shown instead.
+	 * 
+	 * @param lo The first LED of the interval.
+	 * @param hi The end (exclusive) of the interval.
+	 * 
+	 */
+	void set_bisect(unsigned long lo, unsigned long hi);
+
+	/**
+	 * @brief Shows or hides the tested reset time.
+	 * 
+	 * @param show True to show the reset time set by set_reset_test(), false to hide it.
+	 * 
+	 */
+	void show_reset_test(bool show);
+
+	/**
+	 * @brief Sets/Updates the tested reset time.
+	 * 
+	 * @param us The reset time in us that is being calibrated (See ResetCal).
+	 * 
+	 */
+	void set_reset_test(uint16_t us);
+
+	/**
+	 * @brief Shows or hides the streaming status.
+	 * 
+	 * @param show True while frames are streamed over serial (See Adalight), false otherwise.
+	 * 
+	 */
+	void show_stream(bool show);
+
+	/**
+	 * @brief Shows or hides the stress mode frame rate.
+	 * 
+	 * @param show True to show the frame rate set by set_stress() instead of the RGB information, false to hide it.
+	 * 
+	 */
+	void show_stress(bool show);
+
+	/**
+	 * @brief Sets/Updates the stress mode frame rate.
+	 * 
+	 * @param fps Measured frames per second.
+	 * @param us_per_frame Measured time per frame in us.
+	 * 
+	 */
+	void set_stress(uint16_t fps, uint32_t us_per_frame);
+
+	/**
+	 * @brief Sets/Updates the frame time.
+	 * 
+	 * The frame time is shown below the title as follows:
+	 * 	"T:<measured>/<estimated>us <max. frame rate>fps"
+	 * unless the line is taken by the bisection interval, the tested
+	 * reset time or the streaming status. Frame times of 10 ms
+	 * or more are shown in ms.
+	 * 
+	 * @param us Measured frame time in us (See Strip::frame_time()), 0 to hide the frame time.
+	 * @param est_us Estimated frame time in us (See Strip::frame_estimate()).
+	 * 
+	 */
+	void set_frame_time(unsigned long us, unsigned long est_us);
+
+	/**
+	 * @brief Shows HSV instead of RGB information.
+	 * 
+	 * @param show True to show the values set by set_hsv(), false to show the values set by set_rgb().
+	 * 
+	 */
+	void show_hsv(bool show);
+
+	/**
+	 * @brief Sets/Updates the values of the HSV information.
+	 * 
+	 * @param h Hue in degrees (0-359).
+	 * @param s Saturation (0-255).
+	 * @param v Value (0-255).
+	 */
+	void set_hsv(uint16_t h, uint8_t s, uint8_t v);
+
 	/**
 	 * @brief Sets/Updates the values of the RGB information.
 	 * 
@@ -115,8 +340,110 @@ public:
 	/**
 	 * @brief Updates the display.
 	 * 
-	 * The following function updates the information on the display.
-	 * It should be called periodically.
+	 * The following function requests the information on the display
+	 * to be redrawn. The display is redrawn by flush().
+	 * While the screensaver is shown, it should be called periodically.
 	 */
 	void update();
-};
\ No newline at end of file
+
+	/**
+	 * @brief Flushes the display in the background. Call this function periodically!
+	 * 
+	 * The display is drawn one page at a time, where each page is sent to
+	 * the display in the background (See PagedSSD1306 and Twi.h). Each call
+	 * of the following function draws the next page once the previous one
+	 * has been sent, and returns immediately otherwise. It should therefore
+	 * be called periodically until flushing() returns false.
+	 * If only a region has to be redrawn (See set_saver_frame()), only the
+	 * region's pages and columns are drawn and sent.
+	 */
+	void flush();
+
+	/**
+	 * @brief Measures the time it takes to render the main page.
+	 * 
+	 * The following function renders all pages of the main page n times
+	 * without sending them to the display, and returns the average time
+	 * per redraw. The text fields are either drawn with sprites, or through
+	 * Adafruit_GFX for comparison. A redraw is requested afterwards.
+	 * 
+	 * @param gfx True to draw the text fields through Adafruit_GFX, false to use sprites.
+	 * @param n The number of redraws to average over.
+	 * @return unsigned long The average time (us) per redraw.
+	 * 
+	 */
+	unsigned long benchmark(bool gfx, uint8_t n);
+
+	/**
+	 * @brief Selects how the text fields of the main page are drawn.
+	 * 
+	 * The text fields are drawn with sprites by default. Both ways draw
+	 * the same pixels, which the host tests check (See test/host), the
+	 * sprites are just faster (See benchmark()).
+	 * 
+	 * @param gfx True to draw the text fields through Adafruit_GFX, false to use sprites.
+	 * 
+	 */
+	void set_gfx_text(bool gfx);
+
+	/**
+	 * @brief Returns if the display is still being flushed.
+	 * 
+	 * @return bool True if pages are left to be drawn or sent, false otherwise.
+	 */
+	bool flushing();
+};
+
+/**
+ * @brief Stand-in for the Display class on testers without a display.
+ * 
+ * The NullDisplay class provides the public interface of the Display
+ * class with empty inline functions. Headless builds (See OLED_FITTED
+ * in config.h) use it in place of the Display class (See TesterDisplay),
+ * so neither the page buffer nor the drawing code end up in the firmware.
+ */
+class NullDisplay
+{
+public:
+	void begin() {}
+	void start_screensaver() {}
+	void stop_screensaver() {}
+	void show_diagnostics(bool /* show */) {}
+	void set_mem_stats(uint16_t /* max_stack */, uint16_t /* min_free */) {}
+	void set_n_leds(unsigned long /* n */) {}
+	void set_window(unsigned long /* first */, unsigned long /* n */) {}
+	void show_bisect(bool /* show */) {}
+	void set_bisect(unsigned long /* lo */, unsigned long /* hi */) {}
+	void show_reset_test(bool /* show */) {}
+	void set_reset_test(uint16_t /* us */) {}
+	void show_stream(bool /* show */) {}
+	void show_stress(bool /* show */) {}
+	void set_stress(uint16_t /* fps */, uint32_t /* us_per_frame */) {}
+	void set_frame_time(unsigned long /* us */, unsigned long /* est_us */) {}
+	void show_hsv(bool /* show */) {}
+	void set_hsv(uint16_t /* h */, uint8_t /* s */, uint8_t /* v */) {}
+	void set_rgb(uint8_t /* r */, uint8_t /* g */, uint8_t /* b */) {}
+	void update() {}
+	void flush() {}
+	unsigned long benchmark(bool /* gfx */, uint8_t /* n */) { return 0; }
+	void set_gfx_text(bool /* gfx */) {}
+	bool flushing() { return false; }
+};
+
+/**
+ * @brief Selects the display class of a build profile.
+ * 
+ * @tparam fitted True if a display is fitted (See OLED_FITTED in config.h).
+ */
+template <bool fitted>
+struct DisplaySelect {
+	typedef Display type;
+};
+
+template <>
+struct DisplaySelect<false> {
+	typedef NullDisplay type;
+};
+
+/// The display class of the build profile (Display, or NullDisplay for headless testers)
+typedef DisplaySelect<OLED_FITTED>::type TesterDisplay;
@@ -0,0 +1,118 @@
+/*
+ * Copyright (C) 2022 Patrick Pedersen, TU-DO Makerspace
+
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * @file EventQueue.h
+ * @author Patrick Pedersen
+ *
+ * @brief Provides the EventQueue class.
+ *
+ * The following file provides the EventQueue class, which passes
+ * input events from interrupt handlers to the main loop.
+ *
+ */
+
+#pragma once
+
+#include <Arduino.h>
+
+#include <config.h>
+
+static_assert((EVENT_QUEUE_SIZE & (EVENT_QUEUE_SIZE - 1)) == 0, "EVENT_QUEUE_SIZE must be a power of 2");
+
+/**
+ * @brief Types of input events.
+ */
+enum EventType : uint8_t {
+	EVENT_ENCODER, /// The encoder has moved (value: steps)
+	EVENT_POT      /// A pot average has been sampled (value: channel)
+};
+
+/**
+ * @brief An input event.
+ */
+struct Event {
+	EventType type;
+	int8_t value;
+};
+
+/**
+ * @brief Lock-free single-producer/single-consumer event ring.
+ *
+ * Interrupt handlers post events (see SizeEncoder and ColorPots), and
+ * the main loop collects them, rather than polling every input and
+ * comparing it to its previous value. Interrupts don't nest on the
+ * AVR, so all interrupt handlers together act as a single producer.
+ * The producer only writes the head index and the consumer only writes
+ * the tail index, both of which are single bytes, so neither side
+ * needs to disable interrupts.
+ *
+ * If the ring is full, events are dropped and the loss is reported
+ * by overflowed(), after which the consumer should re-read all inputs.
+ */
+class EventQueue
+{
+private:
+	volatile EventType types[EVENT_QUEUE_SIZE];
+	volatile int8_t values[EVENT_QUEUE_SIZE];
+	volatile uint8_t head = 0; // Written by the producer only
+	volatile uint8_t tail = 0; // Written by the consumer only
+	volatile bool lost = false;
+
+public:
+	/**
+	 * @brief Posts an event. Call this function from interrupt handlers only!
+	 *
+	 * @param type The type of the event.
+	 * @param value The value of the event (see EventType).
+	 * @return bool True if the event has been posted, false if the ring is full.
+	 *
+	 */
+	inline bool push(EventType type, int8_t value)
+	{
+		uint8_t h = head;
+
+		if ((uint8_t)(h - tail) >= EVENT_QUEUE_SIZE) {
+			lost = true;
+			return false;
+		}
+
+		types[h & (EVENT_QUEUE_SIZE - 1)] = type;
+		values[h & (EVENT_QUEUE_SIZE - 1)] = value;
+		head = h + 1; // Publish the event once it has been written
+
+		return true;
+	}
+
+	/**
+	 * @brief Removes the oldest event.
+	 *
+	 * @param ev Receives the event.
+	 * @return bool True if an event has been removed, false if the ring is empty.
+	 *
+	 */
+	bool pop(Event &ev);
+
+	/**
+	 * @brief Returns if events have been dropped since the last call.
+	 *
+	 * @return bool True if events have been dropped, false otherwise.
+	 *
+	 */
+	bool overflowed();
+};
@@ -0,0 +1,102 @@
+/*
+ * Copyright (C) 2022 Patrick Pedersen, TU-DO Makerspace
+
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * @file FrameMeter.h
+ * @author Patrick Pedersen
+ *
+ * @brief Provides the FrameMeter class.
+ *
+ * The following file provides the FrameMeter class, which
+ * measures the rate at which strip frames are transmitted.
+ *
+ */
+
+#pragma once
+
+#include <Arduino.h>
+
+/**
+ * @brief Measures the strip frame rate.
+ *
+ * Strip frames are transmitted with interrupts disabled, so millis()
+ * and micros() fall behind during long frames. The FrameMeter class
+ * instead runs Timer1 freely at 16 us per tick, which keeps counting
+ * while interrupts are disabled. The time between two frames is taken
+ * from the difference of two timer readings, which is exact as long
+ * as a single frame takes less than a timer period (~1 s, or roughly
+ * 30000 LEDs). The differences are summed up until STRESS_REPORT_MSECS
+ * have passed (see config.h), after which the frame rate is updated.
+ */
+class FrameMeter
+{
+private:
+	uint16_t last_tcnt = 0;
+	uint32_t ticks = 0;
+	uint16_t n_frames = 0;
+	uint16_t fps_val = 0;
+	uint32_t us_val = 0;
+
+public:
+	/**
+	 * @brief Initializes Timer1.
+	 *
+	 * The following function sets up Timer1 as a free running
+	 * counter. It must be called once from setup() before using the class.
+	 *
+	 */
+	void begin();
+
+	/**
+	 * @brief Starts a new measurement.
+	 */
+	void start();
+
+	/**
+	 * @brief Records a transmitted frame.
+	 *
+	 * The following function should be called right after
+	 * each frame has been transmitted.
+	 *
+	 */
+	void frame();
+
+	/**
+	 * @brief Updates the measured frame rate. Call this function periodically!
+	 *
+	 * @return bool True if a new measurement is available, false otherwise.
+	 *
+	 */
+	bool update();
+
+	/**
+	 * @brief Returns the last measured frame rate.
+	 *
+	 * @return uint16_t Frames per second.
+	 *
+	 */
+	uint16_t fps();
+
+	/**
+	 * @brief Returns the last measured time per frame.
+	 *
+	 * @return uint32_t Average time between two frames in us.
+	 *
+	 */
+	uint32_t us_per_frame();
+};
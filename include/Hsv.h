@@ -0,0 +1,80 @@
+/*
+ * Copyright (C) 2022 Patrick Pedersen, TU-DO Makerspace
+
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * @file Hsv.h
+ * @author Patrick Pedersen
+ *
+ * @brief Provides an integer HSV to RGB conversion.
+ *
+ * The following file provides an integer-only HSV to RGB conversion
+ * that is cheap enough to be run per pixel while a frame is transmitted.
+ *
+ */
+
+#pragma once
+
+#include <Arduino.h>
+
+#define HSV_HUE_MAX 1536 /// Hue range, 256 steps per sextant of the color wheel
+
+/**
+ * @brief Scales an 8-bit value by an 8-bit fraction.
+ *
+ * @param a The value to scale.
+ * @param frac The fraction (0-255, where 255 is 1).
+ * @return uint8_t a * frac / 255, rounded down.
+ *
+ */
+inline uint8_t scale8(uint8_t a, uint8_t frac)
+{
+	return ((uint16_t) a * (frac + 1)) >> 8;
+}
+
+/**
+ * @brief Converts an HSV color to RGB.
+ *
+ * The hue is split into one of six sextants (upper byte) and the
+ * position within the sextant (lower byte), so the conversion only
+ * requires a few 8x8 bit multiplications and no divisions. The result
+ * is within 2 steps of the floating-point conversion.
+ *
+ * @param h Hue (0 to HSV_HUE_MAX-1).
+ * @param s Saturation (0-255).
+ * @param v Value (0-255).
+ * @param r Receives the red value.
+ * @param g Receives the green value.
+ * @param b Receives the blue value.
+ *
+ */
+inline void hsv_to_rgb(uint16_t h, uint8_t s, uint8_t v, uint8_t &r, uint8_t &g, uint8_t &b)
+{
+	uint8_t f = h & 0xFF;
+	uint8_t p = scale8(v, 255 - s);
+	uint8_t q = scale8(v, 255 - scale8(s, f));
+	uint8_t t = scale8(v, 255 - scale8(s, 255 - f));
+
+	switch (h >> 8) {
+	case 0: r = v; g = t; b = p; break;
+	case 1: r = q; g = v; b = p; break;
+	case 2: r = p; g = v; b = t; break;
+	case 3: r = p; g = q; b = v; break;
+	case 4: r = t; g = p; b = v; break;
+	default: r = v; g = p; b = q; break;
+	}
+}
@@ -0,0 +1,128 @@
+/*
+ * Copyright (C) 2022 Patrick Pedersen, TU-DO Makerspace
+
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * @file InputWatch.h
+ * @author Patrick Pedersen
+ *
+ * @brief Provides the InputWatch class.
+ *
+ * The following file provides the InputWatch class, which
+ * detects input changes while interrupts are disabled.
+ *
+ */
+
+#pragma once
+
+#include <Arduino.h>
+
+/**
+ * @brief Detects input changes while interrupts are disabled.
+ *
+ * While a strip frame is transmitted, interrupts are disabled, so
+ * neither the encoder interrupts nor the main loop can register input
+ * changes. The InputWatch class instead polls the encoder pins and the
+ * pots directly, and is cheap enough to be polled between two pixels.
+ * The Strip class polls it once per STRIP_TX_BATCH LEDs (See config.h).
+ * The pots are sampled round robin with the ADC running in the background,
+ * and are considered changed once a sample deviates from the first
+ * sample of the same pot by more than a threshold (the pots are noisy).
+ * While armed, the ADC is borrowed from the background pot
+ * sampling (see ColorPots), which is resumed once disarmed.
+ */
+class InputWatch
+{
+private:
+	volatile uint8_t *enc_reg_a, *enc_reg_b;
+	uint8_t enc_mask_a, enc_mask_b;
+	uint8_t enc_state_a, enc_state_b;
+
+	uint8_t pot_ch[3];
+	uint16_t pot_ref[3];
+	uint8_t pot_valid;
+	uint8_t pot_idx;
+	uint16_t pot_threshold;
+
+	bool adc_borrowed = false; // ADC interrupt was enabled when armed
+	uint8_t adc_mux;
+
+	/**
+	 * @brief Starts an ADC conversion of the current pot.
+	 */
+	inline void start_conversion()
+	{
+		ADMUX = _BV(REFS0) | pot_ch[pot_idx];
+		ADCSRA |= _BV(ADSC);
+	}
+
+	/**
+	 * @brief Handles a completed ADC conversion.
+	 *
+	 * @return bool True if the pot has changed, false otherwise.
+	 */
+	bool check_pot();
+
+public:
+	/**
+	 * @brief Constructor.
+	 *
+	 * @param enc_a The pin connected to the encoder's A output.
+	 * @param enc_b The pin connected to the encoder's B output.
+	 * @param pot_r The pin of the red pot.
+	 * @param pot_g The pin of the green pot.
+	 * @param pot_b The pin of the blue pot.
+	 * @param pot_threshold Min. change of a pot (10-bit ADC value) that counts as input.
+	 *
+	 */
+	InputWatch(uint8_t enc_a, uint8_t enc_b, uint8_t pot_r, uint8_t pot_g, uint8_t pot_b, uint16_t pot_threshold);
+
+	/**
+	 * @brief Starts watching the inputs.
+	 *
+	 * The following function takes a snapshot of the encoder pins,
+	 * pauses the background pot sampling and starts sampling the pots.
+	 *
+	 */
+	void arm();
+
+	/**
+	 * @brief Stops watching the inputs.
+	 *
+	 * The following function waits for the ongoing ADC conversion
+	 * to complete, and resumes the background pot sampling.
+	 *
+	 */
+	void disarm();
+
+	/**
+	 * @brief Returns if an input has changed since arm() has been called.
+	 *
+	 * @return bool True if an input has changed, false otherwise.
+	 */
+	inline bool changed()
+	{
+		if ((*enc_reg_a & enc_mask_a) != enc_state_a ||
+		    (*enc_reg_b & enc_mask_b) != enc_state_b)
+			return true;
+
+		if (ADCSRA & _BV(ADSC))
+			return false;
+
+		return check_pot();
+	}
+};
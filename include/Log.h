@@ -0,0 +1,163 @@
+/*
+ * Copyright (C) 2022 Patrick Pedersen, TU-DO Makerspace
+
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * @file Log.h
+ * @author Patrick Pedersen
+ *
+ * @brief Non-blocking binary log.
+ *
+ * The following file provides a binary log, which doesn't stall the
+ * main loop the way Serial.print() does once the USART's transmit buffer
+ * is full. Log calls only append a compact record to a RAM ring buffer,
+ * which is moved into the USART's transmit buffer by log_flush() whenever
+ * it has room, and sent from there by the USART data register empty
+ * interrupt. If the ring buffer is full, records are dropped and counted
+ * rather than waited for, and the count is logged once there is room again.
+ *
+ * A record consists of LOG_SYNC, the message ID (See LogMessages.h),
+ * the length of the arguments and the arguments in their binary (little
+ * endian) representation. Records are only ever passed to the USART as a
+ * whole, so they can be interleaved with the text output of the serial
+ * commands, and are expanded to text by scripts/log_decode.py.
+ *
+ * @note The log is disabled if the USART drives the strip (See STRIP_USART_SPI
+ *       in config.h). While frames are streamed (See Adalight), records are
+ *       kept until the serial port has been switched back.
+ *
+ */
+
+#pragma once
+
+#include <Arduino.h>
+
+#include <config.h>
+#include <LogMessages.h>
+
+static_assert((LOG_BUF_SIZE & (LOG_BUF_SIZE - 1)) == 0, "LOG_BUF_SIZE must be a power of 2");
+
+#define LOG_SYNC 0xFF /// First byte of a record, never sent as text
+
+#define LOG_ENUM(id, fmt) id,
+
+/**
+ * @brief IDs of the log messages (See LogMessages.h).
+ */
+enum LogId : uint8_t {
+	LOG_MESSAGES(LOG_ENUM)
+	LOG_N_MESSAGES
+};
+
+#undef LOG_ENUM
+
+/**
+ * @brief Total size of a list of log arguments.
+ */
+template <typename... Args>
+struct LogSize;
+
+template <>
+struct LogSize<> {
+	static const uint8_t value = 0;
+};
+
+template <typename T, typename... Args>
+struct LogSize<T, Args...> {
+	static const uint8_t value = sizeof(T) + LogSize<Args...>::value;
+};
+
+/**
+ * @brief Appends a record to the ring buffer.
+ *
+ * The record is dropped if it doesn't fit. Safe to call from
+ * interrupt handlers.
+ *
+ * @param rec The record.
+ * @param len The size of the record in bytes.
+ *
+ */
+void log_write(const uint8_t *rec, uint8_t len);
+
+/**
+ * @brief Helper function to serialize log arguments (end of the list).
+ */
+inline void log_put(uint8_t * /* p */)
+{
+}
+
+/**
+ * @brief Helper function to serialize log arguments.
+ */
+template <typename T, typename... Args>
+inline void log_put(uint8_t *p, T arg, Args... args)
+{
+	memcpy(p, &arg, sizeof(T));
+	log_put(p + sizeof(T), args...);
+}
+
+/**
+ * @brief Logs a message.
+ *
+ * The following function logs a message with its arguments, for example:
+ *
+ * ```
+ * log_event(LOG_STRESS, fps, us_per_frame);
+ * ```
+ *
+ * The types of the arguments must match the message's format (See LogMessages.h).
+ * A call takes a few us and never blocks, which allows logging from the
+ * main loop and from interrupt handlers alike.
+ *
+ * @param id The ID of the message.
+ * @param args The arguments of the message.
+ *
+ */
+template <typename... Args>
+inline void log_event(LogId id, Args... args)
+{
+#ifndef STRIP_USART_SPI
+	static_assert(3 + LogSize<Args...>::value < LOG_BUF_SIZE, "Log record exceeds LOG_BUF_SIZE");
+
+	uint8_t rec[3 + LogSize<Args...>::value];
+
+	rec[0] = LOG_SYNC;
+	rec[1] = id;
+	rec[2] = LogSize<Args...>::value;
+	log_put(rec + 3, args...);
+
+	log_write(rec, sizeof(rec));
+#endif
+}
+
+/**
+ * @brief Moves records into the USART's transmit buffer. Call this function periodically!
+ *
+ * The following function passes as many complete records to Serial as
+ * fit into its transmit buffer without blocking, and returns immediately
+ * otherwise.
+ *
+ */
+void log_flush();
+
+/**
+ * @brief Returns the number of dropped records.
+ *
+ * @return uint16_t The number of records dropped since the last LOG_DROPPED record.
+ *
+ */
+uint16_t log_dropped();
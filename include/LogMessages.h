@@ -0,0 +1,46 @@
+/*
+ * Copyright (C) 2022 Patrick Pedersen, TU-DO Makerspace
+
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * @file LogMessages.h
+ * @author Patrick Pedersen
+ *
+ * @brief Lists the messages of the binary log.
+ *
+ * The following file lists the messages which can be logged through
+ * log_event() (See Log.h), as an X-macro of the message ID and its
+ * printf-style format string. The firmware only sends the ID and the
+ * binary arguments, the format strings are expanded on the host by
+ * scripts/log_decode.py, which parses this file.
+ *
+ * Each argument is sent with the size of its type, which the format
+ * must match: %hhu/%hhd for 8-bit, %u/%d/%x for 16-bit and %lu/%ld/%lx
+ * for 32-bit values. Messages must only be appended, so the IDs of the
+ * existing messages are kept.
+ *
+ */
+
+#pragma once
+
+#define LOG_MESSAGES(X) \
+	X(LOG_DROPPED,     "Log: %u records dropped") \
+	X(LOG_BOOT,        "Boot: %lu ms, reset time %u us") \
+	X(LOG_LATENCY,     "Input-to-light latency: %lu us") \
+	X(LOG_ABORTED,     "Frame aborted by input") \
+	X(LOG_EVENTS_LOST, "Input events lost") \
+	X(LOG_STRESS,      "Stress: %u fps, %lu us/frame")
@@ -0,0 +1,92 @@
+/*
+ * Copyright (C) 2022 Patrick Pedersen, TU-DO Makerspace
+
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * @file MemMonitor.h
+ * @author Patrick Pedersen
+ *
+ * @brief Provides the MemMonitor class.
+ *
+ * The following file provides the MemMonitor class, which
+ * keeps track of the stack high-water mark and the free RAM.
+ *
+ */
+
+#pragma once
+
+#include <Arduino.h>
+
+/**
+ * @brief Tracks the stack high-water mark and the free RAM.
+ *
+ * At boot (before any constructors run), the RAM between the end of the
+ * static data and the top of the stack is painted with a known pattern.
+ * The MemMonitor class then scans the painted region from the top of
+ * the heap upwards, until it hits the first byte that has been overwritten
+ * by the stack. The scan is done incrementally, only a few bytes per
+ * update() call, so it never adds a measurable delay to the main loop.
+ */
+class MemMonitor
+{
+private:
+	uint8_t *scan_ptr = nullptr;
+	uint8_t *heap_high = nullptr;
+	uint8_t *stack_low = (uint8_t *) RAMEND;
+	uint16_t min_free_ram = 0xFFFF;
+
+public:
+	/**
+	 * @brief Continues the stack scan. Call this function periodically!
+	 *
+	 * The following function scans the next few bytes (see MEMMON_SCAN_BYTES
+	 * in config.h) of the painted RAM region. Once a full scan has completed,
+	 * the high-water mark and the minimum free RAM are updated.
+	 *
+	 */
+	void update();
+
+	/**
+	 * @brief Returns the max. stack usage seen so far.
+	 *
+	 * @return uint16_t Bytes used by the stack at its high-water mark.
+	 *
+	 */
+	uint16_t max_stack();
+
+	/**
+	 * @brief Returns the minimum free RAM seen so far.
+	 *
+	 * The following function returns the minimum amount of RAM seen
+	 * between the heap's high-water mark and the stack's high-water mark.
+	 *
+	 * @return uint16_t Minimum free RAM in bytes.
+	 *
+	 */
+	uint16_t min_free();
+
+	/**
+	 * @brief Returns the currently free RAM.
+	 *
+	 * The following function returns the RAM currently free between
+	 * the top of the heap and the stack pointer.
+	 *
+	 * @return uint16_t Currently free RAM in bytes.
+	 *
+	 */
+	uint16_t free_now();
+};
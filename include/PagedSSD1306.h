@@ -0,0 +1,278 @@
+/*
+ * Copyright (C) 2022 Patrick Pedersen, TU-DO Makerspace
+
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * @file PagedSSD1306.h
+ * @author Patrick Pedersen
+ *
+ * @brief Provides the PagedSSD1306 class.
+ *
+ * The following file provides the PagedSSD1306 class, a
+ * page-at-a-time SSD1306 driver which only buffers a single
+ * 8 pixel high page instead of the whole screen, and flushes
+ * it in the background.
+ *
+ */
+
+#pragma once
+
+#include <Arduino.h>
+#include <Adafruit_GFX.h>
+
+#define SSD1306_WIDTH 128 /// Width of the display in pixels (= bytes per page)
+
+#define SSD1306_BLACK 0   /// Clears a pixel
+#define SSD1306_WHITE 1   /// Sets a pixel
+#define SSD1306_INVERSE 2 /// Inverts a pixel
+
+#ifndef WHITE
+#define WHITE SSD1306_WHITE
+#endif
+
+/**
+ * @brief Pre-scaled font for PagedSSD1306::blit_char().
+ *
+ * Each glyph is stored in PROGMEM in SSD1306 page format: For each
+ * of the glyph's pages (8 rows), one byte per column with the top
+ * row in the LSB. See sprites.h and scripts/gen_sprites.py.
+ */
+struct SpriteFont {
+	const char *chars;     /// Characters provided by the font (PROGMEM)
+	const uint8_t *glyphs; /// Glyph data in the order of chars (PROGMEM)
+	uint8_t w;             /// Width of a glyph in pixels
+	uint8_t pages;         /// Height of a glyph in pages
+	uint8_t advance;       /// Horizontal distance between two glyphs in pixels
+};
+
+/**
+ * @brief Sprite placed at a page boundary of the screen.
+ *
+ * The sprite is stored in PROGMEM in SSD1306 page format, w bytes per page.
+ * See PagedSSD1306::blit() and screensaver.h.
+ */
+struct PageSprite {
+	const uint8_t *data; /// Sprite data (PROGMEM)
+	uint8_t x;           /// Column of the sprite's left edge
+	uint8_t page;        /// Page of the sprite's top edge
+	uint8_t w;           /// Width of the sprite in pixels
+	uint8_t pages;       /// Height of the sprite in pages
+};
+
+/**
+ * @brief Page-at-a-time SSD1306 driver.
+ *
+ * The Adafruit_SSD1306 driver keeps a framebuffer of the whole screen
+ * (1 KB for 128x64 px), which is half of the ATmega328's RAM.
+ * The PagedSSD1306 class instead only keeps a single page (8 rows) in RAM.
+ * A screen is drawn by rendering it once per page, where each pass only
+ * keeps the pixels that fall into the current page. Once a page has been
+ * rendered, it is flushed to the display in the background (see Twi.h),
+ * and the next page can be rendered once the flush has completed:
+ *
+ * ```
+ * oled.first_page();
+ * do {
+ * 	while (!oled.ready());
+ * 	oled.setCursor(0, 0);
+ * 	oled.print(F("Hello"));
+ * } while (oled.next_page());
+ * ```
+ *
+ * Rather than busy waiting on ready(), callers can render a page
+ * whenever ready() returns true, and do other work in the meantime.
+ * To only update part of the screen, a frame can be limited to a
+ * rectangle of pages and columns with first_region() instead.
+ */
+class PagedSSD1306 : public Adafruit_GFX
+{
+private:
+	uint8_t i2c_addr;
+	uint8_t buf[SSD1306_WIDTH];
+	uint8_t page = 0;
+	uint8_t page_end = 0;             // Page past the last page of the frame
+	uint8_t col0 = 0;                 // First column of the frame
+	uint8_t cols = SSD1306_WIDTH;     // Columns per page of the frame
+	bool clear_pending = false;
+
+	/**
+	 * @brief Sends a list of commands.
+	 *
+	 * The following function sends a list of commands stored in
+	 * PROGMEM and waits for the transmission to complete.
+	 *
+	 * @param cmds The commands to send (PROGMEM).
+	 * @param n The number of commands to send.
+	 *
+	 */
+	void command_list(const uint8_t *cmds, uint8_t n);
+
+	/**
+	 * @brief Sends a single command.
+	 *
+	 * @param cmd The command to send.
+	 *
+	 */
+	void command(uint8_t cmd);
+
+public:
+	/**
+	 * @brief Constructor.
+	 *
+	 * @param h The height of the display in pixels.
+	 * @param i2c_addr The I2C address of the display.
+	 *
+	 */
+	PagedSSD1306(uint8_t h, uint8_t i2c_addr);
+
+	/**
+	 * @brief Initializes the display.
+	 *
+	 * The following function initializes the I2C bus and sends
+	 * the SSD1306 init sequence (internal charge pump).
+	 *
+	 * @param i2c_clock The I2C clock frequency in Hz.
+	 *
+	 */
+	void begin(uint32_t i2c_clock);
+
+	/**
+	 * @brief Starts rendering a new frame.
+	 *
+	 * The following function starts a new frame by waiting for any
+	 * ongoing flush to complete, setting up the display's address
+	 * window and clearing the page buffer for the first page.
+	 *
+	 */
+	void first_page();
+
+	/**
+	 * @brief Starts rendering a new frame limited to a rectangle.
+	 *
+	 * Like first_page(), but only the given pages and columns are
+	 * rendered and sent, the rest of the screen is left as is. Pixels
+	 * are drawn in screen coordinates, pixels outside of the rectangle
+	 * are discarded.
+	 *
+	 * @param x The first column of the rectangle.
+	 * @param w The width of the rectangle in columns.
+	 * @param p The first page of the rectangle.
+	 * @param pages The height of the rectangle in pages.
+	 *
+	 */
+	void first_region(uint8_t x, uint8_t w, uint8_t p, uint8_t pages);
+
+	/**
+	 * @brief Flushes the current page and moves on to the next one.
+	 *
+	 * The following function starts flushing the rendered page in
+	 * the background and moves on to the next page. The next page
+	 * may only be rendered once ready() returns true.
+	 *
+	 * @return bool True if there are pages left to render, false if the frame is complete.
+	 *
+	 */
+	bool next_page();
+
+	/**
+	 * @brief Returns if the current page can be rendered.
+	 *
+	 * The following function returns if the flush of the previous page
+	 * has completed. Once it has, the page buffer is cleared for the
+	 * current page.
+	 *
+	 * @return bool True if the current page can be rendered, false if a flush is still ongoing.
+	 *
+	 */
+	bool ready();
+
+	/**
+	 * @brief Returns the first row of the current page.
+	 *
+	 * @return int16_t The first row of the current page.
+	 *
+	 */
+	int16_t page_y();
+
+	/**
+	 * @brief Draws a pixel into the page buffer.
+	 *
+	 * The following function draws a pixel into the page buffer.
+	 * Pixels outside of the current page are discarded.
+	 *
+	 * @param x The x coordinate of the pixel.
+	 * @param y The y coordinate of the pixel.
+	 * @param color SSD1306_WHITE, SSD1306_BLACK or SSD1306_INVERSE.
+	 *
+	 */
+	void drawPixel(int16_t x, int16_t y, uint16_t color) override;
+
+	/**
+	 * @brief Draws a sprite into the page buffer.
+	 *
+	 * The following function ORs a sprite in SSD1306 page format into
+	 * the page buffer. Unlike drawing through Adafruit_GFX, which sets
+	 * the sprite pixel by pixel, each column of the current page is set
+	 * with a single shifted byte. The sprite may start at any row.
+	 *
+	 * @param x The x coordinate of the sprite's left edge.
+	 * @param y The y coordinate of the sprite's top edge.
+	 * @param sprite The sprite data (PROGMEM), w bytes per page.
+	 * @param w The width of the sprite in pixels.
+	 * @param pages The height of the sprite in pages.
+	 * @param color SSD1306_WHITE to set, SSD1306_BLACK to clear or
+	 *              SSD1306_INVERSE to invert (XOR) the sprite's set pixels.
+	 *
+	 */
+	void blit(int16_t x, int16_t y, const uint8_t *sprite, uint8_t w, uint8_t pages, uint8_t color = SSD1306_WHITE);
+
+	/**
+	 * @brief Draws a page aligned sprite into the page buffer.
+	 *
+	 * @param sprite The sprite.
+	 * @param color See blit().
+	 *
+	 */
+	void blit(const PageSprite &sprite, uint8_t color = SSD1306_WHITE);
+
+	/**
+	 * @brief Draws a character of a sprite font into the page buffer.
+	 *
+	 * Characters which aren't provided by the font are skipped.
+	 *
+	 * @param x The x coordinate of the character's left edge.
+	 * @param y The y coordinate of the character's top edge.
+	 * @param font The sprite font.
+	 * @param c The character to draw.
+	 * @return int16_t The x coordinate of the next character.
+	 *
+	 */
+	int16_t blit_char(int16_t x, int16_t y, const SpriteFont &font, char c);
+
+	/**
+	 * @brief Selects the page to render without sending anything.
+	 *
+	 * The following function selects a page and clears the page buffer,
+	 * so rendering can be benchmarked without the display. Any ongoing
+	 * flush must have completed, and the next frame must be started
+	 * with first_page().
+	 *
+	 * @param p The page to render.
+	 *
+	 */
+	void select_page(uint8_t p);
+};
@@ -0,0 +1,210 @@
+/*
+ * Copyright (C) 2022 Patrick Pedersen, TU-DO Makerspace
+
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * @file Pipeline.h
+ * @author Patrick Pedersen
+ *
+ * @brief Provides the compile-time pixel pipeline.
+ *
+ * The following file provides the PixelPipeline class template and its
+ * generators and stages, which compute the pixels of a frame right
+ * before they are transmitted (See Strip.cpp).
+ *
+ */
+
+#pragma once
+
+#include <Arduino.h>
+#include <ws2812.h>
+
+#include <Hsv.h>
+
+#define PIPELINE_INLINE inline __attribute__((always_inline))
+
+extern const uint8_t gamma8[256] PROGMEM; /// Gamma correction table (gamma 2.8)
+
+/**
+ * @brief Applies a chain of stages to a pixel.
+ *
+ * A stage is a type with a static apply(ws2812_rgb &px) function, which
+ * modifies the pixel in place. The stages are chained at compile time,
+ * and their apply() functions are forced inline, so a chain compiles
+ * into a single sequence of instructions without calls. As the stages'
+ * parameters are template arguments, disabled stages (ex. Gamma<false>)
+ * are removed entirely. A chain is a stage itself.
+ */
+template <typename... Stages>
+struct PixelStages;
+
+template <>
+struct PixelStages<> {
+	static PIPELINE_INLINE void apply(ws2812_rgb & /* px */)
+	{
+	}
+};
+
+template <typename Stage, typename... Rest>
+struct PixelStages<Stage, Rest...> {
+	static PIPELINE_INLINE void apply(ws2812_rgb &px)
+	{
+		Stage::apply(px);
+		PixelStages<Rest...>::apply(px);
+	}
+};
+
+/**
+ * @brief Computes pixels by passing a generator's output through a chain of stages.
+ *
+ * A generator is a type with a bool next(ws2812_rgb &px) function, which
+ * returns the next pixel, or false if there are no more pixels. next()
+ * of the pipeline is forced inline along with the generator's next()
+ * and all stages, so the transmit loop it is called from computes each
+ * pixel in one fused function rather than one pass or call per stage.
+ * This keeps the gap between two transmitted pixels short (See tx_pixels()
+ * in Strip.cpp).
+ */
+template <typename Gen, typename... Stages>
+class PixelPipeline
+{
+private:
+	Gen gen;
+
+public:
+	/**
+	 * @brief Constructor.
+	 *
+	 * @param gen The generator of the pipeline.
+	 *
+	 */
+	PixelPipeline(const Gen &gen)
+	: gen(gen)
+	{
+	}
+
+	/**
+	 * @brief Computes the next pixel.
+	 *
+	 * @param px Receives the next pixel.
+	 * @return bool True if a pixel has been computed, false if the generator has run out of pixels.
+	 *
+	 */
+	PIPELINE_INLINE bool next(ws2812_rgb &px)
+	{
+		if (!gen.next(px))
+			return false;
+
+		PixelStages<Stages...>::apply(px);
+		return true;
+	}
+};
+
+/**
+ * @brief Generates pixels of a single color.
+ */
+struct SolidGen {
+	ws2812_rgb color; /// The color of the pixels
+
+	PIPELINE_INLINE bool next(ws2812_rgb &px)
+	{
+		px = color;
+		return true;
+	}
+};
+
+/**
+ * @brief Generates a rainbow (See Strip::set_rainbow()).
+ */
+struct RainbowGen {
+	uint16_t hue;  /// Hue of the next pixel (0 to HSV_HUE_MAX-1)
+	uint16_t step; /// Hue increment from one pixel to the next
+	uint8_t s;     /// Saturation
+	uint8_t v;     /// Value
+
+	PIPELINE_INLINE bool next(ws2812_rgb &px)
+	{
+		hsv_to_rgb(hue, s, v, px.r, px.g, px.b);
+
+		hue += step;
+		if (hue >= HSV_HUE_MAX)
+			hue -= HSV_HUE_MAX;
+
+		return true;
+	}
+};
+
+/**
+ * @brief Gamma corrects a pixel (See gamma8).
+ *
+ * @tparam enabled False to pass pixels through unchanged.
+ */
+template <bool enabled>
+struct Gamma {
+	static PIPELINE_INLINE void apply(ws2812_rgb &px)
+	{
+		if (!enabled)
+			return;
+
+		px.r = pgm_read_byte(&gamma8[px.r]);
+		px.g = pgm_read_byte(&gamma8[px.g]);
+		px.b = pgm_read_byte(&gamma8[px.b]);
+	}
+};
+
+/**
+ * @brief Limits the brightness of a pixel.
+ *
+ * @tparam level Max. channel value (255: pixels are passed through unchanged).
+ */
+template <uint8_t level>
+struct Dim {
+	static PIPELINE_INLINE void apply(ws2812_rgb &px)
+	{
+		if (level == 255)
+			return;
+
+		px.r = scale8(px.r, level);
+		px.g = scale8(px.g, level);
+		px.b = scale8(px.b, level);
+	}
+};
+
+/**
+ * @brief Reorders the channels of a pixel into the strip's color order.
+ *
+ * Afterwards, r, g and b hold the first, second and third byte on the
+ * wire, for transmitters which send triplets as they are (rgb order).
+ *
+ * @tparam order The strip's color order.
+ */
+template <ws2812_order order>
+struct Order {
+	static PIPELINE_INLINE void apply(ws2812_rgb &px)
+	{
+		ws2812_rgb in = px;
+
+		switch (order) {
+		case rgb: break;
+		case rbg: px.g = in.b; px.b = in.g; break;
+		case grb: px.r = in.g; px.g = in.r; break;
+		case gbr: px.r = in.g; px.g = in.b; px.b = in.r; break;
+		case brg: px.r = in.b; px.g = in.r; px.b = in.g; break;
+		case bgr: px.r = in.b; px.b = in.r; break;
+		}
+	}
+};
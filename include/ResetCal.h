@@ -0,0 +1,121 @@
+/*
+ * Copyright (C) 2022 Patrick Pedersen, TU-DO Makerspace
+
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * @file ResetCal.h
+ * @author Patrick Pedersen
+ *
+ * @brief Provides the ResetCal class.
+ *
+ * The following file provides the ResetCal class, which
+ * calibrates the minimum reset time a strip reliably accepts.
+ *
+ */
+
+#pragma once
+
+#include <Arduino.h>
+
+/**
+ * @brief Calibrates the minimum reset time of a strip.
+ *
+ * WS2812 LEDs latch a frame once the data line has been held low for the
+ * reset time. Frames sent with a shorter gap don't latch, and are instead
+ * passed on to the LEDs past the lit area, which then light up. Many clone
+ * chips latch with far shorter gaps than the datasheet's, which raises the
+ * max. frame rate.
+ *
+ * The ResetCal class sweeps the reset time downward from WS2812_RESET_TIME
+ * (see config.h) in steps of RESET_CAL_STEP_US. For each step, the operator
+ * confirms whether the strip still latches correctly (see answer()). The
+ * sweep ends once latching fails, and the last confirmed reset time is kept.
+ * If WS2812_RESET_TIME itself fails, the reset time is swept upward instead,
+ * until the first reset time the strip accepts.
+ *
+ * Calibrated reset times are stored in EEPROM per strip profile
+ * (see STRIP_PROFILE_ID), and restored at boot through load().
+ */
+class ResetCal
+{
+private:
+	uint16_t test_us = 0;
+	uint16_t good_us = 0;
+	bool running = false;
+
+public:
+	/**
+	 * @brief Loads the calibrated reset time of a profile from EEPROM.
+	 *
+	 * @param profile The strip profile.
+	 * @return uint16_t The calibrated reset time in us, or WS2812_RESET_TIME if uncalibrated.
+	 *
+	 */
+	static uint16_t load(uint8_t profile);
+
+	/**
+	 * @brief Stores the calibrated reset time of a profile in EEPROM.
+	 *
+	 * @param profile The strip profile.
+	 * @param us The reset time in us, or 0 to clear the calibration.
+	 *
+	 */
+	static void store(uint8_t profile, uint16_t us);
+
+	/**
+	 * @brief Starts a new calibration at WS2812_RESET_TIME.
+	 */
+	void start();
+
+	/**
+	 * @brief Cancels the calibration.
+	 */
+	void cancel();
+
+	/**
+	 * @brief Returns if a calibration is in progress.
+	 *
+	 * @return bool True if a calibration is in progress, false otherwise.
+	 *
+	 */
+	bool active();
+
+	/**
+	 * @brief Returns the reset time to be tested.
+	 *
+	 * @return uint16_t The reset time to be tested in us.
+	 *
+	 */
+	uint16_t test_time();
+
+	/**
+	 * @brief Moves on to the next reset time based on the operator's answer.
+	 *
+	 * @param ok True if the strip latches correctly at test_time(), false otherwise.
+	 * @return bool True if the calibration has completed, false otherwise.
+	 *
+	 */
+	bool answer(bool ok);
+
+	/**
+	 * @brief Returns the result of the calibration.
+	 *
+	 * @return uint16_t The minimum safe reset time in us.
+	 *
+	 */
+	uint16_t result();
+};
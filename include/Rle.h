@@ -0,0 +1,151 @@
+/*
+ * Copyright (C) 2022 Patrick Pedersen, TU-DO Makerspace
+
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * @file Rle.h
+ * @author Patrick Pedersen
+ *
+ * @brief Provides the RleDecoder class.
+ *
+ * The following file provides the RleDecoder class, which decodes
+ * run-length encoded frames stored in PROGMEM or RAM.
+ *
+ */
+
+#pragma once
+
+#include <Arduino.h>
+#include <ws2812.h>
+
+#define RLE_LITERAL 0x80    /// Tag bit of a literal record (cleared: run record)
+#define RLE_COUNT_MASK 0x7F /// Tag bits holding the record's pixel count
+
+/**
+ * @brief An RLE frame stored in PROGMEM (See patterns.h).
+ */
+struct RlePattern {
+	const uint8_t *data; /// The encoded frame
+	uint16_t len;        /// The size of the encoded frame in bytes
+};
+
+/**
+ * @brief Decodes run-length encoded frames.
+ *
+ * An RLE frame is a sequence of records, terminated by an end marker:
+ *
+ * ```
+ * run:     tag, r, g, b              - count pixels of the same color
+ * literal: tag, (r, g, b) * count    - count pixels of individual colors
+ * end:     0x00, 0x00, 0x00
+ * ```
+ *
+ * The MSB of the tag selects a literal (RLE_LITERAL) or a run, the lower
+ * 7 bits hold the pixel count (1 to 127). A count of 0 is followed by the
+ * actual count as a 16-bit little endian value (1 to 65535), where an
+ * extended count of 0 marks the end of the frame.
+ *
+ * Runs are returned as a whole by next(), so Strip::rle_frame() can
+ * transmit them in batches, and literal pixels are returned one at a
+ * time. The frame is thus never expanded in RAM. Reads past the end of
+ * the data return 0, which decodes as an end marker, so broken frames
+ * end early rather than overrunning the data (see valid()).
+ * Frames are encoded by scripts/rle_encode.py.
+ */
+class RleDecoder
+{
+private:
+	const uint8_t *pos;
+	const uint8_t *end;
+	bool progmem;
+	uint16_t literal = 0; // Pixels left in the current literal record
+	bool broken = false;  // Data has ended before the end marker, or the frame is malformed
+
+	/**
+	 * @brief Reads the next byte of the frame.
+	 *
+	 * @return uint8_t The next byte, or 0 past the end of the data.
+	 */
+	inline uint8_t read()
+	{
+		if (pos == end) {
+			broken = true;
+			return 0;
+		}
+
+		return progmem ? pgm_read_byte(pos++) : *pos++;
+	}
+
+	/**
+	 * @brief Reads a pixel of the frame.
+	 *
+	 * @param px Receives the pixel.
+	 */
+	inline void read_px(ws2812_rgb &px)
+	{
+		px.r = read();
+		px.g = read();
+		px.b = read();
+	}
+
+public:
+	/**
+	 * @brief Constructor.
+	 *
+	 * @param data The encoded frame.
+	 * @param len The size of the encoded frame in bytes.
+	 * @param progmem True if the frame is stored in PROGMEM, false if it is stored in RAM.
+	 *
+	 */
+	RleDecoder(const uint8_t *data, uint16_t len, bool progmem);
+
+	/**
+	 * @brief Decodes the next span of pixels.
+	 *
+	 * The following function returns the next run, or the next
+	 * pixel of a literal record (n = 1).
+	 *
+	 * @param px Receives the color of the span.
+	 * @param n Receives the number of pixels in the span.
+	 * @return bool True if a span has been decoded, false at the end of the frame.
+	 *
+	 */
+	bool next(ws2812_rgb &px, uint16_t &n);
+
+	/**
+	 * @brief Returns if the frame has been decoded correctly.
+	 *
+	 * @return bool True if the frame has ended with an end marker within its data, false otherwise.
+	 *
+	 */
+	bool valid();
+
+	/**
+	 * @brief Returns the number of pixels of an encoded frame.
+	 *
+	 * The following function decodes a frame without transmitting
+	 * it, to validate frames before they are shown.
+	 *
+	 * @param data The encoded frame.
+	 * @param len The size of the encoded frame in bytes.
+	 * @param progmem True if the frame is stored in PROGMEM, false if it is stored in RAM.
+	 * @param n Receives the number of pixels in the frame.
+	 * @return bool True if the frame is valid, false otherwise.
+	 *
+	 */
+	static bool frame_len(const uint8_t *data, uint16_t len, bool progmem, unsigned long &n);
+};
@@ -0,0 +1,156 @@
+/*
+ * Copyright (C) 2022 Patrick Pedersen, TU-DO Makerspace
+
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * @file SerialCmd.h
+ * @author Patrick Pedersen
+ *
+ * @brief Provides the SerialCmd class.
+ *
+ * The following file provides the SerialCmd class, which
+ * reads and dispatches line based commands from the serial port.
+ *
+ */
+
+#pragma once
+
+#include <Arduino.h>
+
+#define SERIAL_CMD_MAX_LEN 32 /// Max. length of a command line (incl. arguments)
+
+/**
+ * @brief Command handler.
+ *
+ * @param args The arguments following the command name (may be empty).
+ * @return bool True if the command has been executed successfully, false otherwise.
+ */
+typedef bool (*serial_cmd_handler)(char *args);
+
+/**
+ * @brief Payload handler (See SerialCmd::receive()).
+ *
+ * @param data The received payload.
+ * @param len The size of the payload in bytes.
+ * @return bool True if the payload has been handled successfully, false otherwise.
+ */
+typedef bool (*serial_payload_handler)(uint8_t *data, uint16_t len);
+
+/**
+ * @brief Entry of a command table.
+ *
+ * Command tables are stored in PROGMEM, as are the command names.
+ */
+struct SerialCmdEntry
+{
+	const char *name;           /// Name of the command (PROGMEM)
+	serial_cmd_handler handler; /// Handler of the command
+};
+
+/**
+ * @brief Reads and dispatches serial commands.
+ *
+ * The following class reads characters from the serial port without
+ * blocking, and dispatches complete lines to the handler of the matching
+ * command table entry. Each line is answered with "ok" if its handler
+ * succeeded, or "err" if it failed or the command is unknown.
+ * This allows hosts to match replies to commands without waiting
+ * for each command to complete.
+ *
+ * Commands may be followed by a binary payload (See receive()), which
+ * is received as it arrives, like the command lines, so the main loop
+ * keeps running while a payload is uploaded.
+ */
+class SerialCmd
+{
+private:
+	const SerialCmdEntry *cmds;
+	uint8_t n_cmds;
+	char line[SERIAL_CMD_MAX_LEN + 1];
+	uint8_t len = 0;
+	bool overflow = false;
+
+	// Payload of the pending command (See receive())
+	uint8_t *payload;
+	uint16_t payload_len = 0; // Size of the payload, 0 if none is pending
+	uint16_t payload_n;       // Bytes received so far
+	serial_payload_handler payload_handler;
+	unsigned long payload_timeout;
+	unsigned long payload_tstamp; // Time of the last received byte
+
+	/**
+	 * @brief Dispatches the buffered line.
+	 *
+	 * @return bool True if the line has been handled successfully, false otherwise.
+	 */
+	bool dispatch();
+
+	/**
+	 * @brief Receives the available bytes of the pending payload.
+	 *
+	 * The following function answers the command once the payload is
+	 * complete and has been handled, or once it has timed out.
+	 *
+	 * @return bool True if the payload is no longer pending, false otherwise.
+	 */
+	bool read_payload();
+
+public:
+	/**
+	 * @brief Constructor.
+	 *
+	 * @param cmds The command table (PROGMEM).
+	 * @param n_cmds The number of entries in the command table.
+	 *
+	 */
+	SerialCmd(const SerialCmdEntry *cmds, uint8_t n_cmds);
+
+	/**
+	 * @brief Reads and dispatches commands. Call this function periodically!
+	 *
+	 * The following function reads all characters currently available on
+	 * the serial port, and dispatches a command once its line is complete.
+	 *
+	 */
+	void update();
+
+	/**
+	 * @brief Receives a binary payload following the command being handled.
+	 *
+	 * The following function can be called by a command handler to receive
+	 * n bytes directly following its command line. The bytes are read by
+	 * update() as they arrive, and passed to the payload handler once all
+	 * of them have been received. The command is only answered once the
+	 * payload handler returns, or with "err" if no byte has been received
+	 * for timeout_ms ms. The handler must return true for the payload to
+	 * be received.
+	 *
+	 * @param buf Receives the payload, it must not be used until the command is answered.
+	 * @param n The size of the payload in bytes (> 0).
+	 * @param handler The payload handler.
+	 * @param timeout_ms Max. time (ms) between two bytes of the payload.
+	 *
+	 */
+	void receive(uint8_t *buf, uint16_t n, serial_payload_handler handler, unsigned long timeout_ms);
+
+	/**
+	 * @brief Returns if a payload is being received (See receive()).
+	 *
+	 * @return bool True if the payload of a command is pending, false otherwise.
+	 */
+	bool receiving() const;
+};
@@ -29,24 +29,30 @@
 
 #pragma once
 
-#include <Encoder.h>
+#include <Arduino.h>
+
+#include <EventQueue.h>
 
 /**
  * @brief The size encoder class.
  * 
  * The following class is used to handle the 
  * rotary encoder which sets the strip size.
+ * The encoder is decoded by pin change interrupts on both
+ * pins, which post an EVENT_ENCODER to the event queue for
+ * every step. Only a single SizeEncoder may exist.
  * 
  */
 class SizeEncoder
 {
 private:
-	Encoder *enc;
+	uint8_t pin_a, pin_b;
 	unsigned long ready_time;
 	unsigned long saved_pos;
 	unsigned long rdy_pos;
 	
 	bool rdy;
+	bool settle_pending = false;
 	unsigned long rdy_tstamp;
 	unsigned long last_change_tstamp;
 
@@ -62,6 +68,14 @@ private:
 	 */ 
 	long read_enc();
 
+	/**
+	 * @brief Sets the position of the encoder.
+	 * 
+	 * @param pos The new position, in encoder steps (before the shift by SHFT_CORRECT_ENCODER_STEP_SIZE).
+	 * 
+	 */
+	void write_enc(long pos);
+
 	/**
 	 * @brief Prepares rdy and rdy_tstamp
 	 * 
@@ -88,10 +102,17 @@ public:
 	SizeEncoder(uint8_t pin_a, uint8_t pin_b, unsigned long ready_time_ms);
 
 	/**
-	 * @brief Destructor
-	 */ 
-	~SizeEncoder();
-	
+	 * @brief Initializes the SizeEncoder class.
+	 * 
+	 * The following function reads the initial encoder position
+	 * and attaches the encoder interrupts.
+	 * It must be called once from setup() before using the class.
+	 * 
+	 * @param events The queue to post encoder events to.
+	 * 
+	 */
+	void begin(EventQueue &events);
+
 	/**
 	 * @brief Position of the encoder after it is "ready"
 	 * 
@@ -103,6 +124,18 @@ public:
 	 */ 
 	unsigned long ready_pos();
 
+	/**
+	 * @brief Sets the position of the encoder
+	 * 
+	 * The following function overwrites the position of the
+	 * rotary encoder, for example when the meaning of the encoder
+	 * changes. The new position is considered ready right away.
+	 * Positions are limited to SIZE_ENC_MAX_POS (See config.h).
+	 * 
+	 * @param pos The new position of the encoder
+	 */
+	void set_pos(unsigned long pos);
+
 	/**
 	 * @brief Time (ms) since the last encoder change
 	 * 
@@ -145,7 +178,21 @@ public:
 	 * this function periodically. Violating the priorty requirements of this function
 	 * will result in sluggish/laggy reading of the encoder.
 	 * 
+	 * It only needs to be called once encoder events have been received, and
+	 * while the encoder isn't ready (see ready()).
+	 * 
 	 * @returns If rotary encoder position has changed
 	 */
 	bool update();
+
+	/**
+	 * @brief Returns if the encoder has become ready since the last call.
+	 * 
+	 * The following function returns true once for every time the encoder
+	 * has become ready after it has been turned, no matter how many steps
+	 * it has been turned by. Positions set by set_pos() don't count.
+	 * 
+	 * @returns If the encoder has settled on a new position
+	 */
+	bool settled();
 };
\ No newline at end of file
@@ -28,7 +28,22 @@
 
 #pragma once
 
-#include <ws2812_cpp.h>
+#include <ws2812.h>
+
+#include <config.h>
+
+#include <InputWatch.h>
+#include <Rle.h>
+
+/**
+ * @brief Parameters of the rainbow pattern (see Strip::set_rainbow()).
+ */
+struct StripRainbow {
+	uint16_t hue;  /// Hue of the first lit LED (0 to HSV_HUE_MAX-1)
+	uint16_t step; /// Hue increment from one LED to the next
+	uint8_t s;     /// Saturation
+	uint8_t v;     /// Value
+};
 
 /**
  * @brief The Strip class.
@@ -40,12 +55,60 @@
 class Strip
 {
 private:	
-	ws2812_cpp *ws2812_dev;
-	ws2812_rgb clr = {0, 0, 0};
+	uint8_t pin;
+	ws2812 ws2812_dev;
+	uint16_t level[3] = {0, 0, 0};      // 10-bit color (8.2 fixed point)
+	uint8_t dither_err[3] = {0, 0, 0}; // Fraction carried over to the next frame
+	bool dither = true;
+	bool rainbow = false;
+	StripRainbow rainbow_cfg = {0, 0, 0, 0};
 	
+	unsigned long first_led = 0;
 	unsigned long n_leds = 0;
-	unsigned long prev_n_leds = 0;
-	bool clear_strip = false;
+	unsigned long prev_end = 0; // End of the area lit by the last update_strip() call
+	unsigned long latch_tstamp = 0;
+	uint16_t reset_time = WS2812_RESET_TIME;
+	unsigned long frame_leds = 0; // LEDs transmitted by the last completed frame
+	unsigned long frame_us = 0;   // Measured time of the last completed frame
+	InputWatch *watch = nullptr;
+
+	bool input_pending = false;
+	unsigned long input_tstamp;
+	unsigned long latency = 0;
+
+	/**
+	 * @brief Transmits a frame of a single color.
+	 * 
+	 * The following function waits for the strip to latch
+	 * the previous frame (see latched()) and transmits a frame
+	 * where the n LEDs starting at the first LED are set to
+	 * the given color, and the LEDs before them are set to black.
+	 * 
+	 * @param r Red value.
+	 * @param g Green value.
+	 * @param b Blue value.
+	 * @param first The first LED to set.
+	 * @param n Number of LEDs to set.
+	 * @param n_clear Number of LEDs to clear after the set LEDs.
+	 * @return bool True if the frame has been transmitted, false if it
+	 *              has been aborted due to an input change (see set_input_watch()).
+	 */
+	bool commit(uint8_t r, uint8_t g, uint8_t b, unsigned long first, unsigned long n, unsigned long n_clear);
+
+	/**
+	 * @brief Starts timing a frame (See frame_time()).
+	 * 
+	 * @return uint16_t The Timer1 count at the start of the frame.
+	 */
+	uint16_t start_timing();
+
+	/**
+	 * @brief Stops timing a completed frame (See frame_time()).
+	 * 
+	 * @param start The Timer1 count returned by start_timing().
+	 * @param leds The number of LEDs transmitted by the frame.
+	 */
+	void stop_timing(uint16_t start, unsigned long leds);
 
 public:
 	/**
@@ -57,10 +120,13 @@ public:
 	Strip(uint8_t pin);
 
 	/**
+	 * @brief Initializes the WS2812 strip.
+	 * 
+	 * The following function configures the WS2812 device.
+	 * It must be called once from setup() before using the class.
 	 * 
-	 * @brief Destructor for the Strip class.
 	 */
-	~Strip();
+	void begin();
 
 	/**
 	 * @brief Sets the size/number of leds in the strip.
@@ -72,6 +138,21 @@ public:
 	 */
 	void set_n_leds(unsigned long n);
 
+	/**
+	 * @brief Sets a window of leds to be lit.
+	 * 
+	 * The following function is used to only light a window of n leds
+	 * starting at the first led, for example to test the far end
+	 * of a strip. The leds before the window are set to black, and
+	 * the transmission stops right after the window's end.
+	 * 
+	 * @param first The first led of the window.
+	 * @param n The number of leds in the window.
+	 * 
+	 * @note You must call update_strip() to apply the changes.
+	 */
+	void set_window(unsigned long first, unsigned long n);
+
 	/**
 	 * @brief Sets the color of the strip.
 	 * 
@@ -82,6 +163,94 @@ public:
 	 * @note You must call update_strip() to apply the changes.
 	 */
 	void set_rgb(uint8_t r, uint8_t g, uint8_t b);
+
+	/**
+	 * @brief Sets the color of the strip with 10-bit resolution.
+	 * 
+	 * The lower 2 bits of each channel are a fraction of an 8-bit
+	 * step, which is reached through temporal dithering: Each frame
+	 * carries the rounding error of a channel over to the next frame
+	 * (error diffusion), so the average over 4 frames matches the
+	 * 10-bit value. Since all lit LEDs share the same color, this only
+	 * requires a single accumulator per channel. Dithering requires the
+	 * strip to be refreshed continuously while both fractional() and
+	 * dithering() return true.
+	 * 
+	 * @param r Red value (0-1023).
+	 * @param g Green value (0-1023).
+	 * @param b Blue value (0-1023).
+	 * 
+	 * @note You must call update_strip() to apply the changes.
+	 */
+	void set_rgb10(uint16_t r, uint16_t g, uint16_t b);
+
+	/**
+	 * @brief Lights the strip with a moving rainbow.
+	 * 
+	 * The following function replaces the solid color with a rainbow,
+	 * where the hue advances by step from one LED to the next, and by
+	 * RAINBOW_SPEED (see config.h) from one frame to the next. The colors
+	 * are computed per LED while the frame is transmitted (see Hsv.h).
+	 * The rainbow is replaced by a solid color again through set_rgb()
+	 * or set_rgb10(), and requires the strip to be refreshed continuously.
+	 * 
+	 * @param step Hue increment from one LED to the next (0 to HSV_HUE_MAX-1).
+	 * @param s Saturation.
+	 * @param v Value.
+	 * 
+	 * @note You must call update_strip() to apply the changes.
+	 */
+	void set_rainbow(uint16_t step, uint8_t s, uint8_t v);
+
+	/**
+	 * @brief Returns if the strip shows a moving rainbow.
+	 * 
+	 * @return bool True if a rainbow is set (see set_rainbow()), false otherwise.
+	 * 
+	 */
+	bool animated();
+
+	/**
+	 * @brief Returns if the color lies between two 8-bit steps.
+	 * 
+	 * @return bool True if any channel has a fractional part (see set_rgb10()), false otherwise.
+	 * 
+	 */
+	bool fractional();
+
+	/**
+	 * @brief Enables or disables temporal dithering.
+	 * 
+	 * While dithering is disabled, fractional colors are rounded
+	 * to the nearest 8-bit step. Dithering is enabled by default.
+	 * 
+	 * @param enable True to enable dithering, false to disable it.
+	 * 
+	 */
+	void set_dithering(bool enable);
+
+	/**
+	 * @brief Returns if temporal dithering is enabled.
+	 * 
+	 * @return bool True if dithering is enabled (see set_dithering()), false otherwise.
+	 * 
+	 */
+	bool dithering();
+
+	/**
+	 * @brief Enables or disables white extraction on RGBW strips.
+	 * 
+	 * RGBW LEDs (STRIP_CHANNELS = 4) get the common part of the red, green
+	 * and blue channel on their W channel. By default, it is copied, so all
+	 * four dies are lit and toggled by test colors. With white extraction,
+	 * it is moved to the W channel instead, which should only be enabled for
+	 * user colors (See STRIP_WHITE_EXTRACT in config.h). The setting applies
+	 * to all following frames, and is ignored by RGB strips.
+	 * 
+	 * @param enable True to move the white part to the W channel, false to copy it.
+	 * 
+	 */
+	void set_white_extraction(bool enable);
 	
 	/**
 	 * @brief Gets the currently set size of the strip.
@@ -92,13 +261,25 @@ public:
 	 * @return unsigned long The currently set number of leds in the strip.
 	 * 
 	 */
-	unsigned int get_n_leds();
+	unsigned long get_n_leds();
+
+	/**
+	 * @brief Gets the first lit led.
+	 * 
+	 * The following function is used to get the first lit
+	 * led of the currently set window (see set_window()).
+	 * 
+	 * @return unsigned long The first lit led (0 unless a window is set).
+	 * 
+	 */
+	unsigned long get_first_led();
 
 	/**
 	 * @brief Gets the currently set color of the strip.
 	 * 
 	 * The following function is used to get the currently
-	 * set (see set_rgb()) color of the strip.
+	 * set (see set_rgb()) color of the strip, rounded
+	 * down to 8 bits if set through set_rgb10().
 	 * 
 	 * @param r Currently set red value.
 	 * @param g Currently set green value.
@@ -106,12 +287,198 @@ public:
 	 */
 	void get_rgb(uint8_t &r, uint8_t &g, uint8_t &b);
 
+	/**
+	 * @brief Returns if the strip has latched the last frame.
+	 * 
+	 * WS2812 LEDs latch a frame once the data line has been held low
+	 * for the reset time (see set_reset_time()). Rather than
+	 * busy waiting after each frame, the Strip class only waits for the
+	 * reset time to pass before the next frame is transmitted, so the gap
+	 * between frames can be used for other work (ex. flushing the display).
+	 * 
+	 * @return bool True if the reset time has passed since the last frame, false otherwise.
+	 */
+	bool latched();
+
+	/**
+	 * @brief Sets the reset time.
+	 * 
+	 * The following function sets the time (us) the data line is held
+	 * low between two frames for the strip to latch. It defaults to
+	 * WS2812_RESET_TIME (see config.h), and can be lowered to the
+	 * minimum a strip reliably accepts (see ResetCal).
+	 * 
+	 * @param us The reset time in us.
+	 * 
+	 */
+	void set_reset_time(uint16_t us);
+
+	/**
+	 * @brief Gets the reset time.
+	 * 
+	 * @return uint16_t The reset time in us (see set_reset_time()).
+	 * 
+	 */
+	uint16_t get_reset_time();
+
+	/**
+	 * @brief Marks leds as possibly lit.
+	 * 
+	 * The following function marks the first n leds as possibly lit,
+	 * so the next update_strip() call clears them. This is required
+	 * if leds past the lit area have been lit unintentionally, for
+	 * example by frames that haven't latched.
+	 * 
+	 * @param n The number of leds to clear (counted from the first led).
+	 * 
+	 */
+	void invalidate(unsigned long n);
+
 	/**
 	 * @brief Applies changes to the strip.
 	 * 
 	 * The following function applies the changes to the strip.
 	 * Call it after setting the color or the strip size (or both).
 	 * 
+	 * @return bool True if the changes have been applied, false if the
+	 *              transmission has been aborted due to an input change
+	 *              (see set_input_watch()). Aborted updates must be repeated.
+	 * 
+	 */
+	bool update_strip();
+
+	/**
+	 * @brief Transmits the current frame repeatedly.
+	 * 
+	 * The following function transmits the current frame n times back
+	 * to back, where consecutive frames are only separated by the reset
+	 * time (see set_reset_time()). Unlike repeated calls of update_strip()
+	 * from the main loop, the gap between frames doesn't depend on the
+	 * loop's duration, which allows the reset time to be tested.
+	 * 
+	 * @param n The number of frames to transmit.
+	 * @return bool True if all frames have been transmitted, false if a
+	 *              transmission has been aborted due to an input change.
+	 * 
+	 */
+	bool repeat_strip(uint8_t n);
+
+	/**
+	 * @brief Transmits a frame streamed from a pixel source.
+	 * 
+	 * The following function waits for the strip to latch the previous
+	 * frame, and transmits n pixels, each fetched from the source right
+	 * before it is transmitted, so frames of any length can be shown
+	 * without buffering them. LEDs past the streamed frame are cleared
+	 * by the next update_strip() call.
+	 * 
+	 * The source is a type with a bool next_pixel(ws2812_rgb &px) function,
+	 * which returns false to abort the frame. It is called with interrupts
+	 * disabled, and must return well within the strip's reset time, or
+	 * the strip latches the partial frame. Like the generators of a pixel
+	 * pipeline (See Pipeline.h), the source is resolved at compile time,
+	 * so it is inlined into the transmit loop. Sources are instantiated
+	 * in Strip.cpp.
+	 * 
+	 * @tparam Source The type of the pixel source (ex. Adalight).
+	 * @param n The number of pixels in the frame.
+	 * @param src The pixel source.
+	 * @return bool True if the frame has been transmitted, false if the source has aborted it.
+	 * 
+	 */
+	template <typename Source>
+	bool stream_frame(unsigned long n, Source &src);
+
+	/**
+	 * @brief Transmits a run-length encoded frame.
+	 * 
+	 * The following function waits for the strip to latch the previous
+	 * frame, and transmits a frame decoded from an RLE frame while it is
+	 * transmitted (See RleDecoder), so only the encoded frame is kept in
+	 * memory. LEDs lit past the frame by the previous frame are cleared.
+	 * Like update_strip(), the frame is timed (See frame_time()) and aborted
+	 * on input changes. The frame must be valid (See RleDecoder::frame_len()).
+	 * 
+	 * @param rle The decoder of the frame.
+	 * @return bool True if the frame has been transmitted, false if the
+	 *              transmission has been aborted due to an input change.
+	 * 
+	 */
+	bool rle_frame(RleDecoder &rle);
+
+	/**
+	 * @brief Returns the measured time of the last completed frame.
+	 * 
+	 * The following function returns the time (us) it has taken to
+	 * transmit the last completed frame, plus the reset time. This is the
+	 * min. time between two frames of the same length, its inverse the
+	 * max. frame rate.
+	 * 
+	 * @note The frame is timed with Timer1, which must run freely at
+	 *       16 us per tick (see FrameMeter::begin()).
+	 * 
+	 * @return unsigned long The measured frame time (us), 0 if no frame has completed yet.
+	 * 
+	 */
+	unsigned long frame_time();
+
+	/**
+	 * @brief Returns the theoretical time of the last completed frame.
+	 * 
+	 * The following function returns the time (us) the last completed
+	 * frame takes on the wire, 8 bits of WS2812_BIT_NS per channel and
+	 * transmitted LED (See config.h), plus the reset time. The difference to frame_time()
+	 * is the overhead of the transmission.
+	 * 
+	 * @return unsigned long The estimated frame time (us).
+	 * 
+	 */
+	unsigned long frame_estimate();
+
+	/**
+	 * @brief Returns the number of LEDs transmitted by the last completed frame.
+	 * 
+	 * @return unsigned long The number of LEDs of the last completed frame.
+	 * 
+	 */
+	unsigned long frame_len();
+
+	/**
+	 * @brief Sets the input watch used to abort transmissions.
+	 * 
+	 * With thousands of LEDs, a transmission can take tens of milliseconds.
+	 * Rather than finishing a stale frame once an input has changed, the
+	 * transmission is aborted if the input watch reports a change, so the
+	 * new values can be applied right away. The watch is checked once per
+	 * STRIP_TX_BATCH LEDs (once per LED for literal RLE pixels), so a moved
+	 * encoder aborts the frame within STRIP_TX_BATCH * WS2812_LED_US, e.g.
+	 * 240 us with the default profile (See config.h). As one pot is sampled
+	 * per check, a turned pot may take up to three checks.
+	 * 
+	 * @param watch The input watch, or nullptr to never abort transmissions.
+	 */
+	void set_input_watch(InputWatch *watch);
+
+	/**
+	 * @brief Marks an input change.
+	 * 
+	 * The following function marks the time of an input change,
+	 * from which the input-to-light latency is measured (see input_latency()).
+	 * Input changes detected during a transmission are marked automatically.
+	 */
+	void mark_input();
+
+	/**
+	 * @brief Returns the last measured input-to-light latency.
+	 * 
+	 * The following function returns the time (us) that has passed between
+	 * the last marked input change (see mark_input()) and the completion
+	 * of the frame which has applied it.
+	 * 
+	 * @note micros() doesn't advance reliably while interrupts are disabled,
+	 *       so the latency of long frames is underestimated.
+	 * 
+	 * @return unsigned long The last measured input-to-light latency (us).
 	 */
-	void update_strip();
+	unsigned long input_latency();
 };
@@ -0,0 +1,87 @@
+/*
+ * Copyright (C) 2022 Patrick Pedersen, TU-DO Makerspace
+
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * @file Twi.h
+ * @author Patrick Pedersen
+ *
+ * @brief Interrupt driven I2C (TWI) transmitter.
+ *
+ * The following file provides an interrupt driven, transmit-only I2C
+ * master for the ATmega328's TWI peripheral. Unlike the Wire library,
+ * transmissions run in the background, so the main loop isn't blocked
+ * while data is sent to the display.
+ *
+ * @note The TWI interrupt vector is defined by this module, thus it
+ *       must not be used together with the Wire library.
+ *
+ */
+
+#pragma once
+
+#include <Arduino.h>
+
+/**
+ * @brief Initializes the TWI peripheral.
+ *
+ * @param freq The I2C clock frequency in Hz.
+ *
+ */
+void twi_init(uint32_t freq);
+
+/**
+ * @brief Starts a transmission in the background.
+ *
+ * The following function starts a transmission of a control byte,
+ * followed by len bytes of data, to the device at addr. It waits for
+ * any previous transmission to complete before starting the new one,
+ * and returns once the new transmission has been started.
+ *
+ * @param addr The 7-bit address of the device.
+ * @param ctrl The control byte sent ahead of the data.
+ * @param data The data to send. Must remain valid until twi_busy() returns false!
+ * @param len The number of data bytes to send.
+ *
+ */
+void twi_write_async(uint8_t addr, uint8_t ctrl, const uint8_t *data, uint8_t len);
+
+/**
+ * @brief Sends data and waits for the transmission to complete.
+ *
+ * See twi_write_async() for the parameters.
+ *
+ * @return bool True if the device has acknowledged all bytes, false otherwise.
+ *
+ */
+bool twi_write(uint8_t addr, uint8_t ctrl, const uint8_t *data, uint8_t len);
+
+/**
+ * @brief Returns if a transmission is in progress.
+ *
+ * @return bool True if a transmission is in progress, false otherwise.
+ *
+ */
+bool twi_busy();
+
+/**
+ * @brief Waits for the current transmission to complete.
+ *
+ * @return bool True if the device has acknowledged all bytes, false otherwise.
+ *
+ */
+bool twi_wait();
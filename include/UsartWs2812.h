@@ -0,0 +1,110 @@
+/*
+ * Copyright (C) 2022 Patrick Pedersen, TU-DO Makerspace
+
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * @file UsartWs2812.h
+ * @author Patrick Pedersen
+ *
+ * @brief WS2812 transmitter using the USART in SPI mode.
+ *
+ * The following file provides an alternative to the bit-banged
+ * TinyWS2812 transmission, which shifts the WS2812 waveform out
+ * of the ATmega328's USART in master SPI mode (MSPIM). Each WS2812
+ * bit is encoded as 4 USART bits at 2.67 MHz (375 ns per bit):
+ *
+ * ```
+ * 0: 1000 (375 ns high, 1125 ns low)
+ * 1: 1100 (750 ns high,  750 ns low)
+ * ```
+ *
+ * so a USART byte holds two WS2812 bits, and each byte ends low.
+ * A WS2812 bit takes 1.5 us instead of 1.25 us, which is within the
+ * LEDs' tolerance.
+ *
+ * The CPU has to refill the double buffered data register within 3 us
+ * (48 cycles) of it becoming empty. A late refill stretches the low
+ * phase of a bit, which latches the strip early once it reaches the
+ * reset time of the LEDs, which is as short as RESET_CAL_MIN_US for
+ * calibrated strips (See config.h). Each of the firmware's interrupt
+ * handlers takes longer than that: Entering and leaving a handler alone
+ * takes ~26 cycles, Timer0's (millis()) ~100 cycles, and the ADC, TWI
+ * and encoder handlers, which save more registers and call further
+ * functions, well over 100 cycles each. Pending handlers also run back
+ * to back. Interrupts are hence disabled from usart_ws2812_prep_tx()
+ * to usart_ws2812_close_tx(), like during a TinyWS2812 transmission,
+ * and the gaps between two LEDs only depend on the code which computes
+ * them (See Strip.h).
+ *
+ * The strip's data line must be connected to TX (D1), and XCK (D4) is
+ * driven as the (unused) SPI clock. As the USART is shared with Serial,
+ * Serial must not be used along with this transmitter.
+ * Between frames, the transmitter is disabled and TX is driven low
+ * by the port, so the line is low during the reset time.
+ *
+ * @note The TinyWS2812 color order type (ws2812_order) is reused, so
+ *       both transmitters can be configured the same way.
+ *
+ */
+
+#pragma once
+
+#include <Arduino.h>
+#include <ws2812.h>
+
+/**
+ * @brief Initializes the USART as WS2812 transmitter.
+ *
+ * @param order The color order of the LEDs.
+ *
+ */
+void usart_ws2812_init(ws2812_order order);
+
+/**
+ * @brief Prepares a frame transmission.
+ *
+ * The following function disables interrupts until the frame
+ * is completed (See usart_ws2812_close_tx()), hands TX over to
+ * the USART and sends a leading low byte, so enabling the
+ * transmitter can't affect the first data bit.
+ *
+ */
+void usart_ws2812_prep_tx();
+
+/**
+ * @brief Transmits LEDs.
+ *
+ * The following function returns once the last byte has been
+ * written to the USART's data register, hence right away for the
+ * next call. Call it only between usart_ws2812_prep_tx() and
+ * usart_ws2812_close_tx().
+ *
+ * @param leds The colors of the LEDs.
+ * @param n The number of LEDs.
+ *
+ */
+void usart_ws2812_tx(const ws2812_rgb *leds, size_t n);
+
+/**
+ * @brief Completes a frame transmission.
+ *
+ * The following function waits for the last byte to be shifted
+ * out, drives TX low until the next frame, and restores the
+ * interrupt state from before usart_ws2812_prep_tx().
+ *
+ */
+void usart_ws2812_close_tx();
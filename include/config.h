@@ -28,14 +28,61 @@
 
 #pragma once
 
+#include <ws2812.h>
+
+// Build Profiles
+// Each PlatformIO environment builds the firmware for one of the profiles
+// below, selected through -DTESTER_PROFILE (See platformio.ini). The fields
+// of the selected profile (PROFILE) are compile-time constants, so code
+// paths disabled by a profile are removed by the compiler.
+#define PROFILE_WS2812B_GRB 0 /// WS2812B strips, GRB order (default)
+#define PROFILE_SK6812_RGBW 1 /// SK6812 RGBW strips, GRBW order
+#define PROFILE_LONG_CHAIN 2  /// Chains of thousands of LEDs, larger transmit batches
+#define PROFILE_LOW_RAM 3     /// Testers without display, minimal buffers
+
+#ifndef TESTER_PROFILE
+#define TESTER_PROFILE PROFILE_WS2812B_GRB
+#endif
+
+/**
+ * @brief Build profile of the tester (See PROFILE_* above).
+ */
+struct TesterProfile {
+	ws2812_order color_order; /// Color order of the LEDs (RGBW: order of the RGB part, W comes last)
+	uint8_t channels;         /// Color channels per LED (3: RGB, 4: RGBW)
+	uint16_t adc_samples;     /// Number of ADC samples averaged per pot reading
+	uint8_t tx_batch;         /// Number of equally colored LEDs transmitted per call
+	bool progress;            /// Print progress dots for long frames (See STRIP_PROGRESS)
+	bool display;             /// An OLED display is fitted
+	uint8_t event_queue_size; /// See EVENT_QUEUE_SIZE
+	uint8_t log_buf_size;     /// See LOG_BUF_SIZE
+	uint8_t rle_buf_size;     /// See RLE_BUF_SIZE
+};
+
+constexpr TesterProfile tester_profiles[] = {
+	// order, channels, adc_samples, tx_batch, progress, display, event_queue_size, log_buf_size, rle_buf_size
+	{grb, 3, 500, 8,  true,  true,  16, 64, 128}, // PROFILE_WS2812B_GRB
+	{grb, 4, 500, 8,  true,  true,  16, 64, 128}, // PROFILE_SK6812_RGBW
+	{grb, 3, 500, 32, true,  true,  16, 64, 128}, // PROFILE_LONG_CHAIN
+	{grb, 3, 64,  4,  false, false, 8,  32, 32},  // PROFILE_LOW_RAM
+};
+
+constexpr TesterProfile PROFILE = tester_profiles[TESTER_PROFILE];
+
 // RGB Pots
 #define POT_R A1            /// Pin for red pot
 #define POT_G A2            /// Pin for green pot
 #define POT_B A3 	    /// Pin for blue pot
-#define AVG_ADC_SAMPLES 500 /// Number of ADC samples to average
-                            /// to compensate for noisy pots
-#define POT_UPPER_BOUND 253 /// Upper bound for pot values
-#define POT_LOWER_BOUND 0   /// Lower bound for pot values
+#define AVG_ADC_SAMPLES (PROFILE.adc_samples) /// Number of ADC samples to average
+                                              /// to compensate for noisy pots
+#define AVG_ADC_SAMPLES_BOOT 16 /// Number of ADC samples to average for the
+                                /// quick initial read at boot (refined by
+                                /// the background sampling)
+#define POT_UPPER_BOUND 1015 /// Upper bound for (10-bit) pot values, snaps to 1023 above
+#define POT_LOWER_BOUND 0    /// Lower bound for (10-bit) pot values, snaps to 0 below
+#define POT_HYSTERESIS 2     /// Min. change of a (10-bit) pot value to be applied
+#define POT_ABORT_THRESHOLD 24 /// Min. change of a pot (10-bit ADC value) that aborts
+                               /// an ongoing strip transmission
 
 // Rotary Encoder
 #define ENC_A 3                          /// Pin connected to output A
@@ -45,11 +92,98 @@
                                          /// Ex. if the encoder increments in steps of 4,
                                          /// we must shift it by 2 bits (division by 4)
                                          /// to increment in steps of 1
+#define SIZE_ENC_MAX_POS (0x7FFFFFFFUL / WS2812_LED_US) /// Max. LED count, limited by the frame time (us) fitting 31 bits
+                                                       /// (32 bits leave no headroom for frames sent below wire rate)
+
+// Input Events
+#define EVENT_QUEUE_SIZE (PROFILE.event_queue_size) /// Number of input events buffered between two
+                                                   /// loop iterations (power of 2)
 
 // WS2812 Strip
 #define WS2812_PIN 5
-#define WS2812_RESET_TIME 60 //ms
-#define WS2812_COLOR_ORDER grb
+#define WS2812_RESET_TIME 60 //us
+// #define STRIP_CONTINUOUS_REFRESH /// Refresh the strip continuously while the encoder is idle
+                                    /// (ex. to light up strips that are plugged in while testing)
+#define WS2812_COLOR_ORDER (PROFILE.color_order) /// Applied by the pixel pipeline (See StripStages in Strip.cpp)
+#define STRIP_GAMMA false     /// Gamma correct all colors (See Gamma in Pipeline.h)
+#define STRIP_MAX_LEVEL 255   /// Max. channel value, colors are scaled down to limit the
+                              /// strip's current (255: no limit)
+#define STRIP_CHANNELS (PROFILE.channels) /// Color channels per LED, RGBW LEDs also get the white
+                                          /// part of each color on their W channel
+#define STRIP_WHITE_EXTRACT false /// RGBW: Move the white part of the pots' and streamed colors to the
+                                  /// W channel rather than copying it (test and stress frames always
+                                  /// light all four channels, See Strip::set_white_extraction())
+#define STRIP_TX_BATCH (PROFILE.tx_batch) /// Number of equally colored LEDs transmitted per call, the input
+                                          /// watch is checked once per batch (See Strip::set_input_watch()),
+                                          /// STRIP_TX_BATCH * WS2812_LED_US apart: WS2812B_GRB 240 us,
+                                          /// SK6812_RGBW 320 us, LONG_CHAIN 960 us, LOW_RAM 120 us
+                                          /// (288/384/1152/144 us with STRIP_USART_SPI)
+#define STRIP_PROFILE_ID TESTER_PROFILE   /// Profile under which the calibrated reset time is stored in EEPROM
+// #define STRIP_USART_SPI   /// Shift frames out of the USART in SPI mode instead of bit-banging
+                             /// them (See UsartWs2812.h). The strip must then be connected to
+                             /// TX (D1) instead of WS2812_PIN, and Serial (serial commands and
+                             /// diagnostics) is disabled.
+
+#ifdef STRIP_USART_SPI
+#define WS2812_BIT_NS 1500   /// Duration (ns) of a data bit, for the frame time estimate
+#define STRIP_PROGRESS false // The USART is busy with the frame
+#else
+#define WS2812_BIT_NS 1250   /// Duration (ns) of a data bit, for the frame time estimate
+#define STRIP_PROGRESS (PROFILE.progress) /// Print a '.' over serial for every 65536 LEDs of a frame
+                                          /// (long frames take seconds to transmit)
+#endif
+#define WS2812_LED_US (8UL * STRIP_CHANNELS * WS2812_BIT_NS / 1000) /// Duration (us) of an LED's data on the wire
+
+// Reset Time Calibration
+#define RESET_CAL_STEP_US 5       /// Step (us) by which the reset time is swept
+#define RESET_CAL_MIN_US 5        /// Lowest reset time (us) tested
+#define RESET_CAL_MAX_US 300      /// Highest reset time (us) tested if WS2812_RESET_TIME fails
+#define RESET_CAL_BURST 16        /// Number of back to back frames transmitted per test burst
+#define RESET_CAL_CLEAR_LEDS 1024 /// Number of LEDs cleared after testing, as frames that failed
+                                  /// to latch light up LEDs past the lit area
+#define RESET_CAL_EEPROM_ADDR 0   /// EEPROM address of the calibrated reset times (4 bytes per profile)
+
+// Temporal Dithering
+#define DITHER_MIN_CYCLE_HZ 100                 /// Min. rate (Hz) at which the 4 frame dither cycle
+                                                /// must repeat to appear flicker-free
+#define DITHER_MIN_FPS (4 * DITHER_MIN_CYCLE_HZ) /// Min. measured frame rate to apply dithering,
+                                                 /// fractional colors are rounded below it
+
+// HSV Input
+#define RAINBOW_STEP_SHFT 4 /// Bitshifts applied to the hue pot to get the hue increment per LED
+                            /// (4: a full color wheel across at least 16 LEDs)
+#define RAINBOW_SPEED 8     /// Hue increment per frame of the rainbow pattern (1536 per color wheel)
+
+// Adalight Streaming
+#define ADALIGHT_BAUD 500000UL         /// Baud rate while streaming, at most 2 bytes may arrive per LED
+                                       /// transmitted, or the USART overruns (See Adalight)
+#define ADALIGHT_PREFILL 8             /// Pixels buffered before a streamed frame is transmitted
+#define ADALIGHT_RESET_MARGIN_US 12    /// The max. wait for a pixel before a frame is aborted is the strip's
+                                       /// reset time minus this margin, or the strip latches a partial frame
+#define ADALIGHT_PREFILL_WAIT_US 768   /// Max. wait (us) for the prefilled pixels before a frame is aborted
+#define ADALIGHT_IDLE_TIMEOUT_MS 5000  /// Streaming ends after this long without data
+#define ADALIGHT_ACK 0x06              /// Byte sent after each transmitted frame
+#define ADALIGHT_DISPLAY_GAP_MS 20     /// The display is only rendered after this long without data
+// #define ADALIGHT_CTS_PIN 4          /// Optional flow control output (low: clear to send),
+                                       /// for USB-serial adapters with a CTS input
+#define ADALIGHT_CTS_MARGIN 16         /// Free buffer bytes below which CTS is released
+
+// RLE Frames (See Rle.h)
+#define RLE_BUF_SIZE (PROFILE.rle_buf_size) /// Max. size (bytes) of an RLE frame uploaded over serial
+#define RLE_UPLOAD_TIMEOUT_MS 1000 /// Max. time (ms) between two bytes of an uploaded RLE frame
+#define RLE_BENCH_ROUNDS 10        /// Decode passes per pattern of the "bench rle" command
+
+// Pixel Pipeline (See Pipeline.h)
+#define PIPE_BENCH_PIXELS 1000 /// Pixels computed by the "bench pipe" command
+
+// Logging (See Log.h)
+#define LOG_BUF_SIZE (PROFILE.log_buf_size) /// Size (bytes) of the log's ring buffer (power of 2),
+                                            /// records logged while it is full are dropped
+
+// Stress Mode
+#define STRESS_REPORT_MSECS 1000 /// Interval (ms) at which the measured frame rate is reported
+#define STRESS_PATTERN_A 0x55    /// Channel value of even frames
+#define STRESS_PATTERN_B 0xAA    /// Channel value of odd frames (every bit toggles)
 
 // Waddle Dee Screensaver (BMP data stored in screensaver.h)
 #define SCREEN_SAVER_CREDITS_MSG F("Credits:u/LordShrekM8") /// Credits message to display on screensaver
@@ -69,5 +203,22 @@
 // #define OLED_I2C_DAT A4      /// HARDCODED/UNUSED, KEPT HERE FOR DOCUMENTATION PURPOSES
 #define OLED_WIDTH 128          /// Width of the display in pixels
 #define OLED_HEIGHT 64          /// Height of the display in pixels
-#define OLED_RESET -1           /// Reset pin (or -1 if unused)
-#define OLED_I2C_ADDRESS 0x3C   /// I2C address of the display
\ No newline at end of file
+// #define OLED_RESET -1        /// UNUSED, RESET PIN NOT SUPPORTED BY PagedSSD1306
+#define OLED_I2C_ADDRESS 0x3C   /// I2C address of the display
+#define OLED_I2C_CLOCK 400000UL /// I2C clock (Hz) used to flush the display
+#define OLED_FITTED (PROFILE.display) /// False for headless testers, the display is then compiled out (See NullDisplay)
+
+// Serial
+#define SERIAL_BAUD 9600 /// Baud rate of the serial port (commands and diagnostics)
+
+// Memory Monitor
+#define MEMMON_SCAN_BYTES 4    /// Number of bytes scanned for stack usage per loop iteration
+#define DIAG_REFRESH_MSECS 500 /// Refresh interval (ms) of the hidden diagnostics page
+                               /// (shown while the LED count is 0 and all pots are maxed out)
+
+// Debugging
+// #define DEBUG_BOOT_TIMELINE  /// Print the time (ms) spent on each init step over serial
+
+#if defined(DEBUG_BOOT_TIMELINE) && defined(STRIP_USART_SPI)
+#error "DEBUG_BOOT_TIMELINE requires Serial, which is disabled by STRIP_USART_SPI"
+#endif
\ No newline at end of file
@@ -0,0 +1,90 @@
+/*
+ * Copyright (C) 2022 Patrick Pedersen, TU-DO Makerspace
+
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * @file patterns.h
+ * @author Patrick Pedersen
+ *
+ * @brief Contains the stored RLE frames of the "pattern" command.
+ *
+ * The following file contains run-length encoded frames (See Rle.h).
+ * It has been generated by scripts/rle_encode.py, DO NOT EDIT!
+ */
+
+#pragma once
+
+#include <Arduino.h>
+
+#include <Rle.h>
+
+// Colors, 40 LEDs, 19 bytes
+const uint8_t RlePattern0[] PROGMEM = {
+	0x0a, 0xff, 0x00, 0x00, 0x0a, 0x00, 0xff, 0x00, 0x0a, 0x00, 0x00, 0xff,
+	0x0a, 0xff, 0xff, 0xff, 0x00, 0x00, 0x00,
+};
+
+// Every 10th, 300 LEDs, 243 bytes
+const uint8_t RlePattern1[] PROGMEM = {
+	0x09, 0x00, 0x00, 0x00, 0x81, 0xff, 0xff, 0xff, 0x09, 0x00, 0x00, 0x00,
+	0x81, 0xff, 0xff, 0xff, 0x09, 0x00, 0x00, 0x00, 0x81, 0xff, 0xff, 0xff,
+	0x09, 0x00, 0x00, 0x00, 0x81, 0xff, 0xff, 0xff, 0x09, 0x00, 0x00, 0x00,
+	0x81, 0xff, 0xff, 0xff, 0x09, 0x00, 0x00, 0x00, 0x81, 0xff, 0xff, 0xff,
+	0x09, 0x00, 0x00, 0x00, 0x81, 0xff, 0xff, 0xff, 0x09, 0x00, 0x00, 0x00,
+	0x81, 0xff, 0xff, 0xff, 0x09, 0x00, 0x00, 0x00, 0x81, 0xff, 0xff, 0xff,
+	0x09, 0x00, 0x00, 0x00, 0x81, 0xff, 0xff, 0xff, 0x09, 0x00, 0x00, 0x00,
+	0x81, 0xff, 0xff, 0xff, 0x09, 0x00, 0x00, 0x00, 0x81, 0xff, 0xff, 0xff,
+	0x09, 0x00, 0x00, 0x00, 0x81, 0xff, 0xff, 0xff, 0x09, 0x00, 0x00, 0x00,
+	0x81, 0xff, 0xff, 0xff, 0x09, 0x00, 0x00, 0x00, 0x81, 0xff, 0xff, 0xff,
+	0x09, 0x00, 0x00, 0x00, 0x81, 0xff, 0xff, 0xff, 0x09, 0x00, 0x00, 0x00,
+	0x81, 0xff, 0xff, 0xff, 0x09, 0x00, 0x00, 0x00, 0x81, 0xff, 0xff, 0xff,
+	0x09, 0x00, 0x00, 0x00, 0x81, 0xff, 0xff, 0xff, 0x09, 0x00, 0x00, 0x00,
+	0x81, 0xff, 0xff, 0xff, 0x09, 0x00, 0x00, 0x00, 0x81, 0xff, 0xff, 0xff,
+	0x09, 0x00, 0x00, 0x00, 0x81, 0xff, 0xff, 0xff, 0x09, 0x00, 0x00, 0x00,
+	0x81, 0xff, 0xff, 0xff, 0x09, 0x00, 0x00, 0x00, 0x81, 0xff, 0xff, 0xff,
+	0x09, 0x00, 0x00, 0x00, 0x81, 0xff, 0xff, 0xff, 0x09, 0x00, 0x00, 0x00,
+	0x81, 0xff, 0xff, 0xff, 0x09, 0x00, 0x00, 0x00, 0x81, 0xff, 0xff, 0xff,
+	0x09, 0x00, 0x00, 0x00, 0x81, 0xff, 0xff, 0xff, 0x09, 0x00, 0x00, 0x00,
+	0x81, 0xff, 0xff, 0xff, 0x09, 0x00, 0x00, 0x00, 0x81, 0xff, 0xff, 0xff,
+	0x00, 0x00, 0x00,
+};
+
+// Rainbow, 32 LEDs, 100 bytes
+const uint8_t RlePattern2[] PROGMEM = {
+	0xa0, 0xff, 0x00, 0x00, 0xff, 0x2f, 0x00, 0xff, 0x5f, 0x00, 0xff, 0x8f,
+	0x00, 0xff, 0xbf, 0x00, 0xff, 0xef, 0x00, 0xdf, 0xff, 0x00, 0xaf, 0xff,
+	0x00, 0x7f, 0xff, 0x00, 0x4f, 0xff, 0x00, 0x1f, 0xff, 0x00, 0x00, 0xff,
+	0x0f, 0x00, 0xff, 0x3f, 0x00, 0xff, 0x6f, 0x00, 0xff, 0x9f, 0x00, 0xff,
+	0xcf, 0x00, 0xff, 0xff, 0x00, 0xcf, 0xff, 0x00, 0x9f, 0xff, 0x00, 0x6f,
+	0xff, 0x00, 0x3f, 0xff, 0x00, 0x0f, 0xff, 0x1f, 0x00, 0xff, 0x4f, 0x00,
+	0xff, 0x7f, 0x00, 0xff, 0xaf, 0x00, 0xff, 0xdf, 0x00, 0xff, 0xff, 0x00,
+	0xef, 0xff, 0x00, 0xbf, 0xff, 0x00, 0x8f, 0xff, 0x00, 0x5f, 0xff, 0x00,
+	0x2f, 0x00, 0x00, 0x00,
+};
+
+// Halves, 1000 LEDs, 15 bytes
+const uint8_t RlePattern3[] PROGMEM = {
+	0x00, 0xf4, 0x01, 0xff, 0x00, 0x00, 0x00, 0xf4, 0x01, 0x00, 0x00, 0xff,
+	0x00, 0x00, 0x00,
+};
+
+const RlePattern rle_patterns[] PROGMEM = {
+	{RlePattern0, sizeof(RlePattern0)},
+	{RlePattern1, sizeof(RlePattern1)},
+	{RlePattern2, sizeof(RlePattern2)},
+	{RlePattern3, sizeof(RlePattern3)},
+};
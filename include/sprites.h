@@ -0,0 +1,83 @@
+/*
+ * Copyright (C) 2022 Patrick Pedersen, TU-DO Makerspace
+
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ * 
+ */
+
+/**
+ * @file sprites.h
+ * @author Patrick Pedersen
+ * 
+ * @brief Contains the sprite fonts for PagedSSD1306::blit_char().
+ * 
+ * The following file contains pre-scaled sprite fonts in SSD1306 page
+ * format. It has been generated by scripts/gen_sprites.py, DO NOT EDIT!
+ */
+
+#pragma once
+
+#include <Arduino.h>
+
+#include <PagedSSD1306.h>
+
+// RGB/HSV information and long LEDs counts, text size 1, 5x8px per glyph
+const char SpriteFontSmallChars[] PROGMEM = " 0123456789:BDEGHLRSVs";
+const uint8_t SpriteFontSmallGlyphs[] PROGMEM = {
+	0x00, 0x00, 0x00, 0x00, 0x00, // ' '
+	0x3e, 0x51, 0x49, 0x45, 0x3e, // '0'
+	0x00, 0x42, 0x7f, 0x40, 0x00, // '1'
+	0x72, 0x49, 0x49, 0x49, 0x46, // '2'
+	0x21, 0x41, 0x49, 0x4d, 0x33, // '3'
+	0x18, 0x14, 0x12, 0x7f, 0x10, // '4'
+	0x27, 0x45, 0x45, 0x45, 0x39, // '5'
+	0x3c, 0x4a, 0x49, 0x49, 0x31, // '6'
+	0x41, 0x21, 0x11, 0x09, 0x07, // '7'
+	0x36, 0x49, 0x49, 0x49, 0x36, // '8'
+	0x46, 0x49, 0x49, 0x29, 0x1e, // '9'
+	0x00, 0x00, 0x14, 0x00, 0x00, // ':'
+	0x7f, 0x49, 0x49, 0x49, 0x36, // 'B'
+	0x7f, 0x41, 0x41, 0x41, 0x3e, // 'D'
+	0x7f, 0x49, 0x49, 0x49, 0x41, // 'E'
+	0x3e, 0x41, 0x41, 0x51, 0x73, // 'G'
+	0x7f, 0x08, 0x08, 0x08, 0x7f, // 'H'
+	0x7f, 0x40, 0x40, 0x40, 0x40, // 'L'
+	0x7f, 0x09, 0x19, 0x29, 0x46, // 'R'
+	0x26, 0x49, 0x49, 0x49, 0x32, // 'S'
+	0x1f, 0x20, 0x40, 0x20, 0x1f, // 'V'
+	0x48, 0x54, 0x54, 0x54, 0x24, // 's'
+};
+const SpriteFont SpriteFontSmall = {SpriteFontSmallChars, SpriteFontSmallGlyphs, 5, 1, 6};
+
+// LEDs count, text size 2, 10x16px per glyph
+const char SpriteFontLargeChars[] PROGMEM = " 0123456789:DELs";
+const uint8_t SpriteFontLargeGlyphs[] PROGMEM = {
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, // ' '
+	0xfc, 0xfc, 0x03, 0x03, 0xc3, 0xc3, 0x33, 0x33, 0xfc, 0xfc, 0x0f, 0x0f, 0x33, 0x33, 0x30, 0x30, 0x30, 0x30, 0x0f, 0x0f, // '0'
+	0x00, 0x00, 0x0c, 0x0c, 0xff, 0xff, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x30, 0x30, 0x3f, 0x3f, 0x30, 0x30, 0x00, 0x00, // '1'
+	0x0c, 0x0c, 0xc3, 0xc3, 0xc3, 0xc3, 0xc3, 0xc3, 0x3c, 0x3c, 0x3f, 0x3f, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, // '2'
+	0x03, 0x03, 0x03, 0x03, 0xc3, 0xc3, 0xf3, 0xf3, 0x0f, 0x0f, 0x0c, 0x0c, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x0f, 0x0f, // '3'
+	0xc0, 0xc0, 0x30, 0x30, 0x0c, 0x0c, 0xff, 0xff, 0x00, 0x00, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x3f, 0x3f, 0x03, 0x03, // '4'
+	0x3f, 0x3f, 0x33, 0x33, 0x33, 0x33, 0x33, 0x33, 0xc3, 0xc3, 0x0c, 0x0c, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x0f, 0x0f, // '5'
+	0xf0, 0xf0, 0xcc, 0xcc, 0xc3, 0xc3, 0xc3, 0xc3, 0x03, 0x03, 0x0f, 0x0f, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x0f, 0x0f, // '6'
+	0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0xc3, 0xc3, 0x3f, 0x3f, 0x30, 0x30, 0x0c, 0x0c, 0x03, 0x03, 0x00, 0x00, 0x00, 0x00, // '7'
+	0x3c, 0x3c, 0xc3, 0xc3, 0xc3, 0xc3, 0xc3, 0xc3, 0x3c, 0x3c, 0x0f, 0x0f, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x0f, 0x0f, // '8'
+	0x3c, 0x3c, 0xc3, 0xc3, 0xc3, 0xc3, 0xc3, 0xc3, 0xfc, 0xfc, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x0c, 0x0c, 0x03, 0x03, // '9'
+	0x00, 0x00, 0x00, 0x00, 0x30, 0x30, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x03, 0x03, 0x00, 0x00, 0x00, 0x00, // ':'
+	0xff, 0xff, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0xfc, 0xfc, 0x3f, 0x3f, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x0f, 0x0f, // 'D'
+	0xff, 0xff, 0xc3, 0xc3, 0xc3, 0xc3, 0xc3, 0xc3, 0x03, 0x03, 0x3f, 0x3f, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, // 'E'
+	0xff, 0xff, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x3f, 0x3f, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, // 'L'
+	0xc0, 0xc0, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x33, 0x33, 0x33, 0x33, 0x33, 0x33, 0x0c, 0x0c, // 's'
+};
+const SpriteFont SpriteFontLarge = {SpriteFontLargeChars, SpriteFontLargeGlyphs, 10, 2, 12};
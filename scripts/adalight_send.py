@@ -0,0 +1,124 @@
+# Copyright (C) 2022 Patrick Pedersen, TU-DO Makerspace
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+# Streams Adalight frames of various lengths to the tester (see the "stream"
+# serial command) and reports the sustained frame rate per length, along with
+# the frames that were lost (no ACK received). Each frame is a moving color
+# gradient, so dropped or torn frames are also visible on the strip.
+#
+# Works with any serial port that talks to the firmware, including the
+# pseudo terminal of a simulator. Requires pyserial.
+#
+# Usage:
+#   python3 scripts/adalight_send.py <port> [--lengths 1,60,300,1000] [--frames 200]
+#                                     [--depth 1] [--cmd-baud 9600] [--baud 500000]
+#
+# With --depth > 1, frames are sent ahead without waiting for the previous
+# ACK (this requires flow control, see ADALIGHT_CTS_PIN in config.h).
+
+import argparse
+import sys
+import time
+
+import serial
+
+ACK = b"\x06"  # ADALIGHT_ACK
+
+
+def header(n):
+    """Returns the Adalight header for a frame of n LEDs."""
+    hi = (n - 1) >> 8
+    lo = (n - 1) & 0xFF
+    return bytes([ord("A"), ord("d"), ord("a"), hi, lo, hi ^ lo ^ 0x55])
+
+
+def frame(n, i):
+    """Returns frame i of a moving gradient over n LEDs."""
+    px = bytearray(3 * n)
+    for led in range(n):
+        v = (led * 256 // n + i * 4) & 0xFF
+        px[3 * led:3 * led + 3] = bytes((v, 255 - v, (v * 2) & 0xFF))
+    return header(n) + bytes(px)
+
+
+def start_stream(port, cmd_baud, baud):
+    """Sends the "stream" command and returns the port at the streaming baud rate."""
+    ser = serial.Serial(port, cmd_baud, timeout=2)
+    ser.reset_input_buffer()
+    ser.write(b"stream\n")
+    reply = ser.readline().strip()
+    if reply != b"ok":
+        sys.exit("stream command failed: %r" % reply)
+
+    # Switch the open port, reopening it would discard the greeting
+    ser.baudrate = baud
+    ser.timeout = 1
+    hello = ser.read_until(b"Ada\n")
+    if not hello.endswith(b"Ada\n"):
+        sys.exit("no greeting received at %d baud" % baud)
+
+    return ser
+
+
+def measure(ser, n, n_frames, depth):
+    """Streams n_frames frames of n LEDs and returns (fps, lost frames)."""
+    frames = [frame(n, i) for i in range(16)]
+    in_flight = 0
+    lost = 0
+    sent = 0
+
+    start = time.monotonic()
+
+    while sent < n_frames or in_flight:
+        if sent < n_frames and in_flight < depth:
+            ser.write(frames[sent % len(frames)])
+            sent += 1
+            in_flight += 1
+            continue
+
+        if ser.read(1) == ACK:
+            in_flight -= 1
+        else:
+            # Timed out, the frame has been dropped
+            lost += in_flight
+            in_flight = 0
+
+    elapsed = time.monotonic() - start
+    return (n_frames - lost) / elapsed, lost
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Measures the Adalight streaming frame rate.")
+    parser.add_argument("port")
+    parser.add_argument("--lengths", default="1,60,300,1000",
+                        help="comma separated frame lengths in LEDs")
+    parser.add_argument("--frames", type=int, default=200, help="frames per length")
+    parser.add_argument("--depth", type=int, default=1, help="frames in flight")
+    parser.add_argument("--cmd-baud", type=int, default=9600, help="SERIAL_BAUD")
+    parser.add_argument("--baud", type=int, default=500000, help="ADALIGHT_BAUD")
+    args = parser.parse_args()
+
+    ser = start_stream(args.port, args.cmd_baud, args.baud)
+
+    print("%8s %10s %10s %8s" % ("LEDs", "fps", "us/frame", "lost"))
+    for n in (int(l) for l in args.lengths.split(",")):
+        fps, lost = measure(ser, n, args.frames, args.depth)
+        print("%8d %10.1f %10.0f %8d" % (n, fps, 1e6 / fps if fps else 0, lost))
+
+    ser.close()
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,155 @@
+# Copyright (C) 2022 Patrick Pedersen, TU-DO Makerspace
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+# Generates include/screensaver.h from the animation frames in
+# scripts/screensaver/ (binary PBM, 1 = lit). The first frame is stored
+# as the base image in SSD1306 page format, every further frame as an
+# XOR patch covering only the pages and columns in which it differs from
+# the base image. Frames can thus be switched by redrawing the patch's
+# rectangle alone (See Display::screensaver()), and each added frame only
+# costs flash for the pixels that actually change.
+#
+# Usage:
+#   python3 scripts/gen_screensaver.py
+
+import os
+
+SCREEN_W = 128
+SCREEN_H = 64
+Y = 20  # Top row of the frames on the screen, below the credits
+
+# (name, file, description), the first frame is the base image
+FRAMES = [
+    ("WaddleDeeOpen", "waddle_dee_open.pbm", "Waddle Dee with open eyes"),
+    ("WaddleDeeClosed", "waddle_dee_closed.pbm", "Waddle Dee with closed eyes"),
+]
+
+HEADER = """/*
+ * Copyright (C) 2022 Patrick Pedersen, TU-DO Makerspace
+
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * @file screensaver.h
+ * @author Patrick Pedersen, u/LordShrekM8
+ *
+ * @brief Contains the frames of the Waddle Dee screensaver.
+ *
+ * The following file contains the frames of the Waddle Dee screensaver,
+ * as a base image and XOR patches in SSD1306 page format. It has been
+ * generated by scripts/gen_screensaver.py, DO NOT EDIT!
+ * The frames are based on Reddit user /u/LordShrekM8's work which can be found
+ * here: https://www.reddit.com/r/Kirby/comments/u03hoj/work_in_progress_a_mini_waddle_dee_animation/
+ */
+
+#pragma once
+
+#include <Arduino.h>
+
+#include <PagedSSD1306.h>
+"""
+
+
+def read_pbm(path):
+    """Reads a binary PBM, and returns its rows as lists of 0/1."""
+    with open(path, "rb") as f:
+        data = f.read()
+
+    fields = data.split(None, 3)
+    assert fields[0] == b"P4"
+    w, h = int(fields[1]), int(fields[2])
+    raw = fields[3]
+    stride = (w + 7) // 8
+
+    return [[(raw[y * stride + x // 8] >> (7 - x % 8)) & 1 for x in range(w)] for y in range(h)]
+
+
+def to_pages(rows):
+    """Places the rows at Y, and returns the screen as pages of column bytes."""
+    pages = [[0] * SCREEN_W for _ in range(SCREEN_H // 8)]
+
+    for y, row in enumerate(rows):
+        sy = Y + y
+        if sy >= SCREEN_H:
+            break
+        for x, bit in enumerate(row[:SCREEN_W]):
+            if bit:
+                pages[sy // 8][x] |= 1 << (sy % 8)
+
+    return pages
+
+
+def bbox(pages):
+    """Returns (x, page, w, pages) of the non-zero bytes."""
+    cells = [(p, x) for p, page in enumerate(pages) for x, b in enumerate(page) if b]
+    assert cells, "frame doesn't differ from the base image"
+    p0 = min(p for p, _ in cells)
+    p1 = max(p for p, _ in cells) + 1
+    x0 = min(x for _, x in cells)
+    x1 = max(x for _, x in cells) + 1
+    return x0, p0, x1 - x0, p1 - p0
+
+
+def gen_sprite(name, desc, pages):
+    x, p, w, n = bbox(pages)
+    data = [b for page in pages[p:p + n] for b in page[x:x + w]]
+
+    out = ["// %s, %dx%dpx at column %d, page %d (%d bytes)" % (desc, w, 8 * n, x, p, len(data))]
+    out.append("const uint8_t %sData[] PROGMEM = {" % name)
+    for pos in range(0, len(data), 16):
+        out.append("\t" + " ".join("0x%02x," % b for b in data[pos:pos + 16]))
+    out.append("};")
+    out.append("const PageSprite %s = {%sData, %d, %d, %d, %d};" % (name, name, x, p, w, n))
+
+    return "\n".join(out)
+
+
+def main():
+    here = os.path.dirname(os.path.abspath(__file__))
+    path = os.path.join(here, "..", "include", "screensaver.h")
+    frames = [to_pages(read_pbm(os.path.join(here, "screensaver", f))) for _, f, _ in FRAMES]
+    base = frames[0]
+
+    with open(path, "w") as f:
+        f.write(HEADER)
+
+        name, _, desc = FRAMES[0]
+        f.write("\n// Base image\n" + gen_sprite(name, desc, base) + "\n")
+
+        for (name, _, desc), frame in zip(FRAMES[1:], frames[1:]):
+            patch = [[a ^ b for a, b in zip(fp, bp)] for fp, bp in zip(frame, base)]
+            f.write("\n// XOR patch\n" + gen_sprite(name, desc, patch) + "\n")
+
+        f.write("\n// Patches of the frames following the base image\n")
+        f.write("const PageSprite *const WaddleDeePatches[] = {%s};\n"
+                % ", ".join("&" + name for name, _, _ in FRAMES[1:]))
+        f.write("#define WADDLE_DEE_FRAMES %d /// Number of frames including the base image\n" % len(FRAMES))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,144 @@
+# Copyright (C) 2022 Patrick Pedersen, TU-DO Makerspace
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+# Generates include/sprites.h, which contains pre-scaled sprite fonts in
+# SSD1306 page format for PagedSSD1306::blit_char(). The glyphs are taken
+# from the classic 5x7 Adafruit_GFX font, so blitted text looks exactly like
+# text printed through Adafruit_GFX with the same text size.
+#
+# Usage:
+#   python3 scripts/gen_sprites.py
+
+import os
+
+# Classic 5x7 Adafruit_GFX glyphs (glcdfont.c), one byte per column, LSB on top
+GLYPHS = {
+    ' ': [0x00, 0x00, 0x00, 0x00, 0x00],
+    '0': [0x3E, 0x51, 0x49, 0x45, 0x3E],
+    '1': [0x00, 0x42, 0x7F, 0x40, 0x00],
+    '2': [0x72, 0x49, 0x49, 0x49, 0x46],
+    '3': [0x21, 0x41, 0x49, 0x4D, 0x33],
+    '4': [0x18, 0x14, 0x12, 0x7F, 0x10],
+    '5': [0x27, 0x45, 0x45, 0x45, 0x39],
+    '6': [0x3C, 0x4A, 0x49, 0x49, 0x31],
+    '7': [0x41, 0x21, 0x11, 0x09, 0x07],
+    '8': [0x36, 0x49, 0x49, 0x49, 0x36],
+    '9': [0x46, 0x49, 0x49, 0x29, 0x1E],
+    ':': [0x00, 0x00, 0x14, 0x00, 0x00],
+    'B': [0x7F, 0x49, 0x49, 0x49, 0x36],
+    'D': [0x7F, 0x41, 0x41, 0x41, 0x3E],
+    'E': [0x7F, 0x49, 0x49, 0x49, 0x41],
+    'G': [0x3E, 0x41, 0x41, 0x51, 0x73],
+    'H': [0x7F, 0x08, 0x08, 0x08, 0x7F],
+    'L': [0x7F, 0x40, 0x40, 0x40, 0x40],
+    'R': [0x7F, 0x09, 0x19, 0x29, 0x46],
+    'S': [0x26, 0x49, 0x49, 0x49, 0x32],
+    'V': [0x1F, 0x20, 0x40, 0x20, 0x1F],
+    's': [0x48, 0x54, 0x54, 0x54, 0x24],
+}
+
+# (name, scale, characters, description)
+FONTS = [
+    ("SpriteFontSmall", 1, " 0123456789:BDEGHLRSVs", "RGB/HSV information and long LEDs counts, text size 1"),
+    ("SpriteFontLarge", 2, " 0123456789:DELs", "LEDs count, text size 2"),
+]
+
+HEADER = """/*
+ * Copyright (C) 2022 Patrick Pedersen, TU-DO Makerspace
+
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ * 
+ */
+
+/**
+ * @file sprites.h
+ * @author Patrick Pedersen
+ * 
+ * @brief Contains the sprite fonts for PagedSSD1306::blit_char().
+ * 
+ * The following file contains pre-scaled sprite fonts in SSD1306 page
+ * format. It has been generated by scripts/gen_sprites.py, DO NOT EDIT!
+ */
+
+#pragma once
+
+#include <Arduino.h>
+
+#include <PagedSSD1306.h>
+"""
+
+
+def scale_glyph(cols, scale):
+    """Scales a glyph and returns its pages, each a list of column bytes."""
+    height = 8 * scale
+    pages = [[] for _ in range(scale)]
+
+    for col in cols:
+        # Scale the column vertically
+        bits = 0
+        for row in range(8):
+            if col & (1 << row):
+                for i in range(scale):
+                    bits |= 1 << (row * scale + i)
+
+        # Scale the column horizontally and split it into pages
+        for _ in range(scale):
+            for page in range(scale):
+                pages[page].append((bits >> (page * 8)) & 0xFF)
+
+    assert len(pages) * 8 == height
+    return pages
+
+
+def gen_font(name, scale, chars, desc):
+    width = 5 * scale
+    out = []
+
+    out.append("// %s, %dx%dpx per glyph" % (desc, width, 8 * scale))
+    out.append("const char %sChars[] PROGMEM = \"%s\";" % (name, chars))
+    out.append("const uint8_t %sGlyphs[] PROGMEM = {" % name)
+    for c in chars:
+        data = [b for page in scale_glyph(GLYPHS[c], scale) for b in page]
+        out.append("\t" + " ".join("0x%02x," % b for b in data) + " // '%s'" % c)
+    out.append("};")
+    out.append("const SpriteFont %s = {%sChars, %sGlyphs, %d, %d, %d};"
+               % (name, name, name, width, scale, 6 * scale))
+
+    return "\n".join(out)
+
+
+def main():
+    path = os.path.join(os.path.dirname(os.path.abspath(__file__)),
+                        "..", "include", "sprites.h")
+
+    with open(path, "w") as f:
+        f.write(HEADER)
+        for font in FONTS:
+            f.write("\n" + gen_font(*font) + "\n")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,157 @@
+# Copyright (C) 2022 Patrick Pedersen, TU-DO Makerspace
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+# Expands the binary log records of the firmware (see include/Log.h) to
+# text. The message formats are read from include/LogMessages.h, text
+# output of the serial commands is passed through as is. Commands typed
+# into stdin are sent to the tester when reading from a serial port.
+#
+# Works with any serial port that talks to the firmware, including the
+# pseudo terminal of a simulator. Requires pyserial for serial ports.
+#
+# Usage:
+#   python3 scripts/log_decode.py <port> [--baud 9600]
+#   python3 scripts/log_decode.py --file <capture.bin>
+
+import argparse
+import os
+import re
+import struct
+import sys
+import threading
+
+LOG_SYNC = 0xFF
+
+# printf length modifier -> struct format (little endian, as on the AVR)
+SIZES = {
+    ("hh", "d"): "<b", ("hh", "u"): "<B", ("hh", "x"): "<B", ("hh", "c"): "<B",
+    ("", "d"): "<h", ("", "u"): "<H", ("", "x"): "<H", ("", "c"): "<B",
+    ("h", "d"): "<h", ("h", "u"): "<H", ("h", "x"): "<H",
+    ("l", "d"): "<i", ("l", "u"): "<I", ("l", "x"): "<I",
+}
+
+SPEC = re.compile(r"%([-+ 0#]*\d*)(hh|h|l)?([duxc%])")
+
+
+def load_messages():
+    """Returns the (name, format) pairs of LogMessages.h, in order of their IDs."""
+    path = os.path.join(os.path.dirname(os.path.abspath(__file__)),
+                        "..", "include", "LogMessages.h")
+    with open(path) as f:
+        src = f.read()
+
+    return re.findall(r'X\((\w+),\s*"((?:[^"\\]|\\.)*)"\)', src)
+
+
+def expand(fmt, payload):
+    """Expands a format with its binary arguments, or returns None if they don't match."""
+    values = []
+    pos = 0
+
+    for flags, length, conv in SPEC.findall(fmt):
+        if conv == "%":
+            continue
+        code = SIZES.get((length or "", conv))
+        if code is None:
+            return None
+        size = struct.calcsize(code)
+        if pos + size > len(payload):
+            return None
+        values.append(struct.unpack_from(code, payload, pos)[0])
+        pos += size
+
+    if pos != len(payload):
+        return None
+
+    return SPEC.sub(lambda m: "%" + m.group(1) + m.group(3), fmt) % tuple(values)
+
+
+class Decoder:
+    """Splits a byte stream into text and log records."""
+
+    def __init__(self, messages, out):
+        self.messages = messages
+        self.out = out
+        self.buf = bytearray()
+
+    def feed(self, data):
+        self.buf += data
+
+        while self.buf:
+            if self.buf[0] != LOG_SYNC:
+                end = self.buf.find(LOG_SYNC)
+                end = len(self.buf) if end < 0 else end
+                self.out.write(self.buf[:end].decode("ascii", "replace"))
+                del self.buf[:end]
+                continue
+
+            if len(self.buf) < 3 or len(self.buf) < 3 + self.buf[2]:
+                break  # Incomplete record
+
+            msg_id, n = self.buf[1], self.buf[2]
+            payload = bytes(self.buf[3:3 + n])
+            del self.buf[:3 + n]
+            self.out.write(self.record(msg_id, payload) + "\n")
+
+        self.out.flush()
+
+    def record(self, msg_id, payload):
+        if msg_id >= len(self.messages):
+            return "[log] unknown message %d: %s" % (msg_id, payload.hex())
+
+        name, fmt = self.messages[msg_id]
+        text = expand(fmt, payload)
+        if text is None:
+            return "[log] %s: bad arguments %s" % (name, payload.hex())
+
+        return "[log] " + text
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Decodes the tester's binary log.")
+    parser.add_argument("port", nargs="?")
+    parser.add_argument("--baud", type=int, default=9600, help="SERIAL_BAUD")
+    parser.add_argument("--file", help="decode a capture instead of a serial port")
+    args = parser.parse_args()
+
+    dec = Decoder(load_messages(), sys.stdout)
+
+    if args.file:
+        with open(args.file, "rb") as f:
+            dec.feed(f.read())
+        return
+
+    if not args.port:
+        parser.error("a port or --file is required")
+
+    import serial
+
+    ser = serial.Serial(args.port, args.baud, timeout=0.1)
+
+    def forward_commands():
+        for line in sys.stdin:
+            ser.write(line.encode("ascii"))
+
+    threading.Thread(target=forward_commands, daemon=True).start()
+
+    try:
+        while True:
+            dec.feed(ser.read(256))
+    except KeyboardInterrupt:
+        pass
+
+
+if __name__ == "__main__":
+    main()
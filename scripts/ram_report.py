@@ -0,0 +1,114 @@
+# Copyright (C) 2022 Patrick Pedersen, TU-DO Makerspace
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+# PlatformIO extra script which reports the static RAM usage (.data and .bss)
+# per module as well as the remaining stack headroom and the flash usage,
+# and fails the build if the headroom drops below the configured reserve.
+# Every build profile (environment) is reported separately.
+#
+# Usage:
+#   pio run -t ramreport
+#   pio run -e low_ram -t ramreport
+#
+# Options (platformio.ini):
+#   custom_ram_stack_reserve   Min. bytes that must remain for the stack (and heap)
+
+import os
+import subprocess
+
+Import("env")
+
+DEFAULT_STACK_RESERVE = 512
+
+
+def section_sizes(size_tool, path):
+    """Returns a list of (module, data, bss, text) tuples for an object file or ELF."""
+    out = subprocess.check_output([size_tool, "-A", path], universal_newlines=True)
+    modules = []
+    module = None
+    data = bss = text = 0
+
+    for line in out.splitlines():
+        fields = line.split()
+
+        if " :" in line or line.endswith(":"):
+            if module is not None:
+                modules.append((module, data, bss, text))
+            module = os.path.basename(line.split(" ")[0].rstrip(":"))
+            data = bss = text = 0
+        elif len(fields) >= 2 and fields[1].isdigit():
+            if fields[0].startswith(".data"):
+                data += int(fields[1])
+            elif fields[0].startswith(".bss") or fields[0].startswith(".noinit"):
+                bss += int(fields[1])
+            elif fields[0].startswith(".text"):
+                text += int(fields[1])
+
+    if module is not None:
+        modules.append((module, data, bss, text))
+
+    return modules
+
+
+def ram_report(target, source, env):
+    size_tool = env.subst("$SIZETOOL")
+    build_dir = env.subst("$BUILD_DIR")
+    elf = env.subst(os.path.join("$BUILD_DIR", "${PROGNAME}.elf"))
+    ram_size = int(env.BoardConfig().get("upload.maximum_ram_size"))
+    reserve = int(env.GetProjectOption("custom_ram_stack_reserve", DEFAULT_STACK_RESERVE))
+
+    # Per module usage, taken from the objects before linking.
+    # Unused sections may still be dropped by the linker (--gc-sections),
+    # so these figures are upper bounds.
+    modules = []
+    for root, _, files in os.walk(build_dir):
+        for f in files:
+            if f.endswith(".o"):
+                modules += section_sizes(size_tool, os.path.join(root, f))
+
+    print("Build profile: %s" % env.subst("$PIOENV"))
+    print("")
+    print("%-32s %8s %8s" % ("Module", ".data", ".bss"))
+    for module, data, bss, _ in sorted(modules, key=lambda m: m[1] + m[2], reverse=True):
+        if data or bss:
+            print("%-32s %8d %8d" % (module, data, bss))
+
+    # Total usage, taken from the linked firmware
+    total = section_sizes(size_tool, elf)[0]
+    data, bss, text = total[1], total[2], total[3]
+    headroom = ram_size - data - bss
+    flash_size = int(env.BoardConfig().get("upload.maximum_size"))
+
+    print("")
+    print("Total .data:     %5d bytes" % data)
+    print("Total .bss:      %5d bytes" % bss)
+    print("Stack headroom:  %5d bytes (reserve: %d bytes, RAM: %d bytes)" % (headroom, reserve, ram_size))
+    print("Flash:           %5d bytes (.text + .data, flash: %d bytes)" % (text + data, flash_size))
+
+    if headroom < reserve:
+        print("Error: RAM budget exceeded by %d bytes" % (reserve - headroom))
+        env.Exit(1)
+
+
+env.AddCustomTarget(
+    name="ramreport",
+    dependencies=os.path.join("$BUILD_DIR", "${PROGNAME}.elf"),
+    actions=[ram_report],
+    title="RAM Report",
+    description="Report static RAM usage per module and check the stack headroom",
+)
+
+# Also enforce the budget on regular builds
+env.AddPostAction(os.path.join("$BUILD_DIR", "${PROGNAME}.elf"), ram_report)
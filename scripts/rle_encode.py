@@ -0,0 +1,242 @@
+# Copyright (C) 2022 Patrick Pedersen, TU-DO Makerspace
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+# Encodes frames in the RLE frame format of the firmware (see include/Rle.h).
+#
+# Usage:
+#   python3 scripts/rle_encode.py gen
+#       Generates include/patterns.h from the PATTERNS below.
+#   python3 scripts/rle_encode.py encode <in.rgb> <out.rle>
+#       Encodes a raw frame (3 bytes per pixel, r, g, b).
+#   python3 scripts/rle_encode.py send <port> <in.rgb> [--baud 9600]
+#       Encodes a raw frame and shows it on the tester (see the "rle"
+#       serial command). Requires pyserial.
+
+import argparse
+import colorsys
+import os
+import sys
+
+RLE_LITERAL = 0x80
+RLE_COUNT_MASK = 0x7F
+RLE_MAX_COUNT = 0xFFFF
+RLE_BUF_SIZE = 128  # RLE_BUF_SIZE in config.h (32 in the low RAM profile)
+
+END = bytes((0x00, 0x00, 0x00))
+
+
+def tag(count, literal):
+    """Returns the tag of a record of count pixels."""
+    flag = RLE_LITERAL if literal else 0
+    if count <= RLE_COUNT_MASK:
+        return bytes((flag | count,))
+    return bytes((flag, count & 0xFF, count >> 8))
+
+
+def encode(pixels):
+    """Encodes a list of (r, g, b) tuples, and returns the encoded frame.
+
+    Repeated pixels become runs, all other pixels are collected into
+    literals. A run of 2 takes 4 bytes, while the same 2 pixels add 6
+    bytes to a literal (7 if they open one). Even if the run splits a
+    literal and a new tag is needed after it, it never costs more than
+    keeping the pixels in the literal, so runs start at 2 pixels.
+    """
+    out = bytearray()
+    literal = []
+
+    def flush_literal():
+        while literal:
+            chunk = literal[:RLE_MAX_COUNT]
+            del literal[:RLE_MAX_COUNT]
+            out.extend(tag(len(chunk), True))
+            for px in chunk:
+                out.extend(px)
+
+    i = 0
+    while i < len(pixels):
+        j = i + 1
+        while j < len(pixels) and pixels[j] == pixels[i] and j - i < RLE_MAX_COUNT:
+            j += 1
+
+        if j - i >= 2:
+            flush_literal()
+            out.extend(tag(j - i, False))
+            out.extend(pixels[i])
+        else:
+            literal.append(pixels[i])
+        i = j
+
+    flush_literal()
+    out.extend(END)
+    return bytes(out)
+
+
+def decode(data):
+    """Decodes an encoded frame, and returns its pixels (for verification)."""
+    pixels = []
+    pos = 0
+
+    while True:
+        t = data[pos]
+        count = t & RLE_COUNT_MASK
+        pos += 1
+        if count == 0:
+            count = data[pos] | data[pos + 1] << 8
+            pos += 2
+            if count == 0:
+                return pixels
+
+        if t & RLE_LITERAL:
+            for _ in range(count):
+                pixels.append(tuple(data[pos:pos + 3]))
+                pos += 3
+        else:
+            pixels += [tuple(data[pos:pos + 3])] * count
+            pos += 3
+
+
+def gradient(n):
+    """Returns a rainbow across n pixels."""
+    px = []
+    for i in range(n):
+        r, g, b = colorsys.hsv_to_rgb(i / n, 1, 1)
+        px.append((int(r * 255), int(g * 255), int(b * 255)))
+    return px
+
+
+# (name, pixels)
+PATTERNS = [
+    ("Colors", [(255, 0, 0)] * 10 + [(0, 255, 0)] * 10 + [(0, 0, 255)] * 10 + [(255, 255, 255)] * 10),
+    ("Every 10th", ([(0, 0, 0)] * 9 + [(255, 255, 255)]) * 30),
+    ("Rainbow", gradient(32)),
+    ("Halves", [(255, 0, 0)] * 500 + [(0, 0, 255)] * 500),
+]
+
+HEADER = """/*
+ * Copyright (C) 2022 Patrick Pedersen, TU-DO Makerspace
+
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * @file patterns.h
+ * @author Patrick Pedersen
+ *
+ * @brief Contains the stored RLE frames of the "pattern" command.
+ *
+ * The following file contains run-length encoded frames (See Rle.h).
+ * It has been generated by scripts/rle_encode.py, DO NOT EDIT!
+ */
+
+#pragma once
+
+#include <Arduino.h>
+
+#include <Rle.h>
+"""
+
+
+def gen_pattern(i, name, pixels):
+    data = encode(pixels)
+    assert decode(data) == pixels
+
+    out = ["// %s, %d LEDs, %d bytes" % (name, len(pixels), len(data))]
+    out.append("const uint8_t RlePattern%d[] PROGMEM = {" % i)
+    for pos in range(0, len(data), 12):
+        out.append("\t" + " ".join("0x%02x," % b for b in data[pos:pos + 12]))
+    out.append("};")
+    return "\n".join(out)
+
+
+def gen():
+    path = os.path.join(os.path.dirname(os.path.abspath(__file__)),
+                        "..", "include", "patterns.h")
+
+    with open(path, "w") as f:
+        f.write(HEADER)
+        for i, (name, pixels) in enumerate(PATTERNS):
+            f.write("\n" + gen_pattern(i, name, pixels) + "\n")
+
+        f.write("\nconst RlePattern rle_patterns[] PROGMEM = {\n")
+        for i in range(len(PATTERNS)):
+            f.write("\t{RlePattern%d, sizeof(RlePattern%d)},\n" % (i, i))
+        f.write("};\n")
+
+
+def read_rgb(path):
+    with open(path, "rb") as f:
+        raw = f.read()
+    if len(raw) % 3:
+        sys.exit("%s: size is not a multiple of 3 bytes" % path)
+    return [tuple(raw[i:i + 3]) for i in range(0, len(raw), 3)]
+
+
+def send(port, data, baud):
+    import serial
+
+    if len(data) > RLE_BUF_SIZE:
+        sys.exit("encoded frame is %d bytes, the tester accepts up to %d" % (len(data), RLE_BUF_SIZE))
+
+    with serial.Serial(port, baud, timeout=2) as ser:
+        ser.reset_input_buffer()
+        ser.write(b"rle %d\n" % len(data) + data)
+        reply = ser.readline().strip()
+        if reply != b"ok":
+            sys.exit("rle command failed: %r" % reply)
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Encodes RLE frames for the tester.")
+    sub = parser.add_subparsers(dest="cmd", required=True)
+    sub.add_parser("gen", help="generate include/patterns.h")
+    p = sub.add_parser("encode", help="encode a raw frame")
+    p.add_argument("input")
+    p.add_argument("output")
+    p = sub.add_parser("send", help="encode a raw frame and show it on the tester")
+    p.add_argument("port")
+    p.add_argument("input")
+    p.add_argument("--baud", type=int, default=9600, help="SERIAL_BAUD")
+    args = parser.parse_args()
+
+    if args.cmd == "gen":
+        gen()
+        return
+
+    pixels = read_rgb(args.input)
+    data = encode(pixels)
+    print("%d LEDs, %d -> %d bytes" % (len(pixels), 3 * len(pixels), len(data)))
+
+    if args.cmd == "encode":
+        with open(args.output, "wb") as f:
+            f.write(data)
+    else:
+        send(args.port, data, args.baud)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,196 @@
+/*
+ * Copyright (C) 2022 Patrick Pedersen, TU-DO Makerspace
+
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * @file Adalight.cpp
+ * @author Patrick Pedersen
+ *
+ * @brief Defines functions for the Adalight class.
+ *
+ * The following file defines functions for the Adalight class.
+ * See Adalight.h for more information.
+ *
+ */
+
+#include <Adalight.h>
+
+#define TIMER1_US_PER_TICK 16 // See FrameMeter::begin()
+
+/**
+ * @brief Sends a byte without going through Serial.
+ *
+ * @param c The byte to send.
+ *
+ */
+static void send(uint8_t c)
+{
+	while (!(UCSR0A & _BV(UDRE0)));
+	UDR0 = c;
+}
+
+// See header file for documentation.
+void Adalight::begin()
+{
+	static const char hello[] PROGMEM = "Ada\n";
+
+	Serial.end();
+
+	UBRR0 = F_CPU / 8 / ADALIGHT_BAUD - 1;
+	UCSR0A = _BV(U2X0);
+	UCSR0C = _BV(UCSZ01) | _BV(UCSZ00); // 8N1
+	UCSR0B = _BV(RXEN0) | _BV(TXEN0);   // No interrupts, the USART is polled
+
+#ifdef ADALIGHT_CTS_PIN
+	pinMode(ADALIGHT_CTS_PIN, OUTPUT);
+	cts_reg = portOutputRegister(digitalPinToPort(ADALIGHT_CTS_PIN));
+	cts_mask = digitalPinToBitMask(ADALIGHT_CTS_PIN);
+	*cts_reg &= ~cts_mask;
+#endif
+
+	head = tail = 0;
+	hdr_idx = 0;
+	frame_n = 0;
+	n_frames = n_underruns = n_overruns = n_bad_headers = 0;
+	last_rx_tstamp = millis();
+
+	for (const char *c = hello; pgm_read_byte(c); c++)
+		send(pgm_read_byte(c));
+}
+
+// See header file for documentation.
+void Adalight::end()
+{
+	while (!(UCSR0A & _BV(UDRE0)));
+	UCSR0B = 0;
+
+#ifdef ADALIGHT_CTS_PIN
+	*cts_reg |= cts_mask;
+#endif
+
+	Serial.begin(SERIAL_BAUD);
+}
+
+// See header file for documentation.
+bool Adalight::wait(uint8_t n, uint16_t timeout_us)
+{
+	uint16_t start = TCNT1;
+
+	for (;;) {
+		poll();
+		if (available() >= n)
+			return true;
+
+		if ((uint16_t)(TCNT1 - start) >= timeout_us / TIMER1_US_PER_TICK)
+			return false;
+	}
+}
+
+// See header file for documentation.
+bool Adalight::stream(Strip &strip)
+{
+	uint8_t prefill = frame_n < ADALIGHT_PREFILL ? frame_n : ADALIGHT_PREFILL;
+
+	// The reset time may have been calibrated well below its default (see ResetCal.h)
+	uint16_t reset_time = strip.get_reset_time();
+	pixel_timeout_us = reset_time > ADALIGHT_RESET_MARGIN_US ? reset_time - ADALIGHT_RESET_MARGIN_US : 0;
+
+	if (!wait(prefill * 3, ADALIGHT_PREFILL_WAIT_US)) {
+		n_underruns++;
+		return false;
+	}
+
+	// Keep receiving while the previous frame latches
+	while (!strip.latched())
+		poll();
+
+	if (!strip.stream_frame(frame_n, *this)) {
+		n_underruns++;
+		return false;
+	}
+
+	send(ADALIGHT_ACK);
+	n_frames++;
+
+	return true;
+}
+
+// See header file for documentation.
+bool Adalight::update(Strip &strip)
+{
+	static const char magic[] PROGMEM = "Ada";
+
+	poll();
+
+	while (available()) {
+		uint8_t c = pop();
+		last_rx_tstamp = millis();
+
+		// Magic word
+		if (hdr_idx < 3) {
+			if (c == pgm_read_byte(magic + hdr_idx))
+				hdr_idx++;
+			else
+				hdr_idx = (c == 'A');
+			continue;
+		}
+
+		// LED count and checksum
+		hdr[hdr_idx - 3] = c;
+		if (++hdr_idx < 6)
+			continue;
+
+		hdr_idx = 0;
+
+		if ((hdr[0] ^ hdr[1] ^ 0x55) != hdr[2]) {
+			n_bad_headers++;
+			continue;
+		}
+
+		// The header holds the LED count minus one, so 0xFFFF announces 65536 LEDs
+		frame_n = ((unsigned long)hdr[0] << 8 | hdr[1]) + 1;
+		return stream(strip);
+	}
+
+	return false;
+}
+
+// See header file for documentation.
+bool Adalight::quiet(unsigned long ms)
+{
+	return millis() - last_rx_tstamp >= ms;
+}
+
+// See header file for documentation.
+unsigned long Adalight::frame_len()
+{
+	return frame_n;
+}
+
+// See header file for documentation.
+void Adalight::print_stats()
+{
+	Serial.print(F("Stream: "));
+	Serial.print(n_frames);
+	Serial.print(F(" frames, "));
+	Serial.print(n_underruns);
+	Serial.print(F(" underruns, "));
+	Serial.print(n_overruns);
+	Serial.print(F(" overruns, "));
+	Serial.print(n_bad_headers);
+	Serial.println(F(" bad headers"));
+}
@@ -0,0 +1,93 @@
+/*
+ * Copyright (C) 2022 Patrick Pedersen, TU-DO Makerspace
+
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * @file Bisect.cpp
+ * @author Patrick Pedersen
+ *
+ * @brief Contains function definitions for the Bisect class.
+ *
+ * The following file contains the function definitions for the Bisect class.
+ * See the Bisect.h file for more information.
+ *
+ */
+
+#include <Bisect.h>
+
+// See header file for documentation.
+void Bisect::start(unsigned long n)
+{
+	lo = 0;
+	hi = n;
+	n_steps = 0;
+}
+
+// See header file for documentation.
+bool Bisect::done()
+{
+	return hi - lo <= 1;
+}
+
+// See header file for documentation.
+unsigned long Bisect::probe_first()
+{
+	return lo;
+}
+
+// See header file for documentation.
+unsigned long Bisect::probe_len()
+{
+	if (done())
+		return hi - lo;
+
+	return (hi - lo) / 2;
+}
+
+// See header file for documentation.
+void Bisect::answer(bool lit)
+{
+	if (done())
+		return;
+
+	unsigned long mid = lo + probe_len();
+
+	if (lit)
+		lo = mid;
+	else
+		hi = mid;
+
+	n_steps++;
+}
+
+// See header file for documentation.
+unsigned long Bisect::lower()
+{
+	return lo;
+}
+
+// See header file for documentation.
+unsigned long Bisect::upper()
+{
+	return hi;
+}
+
+// See header file for documentation.
+uint8_t Bisect::steps()
+{
+	return n_steps;
+}
@@ -30,6 +30,28 @@
 #include <config.h>
 #include <ColorPots.h>
 
+/**
+ * @brief Clamps a pot value to its bounds.
+ * 
+ * The following function snaps pot values above POT_UPPER_BOUND to
+ * the max. value, and values below POT_LOWER_BOUND to 0 (see config.h),
+ * as the pots don't reliably reach their end positions.
+ * 
+ * @param val The 10-bit pot value.
+ * @return uint16_t The clamped pot value (0-1023).
+ * 
+ */
+uint16_t bound_pot(uint16_t val)
+{
+	if (val >= POT_UPPER_BOUND)
+		return 1023;
+
+	if (val <= POT_LOWER_BOUND)
+		return 0;
+
+	return val;
+}
+
 /**
  * @brief Reads the average value (of n samples) for a potentiometer.
  * 
@@ -38,58 +60,142 @@
  * 
  * @param pin The pin of the potentiometer to read from.
  * @param n_avg The number of samples to average over.
- * @return uint8_t The average value of the potentiometer (0-255).
+ * @return uint16_t The average value of the potentiometer (0-1023).
  * 
  */
-uint8_t avg_read_pot(uint8_t pin, uint16_t n_avg)
+uint16_t avg_read_pot(uint8_t pin, uint16_t n_avg)
 {
-	float sum = 0;
+	uint32_t sum = 0;
 
 	for (unsigned int i = 0; i < n_avg; i++)
-		sum += analogRead(pin) >> SHFT_ADC_TO_UINT8;
-	
-	uint8_t ret = (uint8_t)round(sum / n_avg);
-	if (ret >= POT_UPPER_BOUND)
-		return 255;
-	
-	if (ret <= POT_LOWER_BOUND)
-		return 0;
+		sum += analogRead(pin);
+
+	return bound_pot((sum + n_avg / 2) / n_avg);
+}
+
+// The ADC interrupt's state, there is only a single set of pots
+static uint8_t pot_mux[3];            // ADC channels of the pots
+static uint8_t pot_ch;                // Pot currently being sampled
+static uint16_t pot_n;                // Samples taken of the current pot
+static uint32_t pot_sum;              // Sum of the samples taken of the current pot
+static volatile uint32_t pot_sums[3]; // Sums of the last AVG_ADC_SAMPLES samples of each pot
+static EventQueue *pot_events;
+
+/**
+ * @brief Returns the average pot value of a sum of samples.
+ * 
+ * The division is left to the main loop, to keep the ADC interrupt short.
+ * 
+ * @param sum The sum of AVG_ADC_SAMPLES samples.
+ * @return uint16_t The clamped average (0-1023).
+ * 
+ */
+uint16_t avg_pot(uint32_t sum)
+{
+	return bound_pot((sum + AVG_ADC_SAMPLES / 2) / AVG_ADC_SAMPLES);
+}
 
-	return ret;
+/**
+ * @brief Starts an ADC conversion of the current pot.
+ */
+static inline void start_pot_conversion()
+{
+	ADMUX = _BV(REFS0) | pot_mux[pot_ch];
+	ADCSRA |= _BV(ADSC);
+}
+
+/**
+ * @brief ADC interrupt handler.
+ * 
+ * The following interrupt handler accumulates the samples of the current
+ * pot, and once AVG_ADC_SAMPLES samples have been taken, publishes their
+ * sum, posts an EVENT_POT and moves on to the next pot.
+ * 
+ */
+ISR(ADC_vect)
+{
+	pot_sum += ADC;
+
+	if (++pot_n >= AVG_ADC_SAMPLES) {
+		pot_sums[pot_ch] = pot_sum;
+		pot_events->push(EVENT_POT, pot_ch);
+
+		pot_sum = 0;
+		pot_n = 0;
+		pot_ch = (pot_ch + 1) % 3;
+	}
+
+	start_pot_conversion();
 }
 
 // See header file for documentation.
 ColorPots::ColorPots(uint8_t pin_r, uint8_t pin_g, uint8_t pin_b)
 : pin_r(pin_r), pin_g(pin_g), pin_b(pin_b)
+{
+}
+
+// See header file for documentation.
+void ColorPots::begin(EventQueue &events)
 {
 	pinMode(pin_r, INPUT);
 	pinMode(pin_g, INPUT);
 	pinMode(pin_b, INPUT);
-	update();
+
+	// Only take a quick read here so the first frame isn't held up
+	// by the full average, the background sampling refines the values.
+	read(AVG_ADC_SAMPLES_BOOT);
 	last_change_tstamp = millis();
+
+	// Start sampling in the background, seeded with the quick read
+	pot_mux[0] = pin_r - A0;
+	pot_mux[1] = pin_g - A0;
+	pot_mux[2] = pin_b - A0;
+	pot_sums[0] = (uint32_t) r * AVG_ADC_SAMPLES;
+	pot_sums[1] = (uint32_t) g * AVG_ADC_SAMPLES;
+	pot_sums[2] = (uint32_t) b * AVG_ADC_SAMPLES;
+	pot_events = &events;
+
+	ADCSRA |= _BV(ADIF) | _BV(ADIE); // Discard any stale conversion result
+	start_pot_conversion();
 }
 
 // See header file for documentation.
-bool ColorPots::update()
+bool ColorPots::apply(uint16_t _r, uint16_t _g, uint16_t _b)
 {
-	bool ret = false;
-
-	uint8_t _r, _g, _b;
-	_r = avg_read_pot(pin_r, AVG_ADC_SAMPLES);
-	_g = avg_read_pot(pin_g, AVG_ADC_SAMPLES);
-	_b = avg_read_pot(pin_b, AVG_ADC_SAMPLES);
-
 	// Check if any of the values have changed.
-	if (_r != r || _g != g || _b != b) {
-		last_change_tstamp = millis();
-		ret = true;
-	}
+	if (abs((int16_t)(_r - r)) < POT_HYSTERESIS &&
+	    abs((int16_t)(_g - g)) < POT_HYSTERESIS &&
+	    abs((int16_t)(_b - b)) < POT_HYSTERESIS)
+		return false;
 
 	r = _r;
 	g = _g;
 	b = _b;
+	last_change_tstamp = millis();
 
-	return ret;
+	return true;
+}
+
+// See header file for documentation.
+bool ColorPots::read(uint16_t n_avg)
+{
+	return apply(avg_read_pot(pin_r, n_avg),
+		     avg_read_pot(pin_g, n_avg),
+		     avg_read_pot(pin_b, n_avg));
+}
+
+// See header file for documentation.
+bool ColorPots::update()
+{
+	uint32_t sums[3];
+
+	uint8_t sreg = SREG;
+	cli();
+	for (uint8_t i = 0; i < 3; i++)
+		sums[i] = pot_sums[i];
+	SREG = sreg;
+
+	return apply(avg_pot(sums[0]), avg_pot(sums[1]), avg_pot(sums[2]));
 }
 
 // See header file for documentation.
@@ -98,8 +204,22 @@ bool ColorPots::zeroed()
 	return !(r | g | b);
 }
 
+// See header file for documentation.
+bool ColorPots::maxed()
+{
+	return (r & g & b) == 1023;
+}
+
 // See header file for documentation.
 void ColorPots::get_rgb(uint8_t &r, uint8_t &g, uint8_t &b)
+{
+	r = this->r >> SHFT_ADC_TO_UINT8;
+	g = this->g >> SHFT_ADC_TO_UINT8;
+	b = this->b >> SHFT_ADC_TO_UINT8;
+}
+
+// See header file for documentation.
+void ColorPots::get_rgb10(uint16_t &r, uint16_t &g, uint16_t &b)
 {
 	r = this->r;
 	g = this->g;
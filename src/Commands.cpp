@@ -0,0 +1,488 @@
+/*
+ * Copyright (C) 2022 Patrick Pedersen, TU-DO Makerspace
+
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * @file Commands.cpp
+ * @author Patrick Pedersen
+ *
+ * @brief Operating modes and serial commands of the tester.
+ *
+ * The following file implements the operating modes and serial commands.
+ * See Commands.h for more information.
+ *
+ */
+
+#include <Arduino.h>
+
+#include <config.h>
+#include <Commands.h>
+#include <Hsv.h>
+#include <patterns.h>
+
+Mode mode = MODE_SIZE;
+unsigned long win_len = 0;
+
+uint8_t rle_buf[RLE_BUF_SIZE]; // RLE frame uploaded over serial (see "rle" command)
+RlePattern rle_shown = {nullptr, 0};
+bool rle_progmem = false;
+unsigned long rle_leds = 0;
+bool force_update = false;
+bool stress = false;
+bool dither = true; // Dither fractional colors if the frame rate allows it (see "dither" command)
+
+ColorInput color_input = COLOR_RGB;
+bool streaming = false;
+bool stream_pending = false;
+
+const char cmd_leds_name[] PROGMEM = "leds";
+const char cmd_lat_name[] PROGMEM = "lat";
+const char cmd_win_name[] PROGMEM = "win";
+const char cmd_bisect_name[] PROGMEM = "bisect";
+const char cmd_stress_name[] PROGMEM = "stress";
+const char cmd_rstcal_name[] PROGMEM = "rstcal";
+const char cmd_dither_name[] PROGMEM = "dither";
+const char cmd_color_name[] PROGMEM = "color";
+const char cmd_pattern_name[] PROGMEM = "pattern";
+const char cmd_rle_name[] PROGMEM = "rle";
+const char cmd_stream_name[] PROGMEM = "stream";
+
+// See header file for documentation.
+void apply_color()
+{
+	uint16_t r10, g10, b10;
+	color_pots.get_rgb10(r10, g10, b10);
+
+	// Dither the new color until the frame rate has been measured (see dithered() in main.cpp)
+	strip.set_dithering(dither);
+
+	display.set_rgb(r10 >> 2, g10 >> 2, b10 >> 2);
+	display.show_hsv(color_input != COLOR_RGB);
+
+	if (color_input == COLOR_RGB) {
+		strip.set_rgb10(r10, g10, b10);
+		return;
+	}
+
+	uint16_t h = r10 + (r10 >> 1); // 0-1023 to 0-1534 (HSV_HUE_MAX)
+	uint8_t s = g10 >> 2;
+	uint8_t v = b10 >> 2;
+
+	display.set_hsv((uint32_t) h * 360 / HSV_HUE_MAX, s, v);
+
+	if (color_input == COLOR_RAINBOW) {
+		strip.set_rainbow(h >> RAINBOW_STEP_SHFT, s, v);
+		return;
+	}
+
+	uint8_t r, g, b;
+	hsv_to_rgb(h, s, v, r, g, b);
+	strip.set_rgb(r, g, b);
+}
+
+// See header file for documentation.
+void set_mode(Mode m)
+{
+	if (mode == MODE_RESET_CAL && m != MODE_RESET_CAL && reset_cal.active()) {
+		reset_cal.cancel();
+		strip.set_reset_time(ResetCal::load(STRIP_PROFILE_ID));
+	}
+
+	mode = m;
+	force_update = true;
+}
+
+// See header file for documentation.
+bool cmd_lat(char * /* args */)
+{
+	Serial.print(F("Input-to-light latency: "));
+	Serial.print(strip.input_latency());
+	Serial.println(F(" us"));
+	return true;
+}
+
+// See header file for documentation.
+bool parse_leds(char *&args, unsigned long &n)
+{
+	char *end;
+	n = strtoul(args, &end, 10);
+	if (end == args || n > SIZE_ENC_MAX_POS)
+		return false;
+
+	args = end;
+	return true;
+}
+
+// See header file for documentation.
+bool cmd_leds(char *args)
+{
+	if (*args == '\0') {
+		Serial.println(strip.get_n_leds());
+		return true;
+	}
+
+	unsigned long n;
+	if (mode == MODE_BISECT || mode == MODE_RESET_CAL || !parse_leds(args, n))
+		return false;
+
+	size_enc.set_pos(n);
+	set_mode(MODE_SIZE);
+	return true;
+}
+
+// See header file for documentation.
+bool cmd_win(char *args)
+{
+	if (strcmp_P(args, PSTR("off")) == 0) {
+		if (mode == MODE_WINDOW) {
+			size_enc.set_pos(strip.get_first_led() + win_len);
+			set_mode(MODE_SIZE);
+		}
+		return true;
+	}
+
+	unsigned long first, n;
+	if (!parse_leds(args, first) || !parse_leds(args, n))
+		return false;
+
+	win_len = n;
+	size_enc.set_pos(first);
+	set_mode(MODE_WINDOW);
+	return true;
+}
+
+// See header file for documentation.
+bool cmd_bisect(char *args)
+{
+	if (strcmp_P(args, PSTR("off")) == 0) {
+		if (mode == MODE_BISECT) {
+			size_enc.set_pos(bisect.lower() + 1);
+			set_mode(MODE_SIZE);
+		}
+		return true;
+	}
+
+	unsigned long n = strip.get_first_led() + strip.get_n_leds();
+
+	if (*args && !parse_leds(args, n))
+		return false;
+
+	bisect.start(n);
+	size_enc.set_pos(ANSWER_ENC_POS);
+	set_mode(MODE_BISECT);
+	return true;
+}
+
+// See header file for documentation.
+bool cmd_stress(char *args)
+{
+	if (strcmp_P(args, PSTR("off")) == 0) {
+		stress = false;
+		force_update = true; // Restore the color set by the pots
+	} else if (*args == '\0') {
+		stress = true;
+		display.set_stress(0, 0);
+	} else {
+		return false;
+	}
+
+	display.show_stress(stress);
+	display.update();
+	return true;
+}
+
+// See header file for documentation.
+void end_reset_cal()
+{
+	size_enc.set_pos(strip.get_first_led() + strip.get_n_leds());
+	set_mode(MODE_SIZE);
+}
+
+// See header file for documentation.
+void reset_cal_answer(bool ok)
+{
+	// Clear LEDs lit by frames that haven't latched
+	strip.invalidate(RESET_CAL_CLEAR_LEDS);
+
+	if (!reset_cal.answer(ok)) {
+		strip.set_reset_time(reset_cal.test_time());
+		force_update = true;
+		return;
+	}
+
+	strip.set_reset_time(reset_cal.result());
+	ResetCal::store(STRIP_PROFILE_ID, reset_cal.result());
+
+	Serial.print(F("Reset time: "));
+	Serial.print(reset_cal.result());
+	Serial.println(F(" us"));
+
+	end_reset_cal();
+}
+
+// See header file for documentation.
+bool cmd_rstcal(char *args)
+{
+	if (*args == '\0') {
+		reset_cal.start();
+		strip.set_reset_time(reset_cal.test_time());
+		size_enc.set_pos(ANSWER_ENC_POS);
+		set_mode(MODE_RESET_CAL);
+		return true;
+	}
+
+	if (strcmp_P(args, PSTR("clear")) == 0) {
+		if (mode == MODE_RESET_CAL)
+			end_reset_cal();
+
+		ResetCal::store(STRIP_PROFILE_ID, 0);
+		strip.set_reset_time(WS2812_RESET_TIME);
+		return true;
+	}
+
+	if (mode != MODE_RESET_CAL)
+		return false;
+
+	if (strcmp_P(args, PSTR("ok")) == 0)
+		reset_cal_answer(true);
+	else if (strcmp_P(args, PSTR("fail")) == 0)
+		reset_cal_answer(false);
+	else if (strcmp_P(args, PSTR("off")) == 0)
+		end_reset_cal();
+	else
+		return false;
+
+	return true;
+}
+
+// See header file for documentation.
+bool cmd_dither(char *args)
+{
+	if (*args == '\0') {
+		Serial.print(F("Dither: "));
+		Serial.print(strip.dithering() ? F("on, ") : F("off, "));
+		Serial.print(frame_meter.fps());
+		Serial.print(F(" fps (min "));
+		Serial.print(DITHER_MIN_FPS);
+		Serial.println(F(" fps)"));
+		return true;
+	}
+
+	if (strcmp_P(args, PSTR("on")) == 0)
+		dither = true;
+	else if (strcmp_P(args, PSTR("off")) == 0)
+		dither = false;
+	else
+		return false;
+
+	strip.set_dithering(dither);
+	return true;
+}
+
+// See header file for documentation.
+bool cmd_color(char *args)
+{
+	if (strcmp_P(args, PSTR("rgb")) == 0)
+		color_input = COLOR_RGB;
+	else if (strcmp_P(args, PSTR("hsv")) == 0)
+		color_input = COLOR_HSV;
+	else if (strcmp_P(args, PSTR("rainbow")) == 0)
+		color_input = COLOR_RAINBOW;
+	else
+		return false;
+
+	force_update = true;
+	return true;
+}
+
+// See header file for documentation.
+bool show_rle(const uint8_t *data, uint16_t len, bool progmem)
+{
+	unsigned long n;
+
+	if (stress || mode == MODE_BISECT || mode == MODE_RESET_CAL ||
+	    !RleDecoder::frame_len(data, len, progmem, n))
+		return false;
+
+	rle_shown.data = data;
+	rle_shown.len = len;
+	rle_progmem = progmem;
+	rle_leds = n;
+	set_mode(MODE_PATTERN);
+	return true;
+}
+
+// See header file for documentation.
+bool cmd_pattern(char *args)
+{
+	if (strcmp_P(args, PSTR("off")) == 0) {
+		if (mode == MODE_PATTERN)
+			set_mode(MODE_SIZE);
+		return true;
+	}
+
+	char *end;
+	unsigned long i = strtoul(args, &end, 10);
+	if (end == args || *end != '\0' || i >= sizeof(rle_patterns) / sizeof(RlePattern))
+		return false;
+
+	RlePattern p;
+	memcpy_P(&p, &rle_patterns[i], sizeof(p));
+	return show_rle(p.data, p.len, true);
+}
+
+/**
+ * @brief Shows an RLE frame uploaded by the "rle" command (See cmd_rle()).
+ *
+ * @param data The frame.
+ * @param len The size of the frame in bytes.
+ * @return bool True if the frame is shown, false otherwise.
+ */
+static bool rle_received(uint8_t *data, uint16_t len)
+{
+	return show_rle(data, len, false);
+}
+
+// See header file for documentation.
+bool cmd_rle(char *args)
+{
+	char *end;
+	unsigned long len = strtoul(args, &end, 10);
+	if (end == args || *end != '\0' || len == 0 || len > RLE_BUF_SIZE)
+		return false;
+
+	// The buffer is overwritten, stop showing the previous upload
+	if (mode == MODE_PATTERN && !rle_progmem)
+		set_mode(MODE_SIZE);
+
+	serial_cmd.receive(rle_buf, len, rle_received, RLE_UPLOAD_TIMEOUT_MS);
+	return true;
+}
+
+// See header file for documentation.
+bool encoder_changed()
+{
+	if (mode == MODE_PATTERN)
+		return false;
+
+	if (mode == MODE_BISECT || mode == MODE_RESET_CAL)
+		return size_enc.ready_pos() != ANSWER_ENC_POS;
+
+	if (mode == MODE_WINDOW)
+		return strip.get_first_led() != size_enc.ready_pos();
+
+	return strip.get_n_leds() != size_enc.ready_pos();
+}
+
+// See header file for documentation.
+void apply_encoder()
+{
+	if (mode == MODE_RESET_CAL) {
+		unsigned long pos = size_enc.ready_pos();
+		if (pos != ANSWER_ENC_POS) {
+			size_enc.set_pos(ANSWER_ENC_POS);
+			reset_cal_answer(pos > ANSWER_ENC_POS); // Clockwise: latches, counter-clockwise: doesn't
+		}
+	}
+
+	display.show_bisect(mode == MODE_BISECT);
+	display.show_reset_test(mode == MODE_RESET_CAL);
+
+	// Keep the lit LEDs while calibrating
+	if (mode == MODE_RESET_CAL) {
+		display.set_reset_test(reset_cal.test_time());
+		return;
+	}
+
+	if (mode == MODE_BISECT) {
+		unsigned long pos = size_enc.ready_pos();
+		if (pos != ANSWER_ENC_POS) {
+			bisect.answer(pos > ANSWER_ENC_POS); // Clockwise: lit, counter-clockwise: not lit
+			size_enc.set_pos(ANSWER_ENC_POS);
+		}
+
+		strip.set_window(bisect.probe_first(), bisect.probe_len());
+		display.set_window(bisect.probe_first(), bisect.probe_len());
+		display.set_bisect(bisect.lower(), bisect.upper());
+		return;
+	}
+
+	if (mode == MODE_WINDOW) {
+		strip.set_window(size_enc.ready_pos(), win_len);
+		display.set_window(size_enc.ready_pos(), win_len);
+		return;
+	}
+
+	if (mode == MODE_PATTERN) {
+		display.set_n_leds(rle_leds);
+		return;
+	}
+
+	strip.set_n_leds(size_enc.ready_pos());
+	display.set_n_leds(size_enc.ready_pos());
+}
+
+// See header file for documentation.
+bool cmd_stream(char *args)
+{
+	if (*args != '\0' || stress || mode == MODE_BISECT || mode == MODE_RESET_CAL)
+		return false;
+
+	stream_pending = true;
+	return true;
+}
+
+// See header file for documentation.
+void start_stream()
+{
+	streaming = true;
+	frame_meter.start();
+
+	display.set_stress(0, 0);
+	display.show_stress(true);
+	display.show_stream(true);
+	display.update();
+
+	strip.set_white_extraction(STRIP_WHITE_EXTRACT);
+	adalight.begin();
+}
+
+// See header file for documentation.
+void stream_frames()
+{
+	if (adalight.update(strip))
+		frame_meter.frame();
+
+	if (frame_meter.update()) {
+		display.set_n_leds(adalight.frame_len());
+		display.set_stress(frame_meter.fps(), frame_meter.us_per_frame());
+		display.update();
+	}
+
+	if (adalight.quiet(ADALIGHT_DISPLAY_GAP_MS))
+		display.flush();
+
+	if (adalight.quiet(ADALIGHT_IDLE_TIMEOUT_MS)) {
+		adalight.end();
+		adalight.print_stats();
+
+		streaming = false;
+		display.show_stream(false);
+		display.show_stress(false);
+		force_update = true; // Restore the LEDs set by the inputs
+	}
+}
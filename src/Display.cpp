@@ -29,65 +29,148 @@
 
 #include <config.h>
 #include <Display.h>
+#include <sprites.h>
+
+static_assert(OLED_WIDTH == SSD1306_WIDTH, "PagedSSD1306 only supports 128 px wide displays");
+
+#define RGB_STR_LEN 18  // "R:000 G:000 B:000" or "H:000 S:000 V:000"
+#define LEDS_STR_LEN 17 // "LEDs: " + unsigned long
+#define RANGE_STR_LEN 22 // "<unsigned long>-<unsigned long>"
+#define FRAME_STR_LEN 24 // "T:<meas>/<est>us <fps>fps"
+#define LINE_CHARS (SSD1306_WIDTH / 6) // Characters per line at text size 1
 
 /**
- * @brief Converts a uint8_t to a fixed size string.
+ * @brief Formats a number with a fixed number of digits.
  * 
- * The following function converts a uint8_t to a fixed size string.
- * In other words, each number is represented with 3 digits, where
- * zeroes are prepended if necessary (ex. 001, 015 etc.).
+ * The following function formats a number below 1000 with a fixed number
+ * of digits. In other words, each number is represented with 3 digits,
+ * where zeroes are prepended if necessary (ex. 001, 015 etc.).
  * 
- * @param n The number to convert.
- * @return The converted number as a fixed size string.
+ * @param out The buffer to write to (3 characters, not terminated).
+ * @param n The number to format (0-999).
+ * @return char* The end of the written characters.
  * 
  */
-String uint8_to_fixed_str(uint8_t n)
+char *format_fixed3(char *out, uint16_t n)
 {
-	String ret = "";
-	if (n < 100)
-		ret += "0";
-	if (n < 10)
-		ret += "0";
-	ret += String(n);
-	return ret;
+	out[0] = '0' + n / 100;
+	out[1] = '0' + (n / 10) % 10;
+	out[2] = '0' + n % 10;
+	return out + 3;
 }
 
 /**
- * @brief Converts RGB values to a string.
+ * @brief Formats color values.
  * 
- * The following function converts RGB values to a string with
- * the following format:
+ * The following function formats three color values with
+ * the following format (ex. for the labels "RGB"):
  * 	"R:<red> G:<green> B:<blue>"
  *
- * @param r The red value.
- * @param g The green value.
- * @param b The blue value.
- * @return The converted RGB values as a string.
+ * @param out The buffer to write to (at least RGB_STR_LEN bytes).
+ * @param labels The labels of the three values (ex. "RGB" or "HSV").
+ * @param vals The three values (0-999).
  * 
  */
-String rgb_to_str(uint8_t r, uint8_t g, uint8_t b)
+void format_color(char *out, const char *labels, const uint16_t vals[3])
 {
-	String ret = "";
-	ret += "R:" + uint8_to_fixed_str(r) + " ";
-	ret += "G:" + uint8_to_fixed_str(g) + " ";
-	ret += "B:" + uint8_to_fixed_str(b);
-	return ret;
+	for (uint8_t i = 0; i < 3; i++) {
+		if (i)
+			*out++ = ' ';
+		*out++ = labels[i];
+		*out++ = ':';
+		out = format_fixed3(out, vals[i]);
+	}
+	*out = '\0';
 }
 
-// See header file for documentation.
-Display::Display(String title_text)
-: title_text(title_text), display(new Adafruit_SSD1306(OLED_WIDTH, OLED_HEIGHT, &Wire, OLED_RESET))
+/**
+ * @brief Formats a labelled range of LEDs.
+ * 
+ * The following function formats a range of LEDs as follows:
+ * 	"<label><first>-<last>"
+ * or a single LED as "<label><first>" if first and last are equal.
+ * With 32-bit LED counts, the text may not fit into a line, in
+ * which case the label is left out.
+ * 
+ * @param out The buffer to write to (at least RANGE_STR_LEN bytes).
+ * @param label The label (PROGMEM).
+ * @param first The first LED of the range.
+ * @param last The last LED of the range.
+ * 
+ */
+void format_range(char *out, PGM_P label, unsigned long first, unsigned long last)
 {
-	if(!display->begin(SSD1306_SWITCHCAPVCC, OLED_I2C_ADDRESS)) {
-		Serial.println(F("SSD1306 allocation failed"));
-		while(true);
+	char nums[RANGE_STR_LEN];
+	ultoa(first, nums, 10);
+
+	if (last != first) {
+		char *end = nums + strlen(nums);
+		*end++ = '-';
+		ultoa(last, end, 10);
+	}
+
+	if (strlen_P(label) + strlen(nums) <= LINE_CHARS) {
+		strcpy_P(out, label);
+		strcat(out, nums);
+	} else {
+		strcpy(out, nums);
 	}
 }
 
+/**
+ * @brief Formats a frame time.
+ * 
+ * The following function formats the measured and the estimated
+ * frame time, along with the max. frame rate, as follows:
+ * 	"T:<measured>/<estimated>us <max. frame rate>fps"
+ * Times of 10 ms or more are formatted in ms, and the frame
+ * rate is left out once it drops below 1 fps.
+ * 
+ * @param out The buffer to write to (at least FRAME_STR_LEN bytes).
+ * @param us The measured frame time in us.
+ * @param est_us The estimated frame time in us.
+ * 
+ */
+void format_frame_time(char *out, unsigned long us, unsigned long est_us)
+{
+	bool ms = est_us >= 10000 || us >= 10000;
+	unsigned long fps = 1000000UL / us;
+
+	if (ms) {
+		us /= 1000;
+		est_us /= 1000;
+	}
+
+	strcpy_P(out, PSTR("T:"));
+	ultoa(us, out + strlen(out), 10);
+	strcat_P(out, PSTR("/"));
+	ultoa(est_us, out + strlen(out), 10);
+	strcat_P(out, ms ? PSTR("ms") : PSTR("us"));
+
+	if (fps) {
+		strcat_P(out, PSTR(" "));
+		ultoa(fps, out + strlen(out), 10);
+		strcat_P(out, PSTR("fps"));
+	}
+}
+
+// See header file for documentation.
+Display::Display()
+: display(OLED_HEIGHT, OLED_I2C_ADDRESS)
+{
+}
+
+// See header file for documentation.
+void Display::begin()
+{
+	display.begin(OLED_I2C_CLOCK);
+}
+
 // See header file for documentation.
 void Display::start_screensaver()
 {
 	show_screensaver = true;
+	redraw = true;
 }
 
 // See header file for documentation.
@@ -106,61 +189,348 @@ void Display::screensaver()
 		wait = millis() < wait_until;
 		return;
 	}
-	
-	display->clearDisplay();
-	display->setTextSize(1);
-  	display->setTextColor(WHITE);
-
-	// Draw credits at top of screen.
-	display->setCursor(0,0);
-	display->println(SCREEN_SAVER_CREDITS_MSG);
 
 	// Draw Waddle Dee with open eyes
 	if (random(0, 100) <= 60) {
-		display->drawBitmap(0, 20, WaddleDeeOpen, 128, 64, WHITE);
+		set_saver_frame(0);
 		wait_until = millis() + SCREEN_SAVER_MIN_EYES_OPEN_TIME;
 	}
 	
 	// Draw Waddle Dee with closed eyes
 	else {
-		display->drawBitmap(0, 20, WaddleDeeClosed, 128, 64, WHITE);
+		set_saver_frame(1);
 		wait_until = millis() + SCREEN_SAVER_MIN_BLINK_TIME;
 	}
 
 	wait = true;
-	display->display();
+}
+
+// See header file for documentation.
+void Display::set_saver_frame(uint8_t frame)
+{
+	if (frame == saver_frame)
+		return;
+
+	if (saver_frame)
+		add_region(*WaddleDeePatches[saver_frame - 1]);
+	if (frame)
+		add_region(*WaddleDeePatches[frame - 1]);
+
+	saver_frame = frame;
+}
+
+// See header file for documentation.
+void Display::add_region(const PageSprite &sprite)
+{
+	if (redraw)
+		return;
+
+	uint8_t x1 = sprite.x + sprite.w;
+	uint8_t p1 = sprite.page + sprite.pages;
+
+	if (!region_pending) {
+		region_x0 = sprite.x;
+		region_x1 = x1;
+		region_p0 = sprite.page;
+		region_p1 = p1;
+		region_pending = true;
+		return;
+	}
+
+	region_x0 = min(region_x0, sprite.x);
+	region_x1 = max(region_x1, x1);
+	region_p0 = min(region_p0, sprite.page);
+	region_p1 = max(region_p1, p1);
+}
+
+// See header file for documentation.
+void Display::draw_screensaver()
+{
+	// Draw credits at top of screen.
+	display.setCursor(0,0);
+	display.println(SCREEN_SAVER_CREDITS_MSG);
+
+	display.blit(WaddleDeeOpen);
+	if (saver_frame)
+		display.blit(*WaddleDeePatches[saver_frame - 1], SSD1306_INVERSE);
+}
+
+// See header file for documentation.
+void Display::draw_diagnostics()
+{
+	display.setCursor(0,0);
+	display.println(F("Diagnostics"));
+
+	display.setCursor(0, 25);
+	display.print(F("Max stack: "));
+	display.print(max_stack);
+	display.println(F(" B"));
+	display.print(F("Min free:  "));
+	display.print(min_free);
+	display.println(F(" B"));
+}
+
+// See header file for documentation.
+void Display::draw_main()
+{
+	display.setCursor(0,0);
+	display.print(FW_NAME);
+	display.print(F(" v"));
+	display.println(FW_REVISION);
+	display.println(FW_AUTHORS);
+
+	char range_str[RANGE_STR_LEN];
+
+	if (show_bisect_range) {
+		if (bisect_hi - bisect_lo <= 1)
+			format_range(range_str, PSTR("Faulty LED: "), bisect_lo, bisect_lo);
+		else
+			format_range(range_str, PSTR("Bisect: "), bisect_lo, bisect_hi - 1);
+		display.print(range_str);
+	} else if (show_reset_time) {
+		display.print(F("Reset test: "));
+		display.print(reset_time);
+		display.print(F(" us"));
+	} else if (show_streaming) {
+		display.print(F("Streaming"));
+	} else if (frame_us) {
+		char frame_str[FRAME_STR_LEN];
+		format_frame_time(frame_str, frame_us, frame_est_us);
+		display.print(frame_str);
+	}
+
+	char leds_str[LEDS_STR_LEN];
+	strcpy_P(leds_str, PSTR("LEDs: "));
+	ultoa(n_leds, leds_str + 6, 10);
+
+	// Fall back to the small font if the count doesn't fit at double size
+	bool large = strlen(leds_str) * SpriteFontLarge.advance <= SSD1306_WIDTH;
+
+	if (gfx_text) {
+		display.setTextSize(large ? 2 : 1);
+		display.setCursor(0, large ? 25 : 29);
+		display.print(leds_str);
+	} else {
+		blit_str(0, large ? 25 : 29, large ? SpriteFontLarge : SpriteFontSmall, leds_str);
+	}
+
+	if (window) {
+		display.setTextSize(1);
+		display.setCursor(0, 41);
+		format_range(range_str, PSTR("Window: "), first_led, first_led + n_leds - (n_leds ? 1 : 0));
+		display.print(range_str);
+	}
+
+	display.setTextSize(1);
+	display.setCursor(0, 50);
+
+	if (show_stress_stats) {
+		display.print(stress_fps);
+		display.print(F(" fps "));
+		display.print(stress_us);
+		display.print(F(" us"));
+	} else {
+		char rgb_str[RGB_STR_LEN];
+
+		if (show_hsv_values) {
+			const uint16_t vals[3] = {hue, sat, val};
+			format_color(rgb_str, "HSV", vals);
+		} else {
+			const uint16_t vals[3] = {r, g, b};
+			format_color(rgb_str, "RGB", vals);
+		}
+
+		if (gfx_text)
+			display.print(rgb_str);
+		else
+			blit_str(0, 50, SpriteFontSmall, rgb_str);
+	}
+}
+
+// See header file for documentation.
+void Display::blit_str(int16_t x, int16_t y, const SpriteFont &font, const char *str)
+{
+	while (*str)
+		x = display.blit_char(x, y, font, *str++);
 }
 
 // See header file for documentation.
 void Display::update()
 {
-	if(show_screensaver) {
+	if (show_screensaver)
 		screensaver();
+	else
+		redraw = true;
+}
+
+// See header file for documentation.
+void Display::flush()
+{
+	// Previous page is still being flushed
+	if (!display.ready())
 		return;
+
+	if (!drawing) {
+		if (redraw) {
+			// Covers any pending partial redraw
+			display.first_page();
+		} else if (region_pending) {
+			display.first_region(region_x0, region_x1 - region_x0,
+					     region_p0, region_p1 - region_p0);
+		} else {
+			return;
+		}
+
+		redraw = false;
+		region_pending = false;
+		drawing = true;
 	}
 
-	display->clearDisplay();
-	display->setTextSize(1);
-  	display->setTextColor(WHITE);
-	  
-	display->setCursor(0,0);
-	display->println(title_text);
-	
-	display->setTextSize(2);
-	display->setCursor(0, 25);
-	display->println(String(F("LEDs: ")) + String(n_leds));
+	display.setTextSize(1);
+	display.setTextColor(WHITE);
 
-	display->setTextSize(1);
-	display->setCursor(0, 50);
-	display->println(rgb_to_str(r, g, b));
+	if (show_screensaver)
+		draw_screensaver();
+	else if (show_diag)
+		draw_diagnostics();
+	else
+		draw_main();
 
-	display->display();
+	drawing = display.next_page();
+}
+
+// See header file for documentation.
+unsigned long Display::benchmark(bool gfx, uint8_t n)
+{
+	// Complete the frame in flight, the page buffer is reused below
+	while (flushing())
+		flush();
+
+	bool prev_gfx = gfx_text;
+	gfx_text = gfx;
+	unsigned long start = micros();
+
+	for (uint8_t i = 0; i < n; i++) {
+		for (uint8_t p = 0; p < (OLED_HEIGHT + 7) / 8; p++) {
+			display.select_page(p);
+			display.setTextSize(1);
+			display.setTextColor(WHITE);
+			draw_main();
+		}
+	}
+
+	unsigned long us = (micros() - start) / n;
+	gfx_text = prev_gfx;
+	redraw = true;
+
+	return us;
+}
+
+// See header file for documentation.
+void Display::set_gfx_text(bool gfx)
+{
+	gfx_text = gfx;
+	redraw = true;
+}
+
+// See header file for documentation.
+bool Display::flushing()
+{
+	return drawing || !display.ready();
+}
+
+// See header file for documentation.
+void Display::show_diagnostics(bool show)
+{
+	show_diag = show;
+}
+
+// See header file for documentation.
+void Display::set_mem_stats(uint16_t max_stack, uint16_t min_free)
+{
+	this->max_stack = max_stack;
+	this->min_free = min_free;
 }
 
 // See header file for documentation.
 void Display::set_n_leds(unsigned long n)
 {
 	n_leds = n;
+	first_led = 0;
+	window = false;
+}
+
+// See header file for documentation.
+void Display::set_window(unsigned long first, unsigned long n)
+{
+	n_leds = n;
+	first_led = first;
+	window = true;
+}
+
+// See header file for documentation.
+void Display::show_bisect(bool show)
+{
+	show_bisect_range = show;
+}
+
+// See header file for documentation.
+void Display::set_bisect(unsigned long lo, unsigned long hi)
+{
+	bisect_lo = lo;
+	bisect_hi = hi;
+}
+
+// See header file for documentation.
+void Display::show_reset_test(bool show)
+{
+	show_reset_time = show;
+}
+
+// See header file for documentation.
+void Display::set_reset_test(uint16_t us)
+{
+	reset_time = us;
+}
+
+// See header file for documentation.
+void Display::show_stream(bool show)
+{
+	show_streaming = show;
+}
+
+// See header file for documentation.
+void Display::show_stress(bool show)
+{
+	show_stress_stats = show;
+}
+
+// See header file for documentation.
+void Display::set_stress(uint16_t fps, uint32_t us_per_frame)
+{
+	stress_fps = fps;
+	stress_us = us_per_frame;
+}
+
+// See header file for documentation.
+void Display::show_hsv(bool show)
+{
+	show_hsv_values = show;
+}
+
+// See header file for documentation.
+void Display::set_frame_time(unsigned long us, unsigned long est_us)
+{
+	frame_us = us;
+	frame_est_us = est_us;
+}
+
+// See header file for documentation.
+void Display::set_hsv(uint16_t h, uint8_t s, uint8_t v)
+{
+	hue = h;
+	sat = s;
+	val = v;
 }
 
 // See header file for documentation.
@@ -169,4 +539,4 @@ void Display::set_rgb(uint8_t r, uint8_t g, uint8_t b)
 	this->r = r;
 	this->g = g;
 	this->b = b;
-}
\ No newline at end of file
+}
@@ -0,0 +1,58 @@
+/*
+ * Copyright (C) 2022 Patrick Pedersen, TU-DO Makerspace
+
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * @file EventQueue.cpp
+ * @author Patrick Pedersen
+ *
+ * @brief Defines functions for the EventQueue class.
+ *
+ * The following file defines functions for the EventQueue class.
+ * See EventQueue.h for more information.
+ *
+ */
+
+#include <EventQueue.h>
+
+// See header file for documentation.
+bool EventQueue::pop(Event &ev)
+{
+	uint8_t t = tail;
+
+	if (t == head)
+		return false;
+
+	ev.type = types[t & (EVENT_QUEUE_SIZE - 1)];
+	ev.value = values[t & (EVENT_QUEUE_SIZE - 1)];
+	tail = t + 1; // Free the slot once it has been read
+
+	return true;
+}
+
+// See header file for documentation.
+bool EventQueue::overflowed()
+{
+	uint8_t sreg = SREG;
+	cli();
+
+	bool ret = lost;
+	lost = false;
+
+	SREG = sreg;
+	return ret;
+}
@@ -0,0 +1,89 @@
+/*
+ * Copyright (C) 2022 Patrick Pedersen, TU-DO Makerspace
+
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * @file FrameMeter.cpp
+ * @author Patrick Pedersen
+ *
+ * @brief Contains function definitions for the FrameMeter class.
+ *
+ * The following file contains the function definitions for the FrameMeter class.
+ * See the FrameMeter.h file for more information.
+ *
+ */
+
+#include <config.h>
+#include <FrameMeter.h>
+
+#define US_PER_TICK 16 // Timer1 prescaler of 256 at 16 MHz
+#define REPORT_TICKS ((uint32_t) STRESS_REPORT_MSECS * 1000 / US_PER_TICK)
+
+static_assert(F_CPU == 16000000UL, "FrameMeter assumes a 16 MHz clock");
+
+// See header file for documentation.
+void FrameMeter::begin()
+{
+	TCCR1A = 0;
+	TCCR1B = _BV(CS12); // Normal mode, prescaler 256
+	TIMSK1 = 0;
+}
+
+// See header file for documentation.
+void FrameMeter::start()
+{
+	last_tcnt = TCNT1;
+	ticks = 0;
+	n_frames = 0;
+}
+
+// See header file for documentation.
+void FrameMeter::frame()
+{
+	uint16_t tcnt = TCNT1;
+
+	ticks += (uint16_t)(tcnt - last_tcnt);
+	last_tcnt = tcnt;
+	n_frames++;
+}
+
+// See header file for documentation.
+bool FrameMeter::update()
+{
+	if (ticks < REPORT_TICKS || n_frames == 0)
+		return false;
+
+	fps_val = (uint32_t) n_frames * (1000000UL / US_PER_TICK) / ticks;
+	us_val = ticks * US_PER_TICK / n_frames;
+
+	ticks = 0;
+	n_frames = 0;
+
+	return true;
+}
+
+// See header file for documentation.
+uint16_t FrameMeter::fps()
+{
+	return fps_val;
+}
+
+// See header file for documentation.
+uint32_t FrameMeter::us_per_frame()
+{
+	return us_val;
+}
@@ -0,0 +1,92 @@
+/*
+ * Copyright (C) 2022 Patrick Pedersen, TU-DO Makerspace
+
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * @file InputWatch.cpp
+ * @author Patrick Pedersen
+ *
+ * @brief Contains function definitions for the InputWatch class.
+ *
+ * The following file contains the function definitions for the InputWatch class.
+ * See the InputWatch.h file for more information.
+ *
+ */
+
+#include <InputWatch.h>
+
+// See header file for documentation.
+InputWatch::InputWatch(uint8_t enc_a, uint8_t enc_b, uint8_t pot_r, uint8_t pot_g, uint8_t pot_b, uint16_t pot_threshold)
+: enc_reg_a(portInputRegister(digitalPinToPort(enc_a))),
+  enc_reg_b(portInputRegister(digitalPinToPort(enc_b))),
+  enc_mask_a(digitalPinToBitMask(enc_a)),
+  enc_mask_b(digitalPinToBitMask(enc_b)),
+  pot_ch{(uint8_t)(pot_r - A0), (uint8_t)(pot_g - A0), (uint8_t)(pot_b - A0)},
+  pot_threshold(pot_threshold)
+{
+}
+
+// See header file for documentation.
+bool InputWatch::check_pot()
+{
+	uint16_t val = ADC;
+	uint8_t bit = 1 << pot_idx;
+
+	if (!(pot_valid & bit)) {
+		pot_ref[pot_idx] = val;
+		pot_valid |= bit;
+	} else if ((val > pot_ref[pot_idx] ? val - pot_ref[pot_idx] : pot_ref[pot_idx] - val) > pot_threshold) {
+		return true;
+	}
+
+	pot_idx = (pot_idx + 1) % 3;
+	start_conversion();
+	return false;
+}
+
+// See header file for documentation.
+void InputWatch::arm()
+{
+	enc_state_a = *enc_reg_a & enc_mask_a;
+	enc_state_b = *enc_reg_b & enc_mask_b;
+
+	// Borrow the ADC from the background pot sampling
+	uint8_t sreg = SREG;
+	cli();
+	adc_borrowed = ADCSRA & _BV(ADIE);
+	adc_mux = ADMUX;
+	ADCSRA &= ~_BV(ADIE);
+	SREG = sreg;
+
+	while (ADCSRA & _BV(ADSC));
+	pot_valid = 0;
+	pot_idx = 0;
+	start_conversion();
+}
+
+// See header file for documentation.
+void InputWatch::disarm()
+{
+	while (ADCSRA & _BV(ADSC));
+
+	// Resume the background pot sampling with a fresh conversion
+	if (adc_borrowed) {
+		ADMUX = adc_mux;
+		ADCSRA |= _BV(ADIF) | _BV(ADIE) | _BV(ADSC);
+		adc_borrowed = false;
+	}
+}
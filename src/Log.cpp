@@ -0,0 +1,104 @@
+/*
+ * Copyright (C) 2022 Patrick Pedersen, TU-DO Makerspace
+
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * @file Log.cpp
+ * @author Patrick Pedersen
+ *
+ * @brief Non-blocking binary log.
+ *
+ * The following file implements the binary log.
+ * See Log.h for more information.
+ *
+ */
+
+#include <Log.h>
+
+static uint8_t log_buf[LOG_BUF_SIZE];
+static volatile uint8_t log_head = 0; // Next byte to write (by log_write())
+static volatile uint8_t log_tail = 0; // Next byte to send (by log_flush())
+static volatile uint16_t n_dropped = 0;
+
+// See header file for documentation.
+void log_write(const uint8_t *rec, uint8_t len)
+{
+	uint8_t sreg = SREG;
+	cli();
+
+	uint8_t head = log_head;
+	uint8_t used = (head - log_tail) & (LOG_BUF_SIZE - 1);
+
+	// One byte is kept free to tell a full buffer from an empty one
+	if (len >= LOG_BUF_SIZE - used) {
+		if (n_dropped != 0xFFFF)
+			n_dropped++;
+		SREG = sreg;
+		return;
+	}
+
+	while (len--) {
+		log_buf[head] = *rec++;
+		head = (head + 1) & (LOG_BUF_SIZE - 1);
+	}
+
+	log_head = head;
+	SREG = sreg;
+}
+
+// See header file for documentation.
+void log_flush()
+{
+#ifndef STRIP_USART_SPI
+	uint8_t tail = log_tail;
+
+	while (tail != log_head) {
+		uint8_t len = 3 + log_buf[(tail + 2) & (LOG_BUF_SIZE - 1)];
+		if (Serial.availableForWrite() < len)
+			break;
+
+		while (len--) {
+			Serial.write(log_buf[tail]);
+			tail = (tail + 1) & (LOG_BUF_SIZE - 1);
+		}
+
+		log_tail = tail;
+	}
+
+	// Report dropped records once the backlog has been sent
+	uint16_t dropped = log_dropped();
+	if (tail == log_head && dropped) {
+		uint8_t sreg = SREG;
+		cli();
+		n_dropped -= dropped;
+		SREG = sreg;
+
+		log_event(LOG_DROPPED, dropped);
+	}
+#endif
+}
+
+// See header file for documentation.
+uint16_t log_dropped()
+{
+	uint8_t sreg = SREG;
+	cli();
+	uint16_t n = n_dropped;
+	SREG = sreg;
+
+	return n;
+}
@@ -0,0 +1,113 @@
+/*
+ * Copyright (C) 2022 Patrick Pedersen, TU-DO Makerspace
+
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * @file MemMonitor.cpp
+ * @author Patrick Pedersen
+ *
+ * @brief Contains function definitions for the MemMonitor class.
+ *
+ * The following file contains the function definitions for the MemMonitor class.
+ * See the MemMonitor.h file for more information.
+ *
+ */
+
+#include <config.h>
+#include <MemMonitor.h>
+
+#define MEMMON_PAINT 0xC5 /// Pattern the unused RAM is painted with
+
+extern uint8_t __heap_start; // End of .bss, start of the heap (linker)
+extern uint8_t *__brkval;    // Top of the heap, 0 if nothing has been allocated yet (avr-libc)
+
+/**
+ * @brief Paints the unused RAM.
+ *
+ * The following function paints the RAM between the end of .bss
+ * and the top of the stack with MEMMON_PAINT. It is placed in the
+ * .init3 section, where the stack pointer and zero register have
+ * been set up, but no constructors have run yet. Being naked,
+ * it has no stack frame and is "called" by falling through.
+ *
+ */
+void paint_ram() __attribute__((naked, used, section(".init3")));
+void paint_ram()
+{
+	for (uint8_t *p = &__heap_start; p <= (uint8_t *) RAMEND; p++)
+		*p = MEMMON_PAINT;
+}
+
+/**
+ * @brief Returns the current top of the heap.
+ *
+ * @return uint8_t* The current top of the heap.
+ *
+ */
+static inline uint8_t *heap_top()
+{
+	return __brkval ? __brkval : &__heap_start;
+}
+
+// See header file for documentation.
+void MemMonitor::update()
+{
+	// Freed heap memory isn't painted again, thus scan from
+	// the highest point the heap has ever reached.
+	uint8_t *top = heap_top();
+	if (top > heap_high)
+		heap_high = top;
+
+	if (scan_ptr < heap_high)
+		scan_ptr = heap_high;
+
+	for (uint8_t i = 0; i < MEMMON_SCAN_BYTES; i++) {
+		// Reached the first byte touched by the stack
+		if (scan_ptr >= stack_low || *scan_ptr != MEMMON_PAINT) {
+			if (scan_ptr < stack_low)
+				stack_low = scan_ptr;
+
+			uint16_t free_ram = (stack_low > heap_high) ? stack_low - heap_high : 0;
+			if (free_ram < min_free_ram)
+				min_free_ram = free_ram;
+
+			// Restart the scan
+			scan_ptr = heap_high;
+			return;
+		}
+		scan_ptr++;
+	}
+}
+
+// See header file for documentation.
+uint16_t MemMonitor::max_stack()
+{
+	return (uint8_t *) RAMEND - stack_low;
+}
+
+// See header file for documentation.
+uint16_t MemMonitor::min_free()
+{
+	return min_free_ram;
+}
+
+// See header file for documentation.
+uint16_t MemMonitor::free_now()
+{
+	uint8_t sp_marker;
+	return &sp_marker - heap_top();
+}
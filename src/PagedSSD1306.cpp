@@ -0,0 +1,269 @@
+/*
+ * Copyright (C) 2022 Patrick Pedersen, TU-DO Makerspace
+
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * @file PagedSSD1306.cpp
+ * @author Patrick Pedersen
+ *
+ * @brief Defines functions for the PagedSSD1306 class.
+ *
+ * The following file defines functions for the PagedSSD1306 class.
+ * See PagedSSD1306.h for more information.
+ *
+ */
+
+#include <PagedSSD1306.h>
+#include <Twi.h>
+
+// Control bytes
+#define CTRL_CMD 0x00
+#define CTRL_DATA 0x40
+
+// Commands
+#define MEMORYMODE 0x20
+#define COLUMNADDR 0x21
+#define PAGEADDR 0x22
+#define DEACTIVATE_SCROLL 0x2E
+#define SETSTARTLINE 0x40
+#define SETCONTRAST 0x81
+#define CHARGEPUMP 0x8D
+#define SEGREMAP 0xA0
+#define DISPLAYALLON_RESUME 0xA4
+#define NORMALDISPLAY 0xA6
+#define SETMULTIPLEX 0xA8
+#define DISPLAYOFF 0xAE
+#define DISPLAYON 0xAF
+#define COMSCANDEC 0xC8
+#define SETDISPLAYOFFSET 0xD3
+#define SETDISPLAYCLOCKDIV 0xD5
+#define SETPRECHARGE 0xD9
+#define SETCOMPINS 0xDA
+#define SETVCOMDETECT 0xDB
+
+// See header file for documentation.
+PagedSSD1306::PagedSSD1306(uint8_t h, uint8_t i2c_addr)
+: Adafruit_GFX(SSD1306_WIDTH, h), i2c_addr(i2c_addr)
+{
+}
+
+// See header file for documentation.
+void PagedSSD1306::command_list(const uint8_t *cmds, uint8_t n)
+{
+	uint8_t cmd_buf[8];
+
+	while (n) {
+		uint8_t len = min(n, sizeof(cmd_buf));
+		memcpy_P(cmd_buf, cmds, len);
+		twi_write(i2c_addr, CTRL_CMD, cmd_buf, len);
+		cmds += len;
+		n -= len;
+	}
+}
+
+// See header file for documentation.
+void PagedSSD1306::command(uint8_t cmd)
+{
+	twi_write(i2c_addr, CTRL_CMD, &cmd, 1);
+}
+
+// See header file for documentation.
+void PagedSSD1306::begin(uint32_t i2c_clock)
+{
+	static const uint8_t init1[] PROGMEM = {
+		DISPLAYOFF,
+		SETDISPLAYCLOCKDIV, 0x80,
+		SETMULTIPLEX
+	};
+	static const uint8_t init2[] PROGMEM = {
+		SETDISPLAYOFFSET, 0x00,
+		SETSTARTLINE | 0x00,
+		CHARGEPUMP
+	};
+	static const uint8_t init3[] PROGMEM = {
+		MEMORYMODE, 0x00, // Horizontal addressing
+		SEGREMAP | 0x01,
+		COMSCANDEC
+	};
+	static const uint8_t init4[] PROGMEM = {
+		SETVCOMDETECT, 0x40,
+		DISPLAYALLON_RESUME,
+		NORMALDISPLAY,
+		DEACTIVATE_SCROLL,
+		DISPLAYON
+	};
+
+	twi_init(i2c_clock);
+
+	command_list(init1, sizeof(init1));
+	command(HEIGHT - 1);
+	command_list(init2, sizeof(init2));
+	command(0x14); // Enable charge pump
+	command_list(init3, sizeof(init3));
+	command(SETCOMPINS);
+	command(HEIGHT > 32 ? 0x12 : 0x02);
+	command(SETCONTRAST);
+	command(HEIGHT > 32 ? 0xCF : 0x8F);
+	command(SETPRECHARGE);
+	command(0xF1);
+	command_list(init4, sizeof(init4));
+}
+
+// See header file for documentation.
+void PagedSSD1306::first_page()
+{
+	first_region(0, SSD1306_WIDTH, 0, (HEIGHT + 7) / 8);
+}
+
+// See header file for documentation.
+void PagedSSD1306::first_region(uint8_t x, uint8_t w, uint8_t p, uint8_t pages)
+{
+	uint8_t addr_window[] = {
+		PAGEADDR, p, (uint8_t) (p + pages - 1),
+		COLUMNADDR, x, (uint8_t) (x + w - 1)
+	};
+
+	twi_write(i2c_addr, CTRL_CMD, addr_window, sizeof(addr_window));
+
+	page = p;
+	page_end = p + pages;
+	col0 = x;
+	cols = w;
+	clear_pending = false;
+	memset(buf, 0, sizeof(buf));
+}
+
+// See header file for documentation.
+bool PagedSSD1306::next_page()
+{
+	twi_write_async(i2c_addr, CTRL_DATA, buf, cols);
+
+	if (++page >= page_end)
+		return false;
+
+	clear_pending = true;
+	return true;
+}
+
+// See header file for documentation.
+bool PagedSSD1306::ready()
+{
+	if (twi_busy())
+		return false;
+
+	if (clear_pending) {
+		memset(buf, 0, sizeof(buf));
+		clear_pending = false;
+	}
+
+	return true;
+}
+
+// See header file for documentation.
+int16_t PagedSSD1306::page_y()
+{
+	return page * 8;
+}
+
+// See header file for documentation.
+void PagedSSD1306::drawPixel(int16_t x, int16_t y, uint16_t color)
+{
+	// Discard pixels outside of the frame's columns and the current page
+	x -= col0;
+	if (x < 0 || x >= cols)
+		return;
+
+	y -= page_y();
+	if (y < 0 || y >= 8)
+		return;
+
+	switch (color) {
+	case SSD1306_WHITE:
+		buf[x] |= (1 << y);
+		break;
+	case SSD1306_BLACK:
+		buf[x] &= ~(1 << y);
+		break;
+	case SSD1306_INVERSE:
+		buf[x] ^= (1 << y);
+		break;
+	}
+}
+
+// See header file for documentation.
+void PagedSSD1306::blit(int16_t x, int16_t y, const uint8_t *sprite, uint8_t w, uint8_t pages, uint8_t color)
+{
+	int16_t dy = y - page_y();
+	x -= col0;
+
+	for (uint8_t p = 0; p < pages; p++, sprite += w) {
+		// Row of the sprite page's top edge within the current page
+		int16_t shift = dy + p * 8;
+		if (shift <= -8 || shift >= 8)
+			continue;
+
+		for (uint8_t i = 0; i < w; i++) {
+			int16_t col = x + i;
+			if (col < 0 || col >= cols)
+				continue;
+
+			uint8_t b = pgm_read_byte(sprite + i);
+			b = (shift >= 0) ? (b << shift) : (b >> -shift);
+
+			switch (color) {
+			case SSD1306_WHITE:
+				buf[col] |= b;
+				break;
+			case SSD1306_BLACK:
+				buf[col] &= ~b;
+				break;
+			case SSD1306_INVERSE:
+				buf[col] ^= b;
+				break;
+			}
+		}
+	}
+}
+
+// See header file for documentation.
+void PagedSSD1306::blit(const PageSprite &sprite, uint8_t color)
+{
+	blit(sprite.x, sprite.page * 8, sprite.data, sprite.w, sprite.pages, color);
+}
+
+// See header file for documentation.
+int16_t PagedSSD1306::blit_char(int16_t x, int16_t y, const SpriteFont &font, char c)
+{
+	const char *pos = strchr_P(font.chars, c);
+
+	if (pos && c != '\0') {
+		uint16_t glyph_size = font.w * font.pages;
+		blit(x, y, font.glyphs + (pos - font.chars) * glyph_size, font.w, font.pages);
+	}
+
+	return x + font.advance;
+}
+
+// See header file for documentation.
+void PagedSSD1306::select_page(uint8_t p)
+{
+	page = p;
+	col0 = 0;
+	cols = SSD1306_WIDTH;
+	clear_pending = false;
+	memset(buf, 0, sizeof(buf));
+}
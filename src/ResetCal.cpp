@@ -0,0 +1,124 @@
+/*
+ * Copyright (C) 2022 Patrick Pedersen, TU-DO Makerspace
+
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * @file ResetCal.cpp
+ * @author Patrick Pedersen
+ *
+ * @brief Contains function definitions for the ResetCal class.
+ *
+ * The following file contains the function definitions for the ResetCal class.
+ * See the ResetCal.h file for more information.
+ *
+ */
+
+#include <EEPROM.h>
+
+#include <config.h>
+#include <ResetCal.h>
+
+#define EEPROM_MAGIC 0x5254 // Marks a valid record ("RT")
+
+/**
+ * @brief EEPROM record of a calibrated reset time.
+ */
+struct ResetCalRecord {
+	uint16_t magic;
+	uint16_t reset_us;
+};
+
+static_assert(sizeof(ResetCalRecord) == 4, "RESET_CAL_EEPROM_ADDR assumes 4 bytes per profile");
+
+// See header file for documentation.
+uint16_t ResetCal::load(uint8_t profile)
+{
+	ResetCalRecord rec;
+	EEPROM.get(RESET_CAL_EEPROM_ADDR + profile * sizeof(rec), rec);
+
+	if (rec.magic != EEPROM_MAGIC || rec.reset_us == 0)
+		return WS2812_RESET_TIME;
+
+	return rec.reset_us;
+}
+
+// See header file for documentation.
+void ResetCal::store(uint8_t profile, uint16_t us)
+{
+	ResetCalRecord rec = {us ? (uint16_t) EEPROM_MAGIC : (uint16_t) 0xFFFF, us};
+	EEPROM.put(RESET_CAL_EEPROM_ADDR + profile * sizeof(rec), rec);
+}
+
+// See header file for documentation.
+void ResetCal::start()
+{
+	test_us = WS2812_RESET_TIME;
+	good_us = 0;
+	running = true;
+}
+
+// See header file for documentation.
+void ResetCal::cancel()
+{
+	running = false;
+}
+
+// See header file for documentation.
+bool ResetCal::active()
+{
+	return running;
+}
+
+// See header file for documentation.
+uint16_t ResetCal::test_time()
+{
+	return test_us;
+}
+
+// See header file for documentation.
+bool ResetCal::answer(bool ok)
+{
+	if (!running)
+		return true;
+
+	// Sweeping upward, the first accepted reset time is the result
+	bool upward = test_us > WS2812_RESET_TIME;
+
+	if (ok) {
+		good_us = test_us;
+
+		if (upward || test_us < RESET_CAL_MIN_US + RESET_CAL_STEP_US)
+			running = false;
+		else
+			test_us -= RESET_CAL_STEP_US;
+	} else {
+		if (good_us)
+			running = false;
+		else if (test_us + RESET_CAL_STEP_US > RESET_CAL_MAX_US)
+			running = false;
+		else
+			test_us += RESET_CAL_STEP_US;
+	}
+
+	return !running;
+}
+
+// See header file for documentation.
+uint16_t ResetCal::result()
+{
+	return good_us ? good_us : RESET_CAL_MAX_US;
+}
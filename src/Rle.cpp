@@ -0,0 +1,90 @@
+/*
+ * Copyright (C) 2022 Patrick Pedersen, TU-DO Makerspace
+
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * @file Rle.cpp
+ * @author Patrick Pedersen
+ *
+ * @brief Contains function definitions for the RleDecoder class.
+ *
+ * The following file contains the function definitions for the RleDecoder class.
+ * See the Rle.h file for more information.
+ *
+ */
+
+#include <Rle.h>
+
+// See header file for documentation.
+RleDecoder::RleDecoder(const uint8_t *data, uint16_t len, bool progmem)
+: pos(data), end(data + len), progmem(progmem)
+{
+}
+
+// See header file for documentation.
+bool RleDecoder::next(ws2812_rgb &px, uint16_t &n)
+{
+	if (literal) {
+		literal--;
+		read_px(px);
+		n = 1;
+		return !broken;
+	}
+
+	uint8_t tag = read();
+	n = tag & RLE_COUNT_MASK;
+
+	if (n == 0) {
+		n = read();
+		n |= (uint16_t) read() << 8;
+
+		if (n == 0) {
+			// A literal can't be empty
+			if (tag & RLE_LITERAL)
+				broken = true;
+			return false;
+		}
+	}
+
+	if (tag & RLE_LITERAL) {
+		literal = n - 1;
+		n = 1;
+	}
+
+	read_px(px);
+	return !broken;
+}
+
+// See header file for documentation.
+bool RleDecoder::valid()
+{
+	return !broken && !literal;
+}
+
+// See header file for documentation.
+bool RleDecoder::frame_len(const uint8_t *data, uint16_t len, bool progmem, unsigned long &n)
+{
+	RleDecoder rle(data, len, progmem);
+	ws2812_rgb px;
+	uint16_t span;
+
+	n = 0;
+	while (rle.next(px, span))
+		n += span;
+
+	return rle.valid();
+}
@@ -0,0 +1,137 @@
+/*
+ * Copyright (C) 2022 Patrick Pedersen, TU-DO Makerspace
+
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * @file SerialCmd.cpp
+ * @author Patrick Pedersen
+ *
+ * @brief Contains function definitions for the SerialCmd class.
+ *
+ * The following file contains the function definitions for the SerialCmd class.
+ * See the SerialCmd.h file for more information.
+ *
+ */
+
+#include <SerialCmd.h>
+
+// See header file for documentation.
+SerialCmd::SerialCmd(const SerialCmdEntry *cmds, uint8_t n_cmds)
+: cmds(cmds), n_cmds(n_cmds)
+{
+}
+
+// See header file for documentation.
+bool SerialCmd::dispatch()
+{
+	// Split command name and arguments
+	char *args = line;
+	while (*args && *args != ' ')
+		args++;
+	if (*args)
+		*args++ = '\0';
+
+	for (uint8_t i = 0; i < n_cmds; i++) {
+		const char *name = (const char *) pgm_read_ptr(&cmds[i].name);
+		if (strcmp_P(line, name) == 0) {
+			serial_cmd_handler handler = (serial_cmd_handler) pgm_read_ptr(&cmds[i].handler);
+			return handler(args);
+		}
+	}
+
+	return false;
+}
+
+// See header file for documentation.
+bool SerialCmd::read_payload()
+{
+	while (payload_n < payload_len && Serial.available()) {
+		payload[payload_n++] = Serial.read();
+		payload_tstamp = millis();
+	}
+
+	bool ok;
+	if (payload_n == payload_len)
+		ok = payload_handler(payload, payload_len);
+	else if (millis() - payload_tstamp >= payload_timeout)
+		ok = false;
+	else
+		return false;
+
+	Serial.println(ok ? F("ok") : F("err"));
+	payload_len = 0;
+	return true;
+}
+
+// See header file for documentation.
+void SerialCmd::update()
+{
+	if (payload_len && !read_payload())
+		return;
+
+	while (Serial.available()) {
+		char c = Serial.read();
+
+		if (c == '\r')
+			continue;
+
+		if (c != '\n') {
+			if (len < SERIAL_CMD_MAX_LEN)
+				line[len++] = c;
+			else
+				overflow = true;
+			continue;
+		}
+
+		// Ignore empty lines
+		if (len == 0 && !overflow)
+			continue;
+
+		line[len] = '\0';
+		bool ok = !overflow && dispatch();
+
+		len = 0;
+		overflow = false;
+
+		// Commands with a payload are answered once it has been received
+		if (payload_len && ok) {
+			if (!read_payload())
+				return;
+			continue;
+		}
+
+		payload_len = 0;
+		Serial.println(ok ? F("ok") : F("err"));
+	}
+}
+
+// See header file for documentation.
+void SerialCmd::receive(uint8_t *buf, uint16_t n, serial_payload_handler handler, unsigned long timeout_ms)
+{
+	payload = buf;
+	payload_len = n;
+	payload_n = 0;
+	payload_handler = handler;
+	payload_timeout = timeout_ms;
+	payload_tstamp = millis();
+}
+
+// See header file for documentation.
+bool SerialCmd::receiving() const
+{
+	return payload_len;
+}
@@ -29,10 +29,69 @@
 #include <config.h>
 #include <SizeEncoder.h>
 
+static_assert(SIZE_ENC_MAX_POS <= (0x7FFFFFFFUL >> SHFT_CORRECT_ENCODER_STEP_SIZE),
+	      "SIZE_ENC_MAX_POS exceeds the encoder's counter");
+
+// Position change for each transition of the encoder pins, indexed by
+// (A << 2 | B << 3 | previous A | previous B << 1). Transitions which skip
+// a state (both pins changed) are assumed to have kept the direction.
+static const int8_t enc_steps[16] PROGMEM = {
+	0, 1, -1, 2,
+	-1, 0, -2, 1,
+	1, -2, 0, -1,
+	2, -1, 1, 0
+};
+
+// The interrupt handler's state, there is only a single encoder
+static volatile uint8_t *enc_reg_a, *enc_reg_b;
+static uint8_t enc_mask_a, enc_mask_b;
+static uint8_t enc_state;
+static volatile long enc_pos = 0;
+static EventQueue *enc_events;
+
+/**
+ * @brief Encoder pin change interrupt handler.
+ * 
+ * The following function decodes a transition of the
+ * encoder pins and posts the resulting step as an event.
+ * 
+ */
+static void enc_isr()
+{
+	uint8_t state = enc_state;
+
+	if (*enc_reg_a & enc_mask_a)
+		state |= 4;
+	if (*enc_reg_b & enc_mask_b)
+		state |= 8;
+
+	int8_t step = pgm_read_byte(&enc_steps[state]);
+	enc_state = state >> 2;
+
+	if (step) {
+		enc_pos += step;
+		enc_events->push(EVENT_ENCODER, step);
+	}
+}
+
 // See header file for documentation.
 inline long SizeEncoder::read_enc()
 {
-	return enc->read() >> SHFT_CORRECT_ENCODER_STEP_SIZE;
+	uint8_t sreg = SREG;
+	cli();
+	long pos = enc_pos;
+	SREG = sreg;
+
+	return pos >> SHFT_CORRECT_ENCODER_STEP_SIZE;
+}
+
+// See header file for documentation.
+void SizeEncoder::write_enc(long pos)
+{
+	uint8_t sreg = SREG;
+	cli();
+	enc_pos = pos;
+	SREG = sreg;
 }
 
 // See header file for documentation.
@@ -44,17 +103,31 @@ void SizeEncoder::prep_rdy()
 
 // See header file for documentation.
 SizeEncoder::SizeEncoder(uint8_t pin_a, uint8_t pin_b, unsigned long ready_time_ms)
-: enc(new Encoder(pin_a, pin_b)), ready_time(ready_time_ms)
+: pin_a(pin_a), pin_b(pin_b), ready_time(ready_time_ms)
 {
-	saved_pos = read_enc();
-	rdy_pos = saved_pos;
-	prep_rdy();
-};
+}
 
 // See header file for documentation.
-SizeEncoder::~SizeEncoder()
+void SizeEncoder::begin(EventQueue &events)
 {
-	delete enc;
+	pinMode(pin_a, INPUT_PULLUP);
+	pinMode(pin_b, INPUT_PULLUP);
+
+	enc_reg_a = portInputRegister(digitalPinToPort(pin_a));
+	enc_reg_b = portInputRegister(digitalPinToPort(pin_b));
+	enc_mask_a = digitalPinToBitMask(pin_a);
+	enc_mask_b = digitalPinToBitMask(pin_b);
+	enc_events = &events;
+
+	delayMicroseconds(2000); // Let the pull-ups settle
+	enc_state = ((*enc_reg_a & enc_mask_a) ? 1 : 0) | ((*enc_reg_b & enc_mask_b) ? 2 : 0);
+
+	attachInterrupt(digitalPinToInterrupt(pin_a), enc_isr, CHANGE);
+	attachInterrupt(digitalPinToInterrupt(pin_b), enc_isr, CHANGE);
+
+	saved_pos = read_enc();
+	rdy_pos = saved_pos;
+	prep_rdy();
 }
 
 // See header file for documentation.
@@ -65,7 +138,10 @@ bool SizeEncoder::update()
 	
 	if (pos < 0) {
 		pos = 0;
-		enc->write(0);
+		write_enc(0);
+	} else if ((unsigned long) pos > SIZE_ENC_MAX_POS) {
+		pos = SIZE_ENC_MAX_POS;
+		write_enc(pos << SHFT_CORRECT_ENCODER_STEP_SIZE);
 	}
 
 	bool changed = ((unsigned long) pos != saved_pos);
@@ -78,12 +154,21 @@ bool SizeEncoder::update()
 		if (millis() >= rdy_tstamp) {
 			rdy_pos = pos;
 			rdy = true;
+			settle_pending = true;
 		}
 	}
 	
 	return ret;
 }
 
+// See header file for documentation.
+bool SizeEncoder::settled()
+{
+	bool ret = settle_pending;
+	settle_pending = false;
+	return ret;
+}
+
 // See header file for documentation.
 bool SizeEncoder::ready()
 {
@@ -96,6 +181,18 @@ unsigned long SizeEncoder::ready_pos()
 	return rdy_pos;
 }
 
+// See header file for documentation.
+void SizeEncoder::set_pos(unsigned long pos)
+{
+	if (pos > SIZE_ENC_MAX_POS)
+		pos = SIZE_ENC_MAX_POS;
+
+	write_enc(pos << SHFT_CORRECT_ENCODER_STEP_SIZE);
+	saved_pos = pos;
+	rdy_pos = pos;
+	rdy = true;
+}
+
 // See header file for documentation.
 unsigned long SizeEncoder::t_since_last_change()
 {
@@ -29,97 +29,750 @@
 
 #include <config.h>
 #include <Strip.h>
+#include <Hsv.h>
+#include <Rle.h>
+#include <Log.h>
+#include <Pipeline.h>
+#include <Adalight.h>
+
+#ifdef STRIP_USART_SPI
+#include <UsartWs2812.h>
+#endif
+
+/**
+ * @brief Helper function to prepare a transmission
+ * 
+ * Frames are either bit-banged by TinyWS2812 or shifted out by the
+ * USART (See STRIP_USART_SPI in config.h and UsartWs2812.h), both
+ * with interrupts disabled.
+ * 
+ * @param ws2812_dev The WS2812 strip device (unused by the USART transmitter).
+ * 
+ */
+inline void strip_prep_tx(ws2812 *ws2812_dev)
+{
+#ifdef STRIP_USART_SPI
+	usart_ws2812_prep_tx();
+#else
+	ws2812_prep_tx(ws2812_dev);
+#endif
+}
+
+/**
+ * @brief Helper function to transmit triplets through the selected transmitter
+ * 
+ * @param ws2812_dev The WS2812 strip device (unused by the USART transmitter).
+ * @param leds The bytes to transmit, in wire order (See StripStages).
+ * @param n The number of triplets.
+ * 
+ */
+inline void strip_tx_raw(ws2812 *ws2812_dev, ws2812_rgb *leds, size_t n)
+{
+#ifdef STRIP_USART_SPI
+	usart_ws2812_tx(leds, n);
+#else
+	ws2812_tx(ws2812_dev, leds, n);
+#endif
+}
+
+static uint8_t rgbw_buf[6]; // Bytes of RGBW LEDs not yet transmitted (See strip_tx())
+static uint8_t rgbw_n;      // Number of bytes in rgbw_buf
+static bool rgbw_extract;   // Move the common part of the channels to W (See Strip::set_white_extraction())
+
+/**
+ * @brief Helper function to transmit LEDs through the selected transmitter
+ * 
+ * The LEDs must have passed StripStages, so their channels are in wire
+ * order. Both transmitters only send 3 bytes per LED. For RGBW LEDs
+ * (STRIP_CHANNELS = 4), the following function packs the 4 bytes of
+ * each LED into triplets: the common part of the channels is copied to
+ * the W channel, which follows the others, so grey test and stress
+ * frames toggle the data bits of all four channels. With white
+ * extraction enabled, it is moved instead. Bytes which don't fill a
+ * triplet are carried over to the next LED, and padded by
+ * strip_close_tx(). The profile is resolved at compile time, so RGB
+ * builds go straight to the transmitter.
+ * 
+ * @param ws2812_dev The WS2812 strip device (unused by the USART transmitter).
+ * @param leds The colors of the LEDs, in wire order.
+ * @param n The number of LEDs.
+ * 
+ */
+inline void strip_tx(ws2812 *ws2812_dev, ws2812_rgb *leds, size_t n)
+{
+	if (STRIP_CHANNELS != 4) {
+		strip_tx_raw(ws2812_dev, leds, n);
+		return;
+	}
+
+	for (size_t i = 0; i < n; i++) {
+		uint8_t w = min(leds[i].r, min(leds[i].g, leds[i].b));
+		uint8_t sub = rgbw_extract ? w : 0;
+		uint8_t *out = rgbw_buf + rgbw_n;
+
+		out[0] = leds[i].r - sub;
+		out[1] = leds[i].g - sub;
+		out[2] = leds[i].b - sub;
+		out[3] = w;
+
+		// 4 to 6 bytes are buffered, transmit all complete triplets
+		rgbw_n += 4;
+		uint8_t triplets = (rgbw_n >= 6) ? 2 : 1;
+		strip_tx_raw(ws2812_dev, (ws2812_rgb *) rgbw_buf, triplets);
+		rgbw_n -= 3 * triplets;
+
+		for (uint8_t j = 0; j < rgbw_n; j++)
+			rgbw_buf[j] = rgbw_buf[3 * triplets + j];
+	}
+}
+
+/**
+ * @brief Helper function to complete a transmission
+ * 
+ * @param ws2812_dev The WS2812 strip device (unused by the USART transmitter).
+ * 
+ */
+inline void strip_close_tx(ws2812 *ws2812_dev)
+{
+	// Pad the last bytes of RGBW LEDs to a full triplet, the padding
+	// is shifted into the LED past the frame, which doesn't latch it
+	if (STRIP_CHANNELS == 4 && rgbw_n) {
+		for (uint8_t j = rgbw_n; j < 3; j++)
+			rgbw_buf[j] = 0;
+		strip_tx_raw(ws2812_dev, (ws2812_rgb *) rgbw_buf, 1);
+	}
+	rgbw_n = 0;
+
+#ifdef STRIP_USART_SPI
+	usart_ws2812_close_tx();
+#else
+	ws2812_close_tx(ws2812_dev);
+#endif
+}
+
+/**
+ * @brief Stages every pixel passes before it is transmitted (See Pipeline.h).
+ * 
+ * Gamma correction and brightness limiting are configured in config.h
+ * (STRIP_GAMMA and STRIP_MAX_LEVEL), the color order is applied last,
+ * as the transmitters send triplets as they are. Runs of equally colored
+ * LEDs pass the stages once, all other pixels are passed through them
+ * right before they are transmitted.
+ */
+typedef PixelStages<Gamma<STRIP_GAMMA>, Dim<STRIP_MAX_LEVEL>, Order<WS2812_COLOR_ORDER>> StripStages;
+
+#define TIMER1_US_PER_TICK 16 // See FrameMeter::begin()
+
+static uint16_t tx_ovf;    // Timer1 overflows during the current frame
+
+static uint16_t tx_count;  // LEDs of the current frame transmitted, modulo 65536
+static bool tx_dots;       // Progress dots may be written in the current frame
+static bool tx_dots_sent;  // A progress dot has been written in the current frame
+
+/**
+ * @brief Helper function to track the progress of long frames
+ * 
+ * Frames of hundreds of thousands of LEDs take seconds to transmit,
+ * during which interrupts are disabled and Serial can't send anything.
+ * The following function counts the transmitted LEDs, and writes a '.'
+ * straight to the USART every 65536 LEDs (See STRIP_PROGRESS in config.h).
+ * It also counts Timer1 overflows, so frames longer than a Timer1 period
+ * (~1 s) are timed correctly (See Strip::commit()).
+ * 
+ * @param n The number of LEDs that have just been transmitted.
+ * 
+ */
+inline void tx_progress(uint8_t n)
+{
+	if (TIFR1 & _BV(TOV1)) {
+		TIFR1 = _BV(TOV1);
+		tx_ovf++;
+	}
+
+	if (STRIP_PROGRESS) {
+		tx_count += n;
+		if (tx_count < n && tx_dots && (UCSR0A & _BV(UDRE0))) {
+			UDR0 = '.';
+			tx_dots_sent = true;
+		}
+	}
+}
+
+/**
+ * @brief Helper function to transmit a run of equally colored LEDs
+ * 
+ * The run is transmitted in batches of STRIP_TX_BATCH LEDs to keep
+ * the per LED call overhead low. If an input watch is provided, the
+ * transmission is aborted at the next batch boundary once an input
+ * change is detected. The gap this adds between two LEDs is far below
+ * the WS2812 reset time, so it doesn't cause the strip to latch early.
+ * 
+ * @param ws2812_dev The WS2812 strip device.
+ * @param rgb The color of the run.
+ * @param n The number of leds in the run.
+ * @param watch Input watch to abort the transmission on input changes (or nullptr).
+ * @return bool True if the run has been transmitted, false if it has been aborted.
+ * 
+ */
+bool tx_run(ws2812 *ws2812_dev, ws2812_rgb rgb, unsigned long n, InputWatch *watch)
+{
+	ws2812_rgb batch[STRIP_TX_BATCH];
+
+	// All LEDs of the run share the result
+	StripStages::apply(rgb);
+
+	for (uint8_t i = 0; i < STRIP_TX_BATCH; i++)
+		batch[i] = rgb;
+
+	while (n) {
+		uint8_t len = (n < STRIP_TX_BATCH) ? n : STRIP_TX_BATCH;
+		strip_tx(ws2812_dev, batch, len);
+		n -= len;
+		tx_progress(len);
+
+		if (watch && watch->changed())
+			return false;
+	}
+
+	return true;
+}
+
+/**
+ * @brief Helper function to transmit the pixels of a pipeline
+ * 
+ * The following function is the output of a pixel pipeline (See
+ * Pipeline.h): Each LED's color is computed by the pipeline right before
+ * it is transmitted, in a single inlined function, so the gap between two
+ * LEDs is well below the reset time. The LED count is only updated
+ * (32-bit) once per STRIP_TX_BATCH LEDs, when the input watch is checked.
+ * 
+ * @tparam Pipeline The pixel pipeline, its stages must end with StripStages.
+ * @param ws2812_dev The WS2812 strip device.
+ * @param pipe The pixel pipeline.
+ * @param n The number of leds to transmit.
+ * @param watch Input watch to abort the transmission on input changes (or nullptr).
+ * @return bool True if the leds have been transmitted, false if the transmission
+ *              has been aborted, or the pipeline has run out of pixels.
+ * 
+ */
+template <typename Pipeline>
+bool tx_pixels(ws2812 *ws2812_dev, Pipeline &pipe, unsigned long n, InputWatch *watch)
+{
+	ws2812_rgb px;
+
+	while (n) {
+		uint8_t len = (n < STRIP_TX_BATCH) ? n : STRIP_TX_BATCH;
+		n -= len;
+
+		for (uint8_t i = 0; i < len; i++) {
+			if (!pipe.next(px))
+				return false;
+			strip_tx(ws2812_dev, &px, 1);
+		}
+
+		tx_progress(len);
+
+		if (watch && watch->changed())
+			return false;
+	}
+
+	return true;
+}
+
+/**
+ * @brief Helper function to transmit a run of rainbow colored LEDs
+ * 
+ * @param ws2812_dev The WS2812 strip device.
+ * @param rainbow The rainbow parameters.
+ * @param n The number of leds in the run.
+ * @param watch Input watch to abort the transmission on input changes (or nullptr).
+ * @return bool True if the run has been transmitted, false if it has been aborted.
+ * 
+ */
+bool tx_rainbow(ws2812 *ws2812_dev, const StripRainbow &rainbow, unsigned long n, InputWatch *watch)
+{
+	PixelPipeline<RainbowGen, StripStages> pipe(RainbowGen{rainbow.hue, rainbow.step, rainbow.s, rainbow.v});
+	return tx_pixels(ws2812_dev, pipe, n, watch);
+}
+
+/**
+ * @brief Helper function to start a transmission
+ * 
+ * @param ws2812_dev The WS2812 strip device.
+ * @param watch Input watch to arm for the transmission (or nullptr).
+ * 
+ */
+void tx_begin(ws2812 *ws2812_dev, InputWatch *watch)
+{
+	if (watch)
+		watch->arm();
+
+	// Prepare for color data transmission
+	strip_prep_tx(ws2812_dev);
+
+	if (STRIP_PROGRESS) {
+		// Only write progress dots if Serial has nothing left to send
+		tx_count = 0;
+		tx_dots = !(UCSR0B & _BV(UDRIE0));
+		tx_dots_sent = false;
+	}
+}
+
+/**
+ * @brief Helper function to end a transmission started by tx_begin()
+ * 
+ * @param ws2812_dev The WS2812 strip device.
+ * @param watch Input watch armed for the transmission (or nullptr).
+ * 
+ */
+void tx_end(ws2812 *ws2812_dev, InputWatch *watch)
+{
+	// Complete color data transmission
+	strip_close_tx(ws2812_dev);
+
+	if (STRIP_PROGRESS && tx_dots_sent)
+		Serial.println();
+
+	if (watch)
+		watch->disarm();
+}
+
+/**
+ * @brief Helper function to transmit a run-length encoded frame
+ * 
+ * Runs are transmitted in batches (See tx_run()), literal pixels are
+ * decoded one at a time right before they are transmitted, which
+ * leaves a gap of a few bytes read between two LEDs.
+ * 
+ * @param ws2812_dev The WS2812 strip device.
+ * @param rle The decoder of the frame.
+ * @param n Receives the number of transmitted LEDs.
+ * @param watch Input watch to abort the transmission on input changes (or nullptr).
+ * @return bool True if the frame has been transmitted, false if it has been aborted or is broken.
+ * 
+ */
+bool tx_rle(ws2812 *ws2812_dev, RleDecoder &rle, unsigned long &n, InputWatch *watch)
+{
+	ws2812_rgb px;
+	uint16_t len;
+
+	n = 0;
+	while (rle.next(px, len)) {
+		n += len;
+
+		if (len > 1) {
+			if (!tx_run(ws2812_dev, px, len, watch))
+				return false;
+			continue;
+		}
+
+		StripStages::apply(px);
+		strip_tx(ws2812_dev, &px, 1);
+		tx_progress(1);
+
+		if (watch && watch->changed())
+			return false;
+	}
+
+	return rle.valid();
+}
 
 /**
  * @brief Helper function to set the WS2812 strip
  * 
+ * The following function transmits a frame where the LEDs before
+ * the first lit LED are set to black, followed by the lit LEDs,
+ * followed by n_clear black LEDs to clear LEDs lit by a previous frame.
+ * The frame ends right after that, rather than padding the whole strip.
+ * If a rainbow is given, the lit LEDs show the rainbow instead of the color.
+ * 
  * @param ws2812_dev The WS2812 strip device.
  * @param r Red value.
  * @param g Green value.
  * @param b Blue value.
- * @param n_leds The number of leds in the strip.
+ * @param first The first lit led.
+ * @param n_leds The number of lit leds.
+ * @param n_clear The number of leds to clear after the lit leds.
+ * @param rainbow The rainbow to show on the lit leds, or nullptr for the color.
+ * @param watch Input watch to abort the transmission on input changes (or nullptr).
+ * @return bool True if the transmission has completed, false if it has been aborted.
  * 
  */
-void set_strip(ws2812_cpp *ws2812_dev, uint8_t r, uint8_t g, uint8_t b, unsigned long n_leds)
+bool set_strip(ws2812 *ws2812_dev, uint8_t r, uint8_t g, uint8_t b,
+	       unsigned long first, unsigned long n_leds, unsigned long n_clear,
+	       const StripRainbow *rainbow, InputWatch *watch)
 {
-	ws2812_rgb rgb = {r, g, b};
+	const ws2812_rgb black = {0, 0, 0};
+	const ws2812_rgb rgb = {r, g, b};
 
-	// Prepare for color data transmission
-	ws2812_dev->prep_tx();
+	tx_begin(ws2812_dev, watch);
 
-	// Fills strip with color
-	for (unsigned long i = 0; i < n_leds; i++)
-		ws2812_dev->tx(&rgb, sizeof(rgb)/sizeof(ws2812_rgb));
+	// Skip to the first lit led, fill it with color, and clear the rest
+	bool completed = tx_run(ws2812_dev, black, first, watch) &&
+			 (rainbow ? tx_rainbow(ws2812_dev, *rainbow, n_leds, watch) :
+				    tx_run(ws2812_dev, rgb, n_leds, watch)) &&
+			 tx_run(ws2812_dev, black, n_clear, watch);
 	
-	// Complete color data transmission
-	ws2812_dev->close_tx();
+	tx_end(ws2812_dev, watch);
+
+	return completed;
+}
+
+/**
+ * @brief Helper function to compute the output of a dithered channel
+ * 
+ * The following function returns the 8-bit value to transmit for a
+ * 10-bit channel value in the current frame. With dithering, the
+ * fraction which has been cut off is carried over to the next frame
+ * through the error accumulator. Without dithering, the value is rounded.
+ * 
+ * @param level The 10-bit channel value.
+ * @param err The error accumulator of the channel (updated).
+ * @param dither True to dither, false to round.
+ * @return uint8_t The 8-bit value to transmit.
+ * 
+ */
+uint8_t dither_channel(uint16_t level, uint8_t &err, bool dither)
+{
+	uint16_t sum = level + (dither ? err : 2);
+	uint8_t out = (sum > 1023) ? 255 : sum >> 2;
+
+	// Clamp the error at the top end, where 255 is as bright as it gets
+	uint16_t rem = sum - ((uint16_t) out << 2);
+	err = (rem > 3) ? 3 : rem;
+
+	return out;
 }
 
 // See header file for documentation.
 Strip::Strip(uint8_t pin)
+: pin(pin)
+{
+}
+
+// See header file for documentation.
+void Strip::begin()
 {
+	// The color order is applied by StripStages, triplets are sent as they are
+	const ws2812_order order = rgb;
+
+#ifdef STRIP_USART_SPI
+	usart_ws2812_init(order);
+#else
 	ws2812_cfg cfg;
 	cfg.pins = &pin;
 	cfg.n_dev = 1;
-	cfg.rst_time_us = WS2812_RESET_TIME;
-	cfg.order = WS2812_COLOR_ORDER;
+	cfg.rst_time_us = 0; // Reset time is handled by the Strip class (See latched())
+	cfg.order = order;
 
-	uint8_t ret = 0;
-	ws2812_dev = new ws2812_cpp(cfg, &ret);
+	uint8_t ret = ws2812_config(&ws2812_dev, &cfg);
 	
 	if (ret != 0) {
-		Serial.println("Failed to initialize ws2812_cpp, error code: " + String(ret));
+		Serial.print(F("Failed to initialize ws2812, error code: "));
+		Serial.println(ret);
 		while(true);
 	}
+#endif
+}
+
+// See header file for documentation.
+bool Strip::latched()
+{
+	return (micros() - latch_tstamp) >= reset_time;
+}
+
+// See header file for documentation.
+void Strip::set_reset_time(uint16_t us)
+{
+	reset_time = us;
+}
+
+// See header file for documentation.
+uint16_t Strip::get_reset_time()
+{
+	return reset_time;
+}
+
+// See header file for documentation.
+void Strip::invalidate(unsigned long n)
+{
+	if (n > prev_end)
+		prev_end = n;
 }
 
 // See header file for documentation.
-Strip::~Strip() {
-	delete ws2812_dev;
+uint16_t Strip::start_timing()
+{
+	// Unlike micros(), Timer1 keeps counting while interrupts are disabled
+	TIFR1 = _BV(TOV1);
+	tx_ovf = 0;
+	return TCNT1;
 }
 
 // See header file for documentation.
-void Strip::update_strip()
+void Strip::stop_timing(uint16_t start, unsigned long leds)
 {
-	if (clear_strip) {
-		set_strip(ws2812_dev, 0, 0, 0, prev_n_leds);
-		clear_strip = false;
+	uint16_t end = TCNT1;
+	if ((TIFR1 & _BV(TOV1)) && end < 0x8000)
+		tx_ovf++;
+
+	frame_leds = leds;
+	frame_us = (((uint32_t) tx_ovf << 16) + end - start) * TIMER1_US_PER_TICK + reset_time;
+}
+
+// See header file for documentation.
+bool Strip::commit(uint8_t r, uint8_t g, uint8_t b, unsigned long first, unsigned long n, unsigned long n_clear)
+{
+	while (!latched());
+
+	uint16_t start = start_timing();
+
+	bool completed = set_strip(&ws2812_dev, r, g, b, first, n, n_clear,
+				   rainbow ? &rainbow_cfg : nullptr, watch);
+	latch_tstamp = micros();
+
+	if (!completed) {
+		mark_input();
+		log_event(LOG_ABORTED);
+	} else {
+		stop_timing(start, first + n + n_clear);
 	}
 
-	set_strip(ws2812_dev, clr.r, clr.g, clr.b, n_leds);
+	return completed;
+}
+
+// See header file for documentation.
+bool Strip::update_strip()
+{
+	unsigned long end = first_led + n_leds;
+
+	// Clear leds lit by the previous update if the lit area has shrunk
+	unsigned long n_clear = (prev_end > end) ? prev_end - end : 0;
+
+	uint8_t err[3] = {dither_err[0], dither_err[1], dither_err[2]};
+	uint8_t r = dither_channel(level[0], err[0], dither);
+	uint8_t g = dither_channel(level[1], err[1], dither);
+	uint8_t b = dither_channel(level[2], err[2], dither);
+
+	if (!commit(r, g, b, first_led, n_leds, n_clear))
+		return false;
+
+	// Only advance the dither accumulators and the rainbow on completed frames
+	memcpy(dither_err, err, sizeof(dither_err));
+
+	if (rainbow) {
+		rainbow_cfg.hue += RAINBOW_SPEED;
+		if (rainbow_cfg.hue >= HSV_HUE_MAX)
+			rainbow_cfg.hue -= HSV_HUE_MAX;
+	}
+
+	prev_end = end;
+
+	if (input_pending) {
+		latency = micros() - input_tstamp;
+		input_pending = false;
+		log_event(LOG_LATENCY, (uint32_t) latency);
+	}
+
+	return true;
+}
+
+// See header file for documentation.
+bool Strip::repeat_strip(uint8_t n)
+{
+	while (n--) {
+		if (!update_strip())
+			return false;
+	}
+
+	return true;
+}
+
+// See header file for documentation.
+template <typename Source>
+bool Strip::stream_frame(unsigned long n, Source &src)
+{
+	ws2812_rgb px;
+	bool completed = true;
+
+	invalidate(n);
+
+	while (!latched());
+	strip_prep_tx(&ws2812_dev);
+
+	while (n--) {
+		if (!src.next_pixel(px)) {
+			completed = false;
+			break;
+		}
+		StripStages::apply(px);
+		strip_tx(&ws2812_dev, &px, 1);
+	}
+
+	strip_close_tx(&ws2812_dev);
+	latch_tstamp = micros();
+
+	return completed;
+}
+
+// Pixel sources of streamed frames
+template bool Strip::stream_frame(unsigned long n, Adalight &src);
+
+// See header file for documentation.
+bool Strip::rle_frame(RleDecoder &rle)
+{
+	const ws2812_rgb black = {0, 0, 0};
+	unsigned long n;
+
+	while (!latched());
+
+	uint16_t start = start_timing();
+
+	tx_begin(&ws2812_dev, watch);
+
+	// Clear leds lit by a previous, longer frame
+	bool completed = tx_rle(&ws2812_dev, rle, n, watch) &&
+			 (prev_end <= n || tx_run(&ws2812_dev, black, prev_end - n, watch));
+
+	tx_end(&ws2812_dev, watch);
+	latch_tstamp = micros();
+
+	if (!completed) {
+		invalidate(n);
+		mark_input();
+		log_event(LOG_ABORTED);
+		return false;
+	}
+
+	stop_timing(start, max(prev_end, n));
+	prev_end = n;
+
+	return true;
+}
+
+// See header file for documentation.
+void Strip::set_input_watch(InputWatch *watch)
+{
+	this->watch = watch;
+}
+
+// See header file for documentation.
+void Strip::mark_input()
+{
+	if (input_pending)
+		return;
+
+	input_tstamp = micros();
+	input_pending = true;
+}
+
+// See header file for documentation.
+unsigned long Strip::input_latency()
+{
+	return latency;
 }
 
 // See header file for documentation.
 void Strip::set_n_leds(unsigned long n)
 {
-	prev_n_leds = n_leds;
+	set_window(0, n);
+}
+
+// See header file for documentation.
+void Strip::set_window(unsigned long first, unsigned long n)
+{
+	first_led = first;
 	n_leds = n;
+}
 
-	// Clear strip if size decreases
-	clear_strip = (n_leds < prev_n_leds);
+// See header file for documentation.
+void Strip::set_rgb(uint8_t r, uint8_t g, uint8_t b)
+{
+	set_rgb10((uint16_t) r << 2, (uint16_t) g << 2, (uint16_t) b << 2);
+}
 
-	update_strip();
+// See header file for documentation.
+void Strip::set_rgb10(uint16_t r, uint16_t g, uint16_t b)
+{
+	rainbow = false;
+	level[0] = r;
+	level[1] = g;
+	level[2] = b;
 }
 
 // See header file for documentation.
-void Strip::set_rgb(uint8_t r, uint8_t g, uint8_t b)
+void Strip::set_rainbow(uint16_t step, uint8_t s, uint8_t v)
+{
+	rainbow = true;
+	rainbow_cfg.step = step;
+	rainbow_cfg.s = s;
+	rainbow_cfg.v = v;
+}
+
+// See header file for documentation.
+bool Strip::animated()
+{
+	return rainbow;
+}
+
+// See header file for documentation.
+bool Strip::fractional()
+{
+	return !rainbow && ((level[0] | level[1] | level[2]) & 3);
+}
+
+// See header file for documentation.
+void Strip::set_dithering(bool enable)
 {
-	clr.r = r;
-	clr.g = g;
-	clr.b = b;
-	update_strip();
+	dither = enable;
 }
 
 // See header file for documentation.
-unsigned int Strip::get_n_leds()
+bool Strip::dithering()
+{
+	return dither;
+}
+
+// See header file for documentation.
+void Strip::set_white_extraction(bool enable)
+{
+	rgbw_extract = enable;
+}
+
+// See header file for documentation.
+unsigned long Strip::get_n_leds()
 {
 	return n_leds;
 }
 
+// See header file for documentation.
+unsigned long Strip::frame_time()
+{
+	return frame_us;
+}
+
+// See header file for documentation.
+unsigned long Strip::frame_estimate()
+{
+	return frame_leds * WS2812_LED_US + reset_time;
+}
+
+// See header file for documentation.
+unsigned long Strip::frame_len()
+{
+	return frame_leds;
+}
+
+// See header file for documentation.
+unsigned long Strip::get_first_led()
+{
+	return first_led;
+}
+
 // See header file for documentation.
 void Strip::get_rgb(uint8_t &r, uint8_t &g, uint8_t &b)
 {
-	r = clr.r;
-	g = clr.g;
-	b = clr.b;
+	r = level[0] >> 2;
+	g = level[1] >> 2;
+	b = level[2] >> 2;
 } 
\ No newline at end of file
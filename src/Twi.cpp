@@ -0,0 +1,139 @@
+/*
+ * Copyright (C) 2022 Patrick Pedersen, TU-DO Makerspace
+
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * @file Twi.cpp
+ * @author Patrick Pedersen
+ *
+ * @brief Interrupt driven I2C (TWI) transmitter.
+ *
+ * The following file implements the interrupt driven I2C transmitter.
+ * See Twi.h for more information.
+ *
+ */
+
+#include <Twi.h>
+
+// TWI status codes (master transmitter)
+#define TW_STATUS_MASK 0xF8
+#define TW_START 0x08
+#define TW_REP_START 0x10
+#define TW_MT_SLA_ACK 0x18
+#define TW_MT_DATA_ACK 0x28
+
+static volatile bool busy = false;
+static volatile bool nack = false;
+static volatile bool ctrl_pending;
+static uint8_t sla;
+static uint8_t ctrl_byte;
+static const uint8_t *volatile tx_data;
+static volatile uint8_t tx_left;
+
+/**
+ * @brief Sends a STOP condition and ends the transmission.
+ */
+static inline void stop()
+{
+	TWCR = _BV(TWEN) | _BV(TWINT) | _BV(TWSTO);
+	busy = false;
+}
+
+/**
+ * @brief TWI interrupt handler.
+ *
+ * Sends the next byte of the current transmission once the
+ * previous one has been acknowledged.
+ */
+ISR(TWI_vect)
+{
+	switch (TWSR & TW_STATUS_MASK) {
+	case TW_START:
+	case TW_REP_START:
+		TWDR = sla;
+		TWCR = _BV(TWEN) | _BV(TWIE) | _BV(TWINT);
+		break;
+	case TW_MT_SLA_ACK:
+	case TW_MT_DATA_ACK:
+		if (ctrl_pending) {
+			ctrl_pending = false;
+			TWDR = ctrl_byte;
+		} else if (tx_left) {
+			tx_left--;
+			TWDR = *tx_data++;
+		} else {
+			stop();
+			break;
+		}
+		TWCR = _BV(TWEN) | _BV(TWIE) | _BV(TWINT);
+		break;
+	default: // NACK or arbitration lost
+		nack = true;
+		stop();
+		break;
+	}
+}
+
+// See header file for documentation.
+void twi_init(uint32_t freq)
+{
+	// Enable internal pull-ups on SDA (PC4) and SCL (PC5)
+	PORTC |= _BV(4) | _BV(5);
+
+	TWSR = 0; // Prescaler 1
+	TWBR = ((F_CPU / freq) - 16) / 2;
+	TWCR = _BV(TWEN);
+}
+
+// See header file for documentation.
+void twi_write_async(uint8_t addr, uint8_t ctrl, const uint8_t *data, uint8_t len)
+{
+	twi_wait();
+
+	// Wait for the STOP condition of the previous transmission to complete
+	while (TWCR & _BV(TWSTO));
+
+	sla = addr << 1;
+	ctrl_byte = ctrl;
+	ctrl_pending = true;
+	tx_data = data;
+	tx_left = len;
+	nack = false;
+	busy = true;
+
+	TWCR = _BV(TWEN) | _BV(TWIE) | _BV(TWINT) | _BV(TWSTA);
+}
+
+// See header file for documentation.
+bool twi_write(uint8_t addr, uint8_t ctrl, const uint8_t *data, uint8_t len)
+{
+	twi_write_async(addr, ctrl, data, len);
+	return twi_wait();
+}
+
+// See header file for documentation.
+bool twi_busy()
+{
+	return busy;
+}
+
+// See header file for documentation.
+bool twi_wait()
+{
+	while (busy);
+	return !nack;
+}
@@ -0,0 +1,138 @@
+/*
+ * Copyright (C) 2022 Patrick Pedersen, TU-DO Makerspace
+
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * @file UsartWs2812.cpp
+ * @author Patrick Pedersen
+ *
+ * @brief Defines functions for the USART WS2812 transmitter.
+ *
+ * The following file defines functions for the USART WS2812 transmitter.
+ * See UsartWs2812.h for more information.
+ *
+ */
+
+#include <stddef.h>
+
+#include <UsartWs2812.h>
+
+static_assert(F_CPU == 16000000UL, "The USART WS2812 timing assumes a 16 MHz clock");
+
+#define USART_SPI_UBRR 2 // 16 MHz / (2 * (2 + 1)) = 2.67 MHz, 375 ns per bit
+#define TX_PIN 1
+#define XCK_PIN 4
+
+// USART bytes for two WS2812 bits (MSB first), indexed by the bits
+static const uint8_t bit_pairs[4] = {0x88, 0x8C, 0xC8, 0xCC};
+
+// Offsets of the transmitted channels within ws2812_rgb, in transmission order
+static uint8_t channel_ofs[3];
+
+static uint8_t tx_sreg; // SREG before the frame (See usart_ws2812_prep_tx())
+
+/**
+ * @brief Transmits a byte as 4 USART bytes.
+ *
+ * @param c The byte to transmit.
+ *
+ */
+static inline void tx_byte(uint8_t c)
+{
+	for (uint8_t i = 0; i < 4; i++) {
+		uint8_t enc = bit_pairs[c >> 6];
+		c <<= 2;
+
+		while (!(UCSR0A & _BV(UDRE0)));
+		UDR0 = enc;
+	}
+}
+
+/**
+ * @brief Sets the transmission order of the channels.
+ *
+ * @param first Offset of the first transmitted channel within ws2812_rgb.
+ * @param second Offset of the second transmitted channel within ws2812_rgb.
+ * @param third Offset of the third transmitted channel within ws2812_rgb.
+ *
+ */
+static void set_order(uint8_t first, uint8_t second, uint8_t third)
+{
+	channel_ofs[0] = first;
+	channel_ofs[1] = second;
+	channel_ofs[2] = third;
+}
+
+// See header file for documentation.
+void usart_ws2812_init(ws2812_order order)
+{
+	const uint8_t r = offsetof(ws2812_rgb, r);
+	const uint8_t g = offsetof(ws2812_rgb, g);
+	const uint8_t b = offsetof(ws2812_rgb, b);
+
+	switch (order) {
+	case rgb: set_order(r, g, b); break;
+	case rbg: set_order(r, b, g); break;
+	case grb: set_order(g, r, b); break;
+	case gbr: set_order(g, b, r); break;
+	case brg: set_order(b, r, g); break;
+	case bgr: set_order(b, g, r); break;
+	}
+
+	// TX is driven low by the port while the transmitter is disabled
+	digitalWrite(TX_PIN, LOW);
+	pinMode(TX_PIN, OUTPUT);
+	pinMode(XCK_PIN, OUTPUT); // Required for master mode
+
+	UCSR0B = 0;
+	UCSR0C = _BV(UMSEL01) | _BV(UMSEL00); // MSPIM, MSB first, SPI mode 0
+}
+
+// See header file for documentation.
+void usart_ws2812_prep_tx()
+{
+	// Interrupt handlers outlast the 3 us in which UDR0 must be refilled
+	tx_sreg = SREG;
+	cli();
+
+	// The baud rate register must be 0 while the transmitter is enabled (See datasheet)
+	UBRR0 = 0;
+	UCSR0A = _BV(TXC0); // Clear the transmit complete flag
+	UCSR0B = _BV(TXEN0);
+	UBRR0 = USART_SPI_UBRR;
+
+	UDR0 = 0x00;
+}
+
+// See header file for documentation.
+void usart_ws2812_tx(const ws2812_rgb *leds, size_t n)
+{
+	while (n--) {
+		const uint8_t *px = (const uint8_t *) leds++;
+		tx_byte(px[channel_ofs[0]]);
+		tx_byte(px[channel_ofs[1]]);
+		tx_byte(px[channel_ofs[2]]);
+	}
+}
+
+// See header file for documentation.
+void usart_ws2812_close_tx()
+{
+	while (!(UCSR0A & _BV(TXC0)));
+	UCSR0B = 0;
+	SREG = tx_sreg;
+}
@@ -34,11 +34,334 @@
 #include <SizeEncoder.h>
 #include <ColorPots.h>
 #include <Display.h>
+#include <Bisect.h>
+#include <FrameMeter.h>
+#include <ResetCal.h>
+#include <Adalight.h>
+#include <Rle.h>
+#include <patterns.h>
+#include <Pipeline.h>
+#include <EventQueue.h>
+#include <InputWatch.h>
+#include <Log.h>
+#include <MemMonitor.h>
+#include <SerialCmd.h>
+#include <Twi.h>
+#include <Commands.h>
 
-SizeEncoder *size_enc;
-ColorPots *color_pots;
-Display *display;
-Strip *strip;
+// All firmware objects are allocated statically, their
+// hardware is initialized through begin() in setup().
+EventQueue input_events;
+Strip strip(WS2812_PIN);
+SizeEncoder size_enc(ENC_A, ENC_B, ROT_ENC_APPLY_TIME);
+ColorPots color_pots(POT_R, POT_G, POT_B);
+TesterDisplay display;
+MemMonitor mem_mon;
+InputWatch input_watch(ENC_A, ENC_B, POT_R, POT_G, POT_B, POT_ABORT_THRESHOLD);
+Bisect bisect;
+FrameMeter frame_meter;
+ResetCal reset_cal;
+Adalight adalight;
+
+bool strip_pending = false; // Strip frame waiting to be transmitted (see service_outputs())
+bool pots_pending = false;  // Pot events received, but not applied yet
+bool strip_aborted = false; // Last strip frame has been aborted due to an input change
+
+/**
+ * @brief Handles the "mem" serial command.
+ * 
+ * The following function prints the memory statistics
+ * gathered by the memory monitor over serial.
+ * 
+ * @param args Unused.
+ * @return bool Always true.
+ * 
+ */
+bool cmd_mem(char * /* args */)
+{
+	Serial.print(F("Max stack: "));
+	Serial.print(mem_mon.max_stack());
+	Serial.print(F(" B, Min free: "));
+	Serial.print(mem_mon.min_free());
+	Serial.print(F(" B, Free: "));
+	Serial.print(mem_mon.free_now());
+	Serial.println(F(" B"));
+	return true;
+}
+
+/**
+ * @brief Prints a benchmark result of the "bench" command.
+ * 
+ * @param name The name of the benchmarked rendering path.
+ * @param us The time (us) per redraw.
+ * 
+ */
+void print_bench(const __FlashStringHelper *name, unsigned long us)
+{
+	Serial.print(name);
+	Serial.print(F(": "));
+	Serial.print(us);
+	Serial.print(F(" us, "));
+	Serial.print(us * (F_CPU / 1000000UL));
+	Serial.println(F(" cycles per redraw"));
+}
+
+/**
+ * @brief Measures and prints the decode rate of a stored RLE frame.
+ * 
+ * The following function decodes a stored RLE frame RLE_BENCH_ROUNDS
+ * times (See config.h), touching every decoded pixel, and prints the
+ * time per LED next to the time per LED on the wire. As long as the
+ * former is lower, RLE frames are transmitted at the strip's data rate.
+ * 
+ * @param i The index of the frame in rle_patterns (See patterns.h).
+ * 
+ */
+void print_rle_bench(uint8_t i)
+{
+	RlePattern p;
+	memcpy_P(&p, &rle_patterns[i], sizeof(p));
+
+	ws2812_rgb px;
+	uint16_t n;
+	unsigned long leds = 0;
+	volatile uint8_t sink;
+
+	unsigned long start = micros();
+
+	for (uint8_t r = 0; r < RLE_BENCH_ROUNDS; r++) {
+		RleDecoder rle(p.data, p.len, true);
+		while (rle.next(px, n)) {
+			leds += n;
+			while (n--)
+				sink = px.g;
+		}
+	}
+
+	unsigned long us = micros() - start;
+	(void) sink;
+
+	Serial.print(F("Pattern "));
+	Serial.print(i);
+	Serial.print(F(": "));
+	Serial.print(leds / RLE_BENCH_ROUNDS);
+	Serial.print(F(" LEDs, "));
+	Serial.print(us * 1000 / leds);
+	Serial.print(F(" ns per LED decoded, "));
+	Serial.print(24UL * WS2812_BIT_NS);
+	Serial.println(F(" ns on the wire"));
+}
+
+/**
+ * @brief Measures and prints the rate of a four-stage pixel pipeline.
+ * 
+ * The following function computes PIPE_BENCH_PIXELS pixels (See
+ * config.h) with a rainbow generator, gamma correction, brightness
+ * limiting and a color order stage, all enabled regardless of the
+ * configuration (See Pipeline.h), and prints the CPU cycles per pixel
+ * next to the cycles a pixel takes on the wire. As long as the former
+ * is lower, the pipeline keeps up with the strip's data rate.
+ * The transmitter's own overhead is measured by the "profile" command.
+ * 
+ */
+void print_pipe_bench()
+{
+	PixelPipeline<RainbowGen, Gamma<true>, Dim<128>, Order<bgr>> pipe(RainbowGen{0, 7, 255, 255});
+	ws2812_rgb px;
+	volatile uint8_t sink;
+
+	unsigned long start = micros();
+
+	for (uint16_t i = 0; i < PIPE_BENCH_PIXELS; i++) {
+		pipe.next(px);
+		sink = px.r;
+		sink = px.g;
+		sink = px.b;
+	}
+
+	unsigned long us = micros() - start;
+	(void) sink;
+
+	Serial.print(F("Pipeline: "));
+	Serial.print(us * (F_CPU / 1000UL) / PIPE_BENCH_PIXELS / 1000UL);
+	Serial.print(F(" cycles per pixel, "));
+	Serial.print(8UL * STRIP_CHANNELS * WS2812_BIT_NS * (F_CPU / 1000000UL) / 1000);
+	Serial.println(F(" cycles on the wire"));
+}
+
+/**
+ * @brief Handles the "bench" serial command.
+ * 
+ * The following function measures the time it takes to render
+ * the main page with sprites and through Adafruit_GFX
+ * (See Display::benchmark()), and prints the results over serial:
+ * 	"bench"
+ * or measures how fast the stored RLE frames are decoded (See print_rle_bench()):
+ * 	"bench rle"
+ * or how fast the pixel pipeline computes pixels (See print_pipe_bench()):
+ * 	"bench pipe"
+ * 
+ * @param args The command arguments.
+ * @return bool True if the arguments are valid, false otherwise.
+ * 
+ */
+bool cmd_bench(char *args)
+{
+	if (strcmp_P(args, PSTR("rle")) == 0) {
+		for (uint8_t i = 0; i < sizeof(rle_patterns) / sizeof(RlePattern); i++)
+			print_rle_bench(i);
+		return true;
+	}
+
+	if (strcmp_P(args, PSTR("pipe")) == 0) {
+		print_pipe_bench();
+		return true;
+	}
+
+	if (*args != '\0')
+		return false;
+
+	print_bench(F("Sprites"), display.benchmark(false, 10));
+	print_bench(F("GFX"), display.benchmark(true, 10));
+	return true;
+}
+
+// Names of the build profiles, in order of their IDs (See PROFILE_* in config.h)
+const char profile_ws2812b_grb_name[] PROGMEM = "WS2812B-GRB";
+const char profile_sk6812_rgbw_name[] PROGMEM = "SK6812-RGBW";
+const char profile_long_chain_name[] PROGMEM = "Long chain";
+const char profile_low_ram_name[] PROGMEM = "Low RAM";
+
+const char *const profile_names[] PROGMEM = {
+	profile_ws2812b_grb_name,
+	profile_sk6812_rgbw_name,
+	profile_long_chain_name,
+	profile_low_ram_name,
+};
+
+static_assert(sizeof(profile_names) / sizeof(profile_names[0]) == sizeof(tester_profiles) / sizeof(TesterProfile),
+	      "Every build profile requires a name");
+
+/**
+ * @brief Handles the "profile" serial command.
+ * 
+ * The following function prints the build profile of the firmware
+ * (See config.h), and the CPU cycles spent per LED of the last completed
+ * frame, next to the cycles the LED takes on the wire. The former
+ * exceeding the latter means the transmit path can't keep up with the
+ * strip's data rate.
+ * 
+ * @param args Unused.
+ * @return bool Always true.
+ * 
+ */
+bool cmd_profile(char * /* args */)
+{
+	Serial.print(F("Profile: "));
+	Serial.println((const __FlashStringHelper *) pgm_read_ptr(&profile_names[TESTER_PROFILE]));
+	Serial.print(F("Channels: "));
+	Serial.print(STRIP_CHANNELS);
+	Serial.print(F(", Display: "));
+	Serial.println(OLED_FITTED ? F("yes") : F("no"));
+
+	unsigned long leds = strip.frame_len();
+	unsigned long us = strip.frame_time();
+
+	if (leds == 0 || us <= strip.get_reset_time()) {
+		Serial.println(F("No frame timed yet"));
+		return true;
+	}
+
+	// Split into quotient and remainder, as us * 16 exceeds 32 bits for long frames
+	us -= strip.get_reset_time();
+	Serial.print(F("Cycles/LED: "));
+	Serial.print(us / leds * (F_CPU / 1000000UL) + us % leds * (F_CPU / 1000000UL) / leds);
+	Serial.print(F(" (wire: "));
+	Serial.print(8UL * STRIP_CHANNELS * WS2812_BIT_NS * (F_CPU / 1000000UL) / 1000);
+	Serial.println(F(")"));
+	return true;
+}
+
+const char cmd_mem_name[] PROGMEM = "mem";
+const char cmd_bench_name[] PROGMEM = "bench";
+const char cmd_profile_name[] PROGMEM = "profile";
+
+const SerialCmdEntry serial_cmds[] PROGMEM = {
+	{cmd_mem_name, cmd_mem},
+	{cmd_leds_name, cmd_leds},
+	{cmd_lat_name, cmd_lat},
+	{cmd_win_name, cmd_win},
+	{cmd_bisect_name, cmd_bisect},
+	{cmd_stress_name, cmd_stress},
+	{cmd_rstcal_name, cmd_rstcal},
+	{cmd_dither_name, cmd_dither},
+	{cmd_bench_name, cmd_bench},
+	{cmd_color_name, cmd_color},
+	{cmd_stream_name, cmd_stream},
+	{cmd_pattern_name, cmd_pattern},
+	{cmd_rle_name, cmd_rle},
+	{cmd_profile_name, cmd_profile},
+};
+
+SerialCmd serial_cmd(serial_cmds, sizeof(serial_cmds)/sizeof(SerialCmdEntry));
+
+#ifdef DEBUG_BOOT_TIMELINE
+#define BOOT_TIMELINE_MAX_STEPS 8
+
+const __FlashStringHelper *boot_step_names[BOOT_TIMELINE_MAX_STEPS];
+unsigned long boot_step_tstamps[BOOT_TIMELINE_MAX_STEPS];
+uint8_t n_boot_steps = 0;
+
+/**
+ * @brief Records the completion of a boot step.
+ * 
+ * The following function records the time at which a
+ * boot step has completed. The recorded timeline is only
+ * printed once booting is done (see print_boot_timeline()),
+ * as printing over serial would otherwise distort it.
+ * 
+ * @param name Name of the completed boot step.
+ * 
+ */
+void boot_step(const __FlashStringHelper *name)
+{
+	if (n_boot_steps >= BOOT_TIMELINE_MAX_STEPS)
+		return;
+
+	boot_step_names[n_boot_steps] = name;
+	boot_step_tstamps[n_boot_steps] = millis();
+	n_boot_steps++;
+}
+
+/**
+ * @brief Prints the boot timeline over serial.
+ * 
+ * The following function prints the time (ms) spent on
+ * each boot step recorded by boot_step(), followed by
+ * the total boot time.
+ * 
+ */
+void print_boot_timeline()
+{
+	unsigned long prev = 0;
+
+	for (uint8_t i = 0; i < n_boot_steps; i++) {
+		Serial.print(boot_step_names[i]);
+		Serial.print(F(": "));
+		Serial.print(boot_step_tstamps[i] - prev);
+		Serial.println(F(" ms"));
+		prev = boot_step_tstamps[i];
+	}
+
+	Serial.print(F("Boot total: "));
+	Serial.print(prev);
+	Serial.println(F(" ms"));
+}
+
+#define BOOT_STEP(name) boot_step(F(name))
+#else
+#define BOOT_STEP(name)
+#endif
 
 /**
  * @brief Initializes the hardware.
@@ -46,20 +369,227 @@ Strip *strip;
  * The following function initializes the hardware
  * through the use of hardware abstraction libraries/classes.
  * 
+ * The strip is initialized and set first, so the first
+ * light isn't held up by the slower peripherals. The display
+ * is initialized last, as it is by far the slowest to set up.
+ * 
  */
 void setup()
 {
-	Serial.begin(9600);
+#ifndef STRIP_USART_SPI
+	Serial.begin(SERIAL_BAUD);
+	BOOT_STEP("Serial");
+#endif
+
+	strip.begin();
+	strip.set_input_watch(&input_watch);
+	strip.set_reset_time(ResetCal::load(STRIP_PROFILE_ID));
+	frame_meter.begin();
+	BOOT_STEP("Strip");
+
+	size_enc.begin(input_events);
+	BOOT_STEP("Encoder");
+
+	color_pots.begin(input_events);
+	BOOT_STEP("Pots");
+
+	apply_color(); // Also sets the display's color values, drawn once it is initialized
+	strip.set_n_leds(size_enc.ready_pos());
+	strip_pending = !strip.update_strip(); // Repeated by loop() if aborted
+	BOOT_STEP("First frame");
+
+	display.begin();
+	display.set_n_leds(size_enc.ready_pos());
+	display.update();
+	BOOT_STEP("Display");
+
+#ifdef DEBUG_BOOT_TIMELINE
+	print_boot_timeline();
+#endif
+
+	log_event(LOG_BOOT, (uint32_t) millis(), strip.get_reset_time());
+}
+
+/**
+ * @brief Input changes collected from the event queue.
+ */
+struct InputEvents {
+	bool encoder; /// The encoder has moved
+	bool pots;    /// A pot average has been sampled
+};
+
+/**
+ * @brief Collects the input events posted by the interrupt handlers.
+ * 
+ * The following function drains the event queue and coalesces the events
+ * by source, so a burst of events (ex. 20 encoder steps) results in a
+ * single update of the source. If events have been lost, all inputs are
+ * reported as changed, so they are re-read.
+ * 
+ * @return InputEvents The sources which have posted events.
+ * 
+ */
+InputEvents collect_events()
+{
+	InputEvents in = {false, false};
+	Event ev;
+
+	while (input_events.pop(ev)) {
+		switch (ev.type) {
+		case EVENT_ENCODER:
+			in.encoder = true;
+			break;
+		case EVENT_POT:
+			in.pots = true;
+			break;
+		}
+	}
+
+	if (input_events.overflowed()) {
+		in.encoder = in.pots = true;
+		log_event(LOG_EVENTS_LOST);
+	}
+
+	return in;
+}
+
+/**
+ * @brief Returns if the strip is refreshed back to back.
+ * 
+ * @return bool True in stress mode and while calibrating the reset time, false otherwise.
+ * 
+ */
+bool back_to_back()
+{
+	return stress || mode == MODE_RESET_CAL;
+}
 
-	size_enc = new SizeEncoder(ENC_A, ENC_B, ROT_ENC_APPLY_TIME);
-	color_pots = new ColorPots(POT_R, POT_G, POT_B);
-	display = new Display(String(FW_NAME) + " v" + String(FW_REVISION) + "\n" + String(FW_AUTHORS));
-	strip = new Strip(WS2812_PIN);
+/**
+ * @brief Returns if the strip is refreshed continuously to dither a fractional color.
+ * 
+ * Dithering is enabled for each new color (see apply_color()) and
+ * disabled again if the measured frame rate stays below DITHER_MIN_FPS
+ * (See config.h). Every refresh is transmitted with interrupts disabled,
+ * so the strip is only refreshed continuously while dithering pays off.
+ * 
+ * @return bool True if the current color is dithered, false otherwise.
+ * 
+ */
+bool dithered()
+{
+	return strip.fractional() && strip.dithering();
+}
 
-	uint8_t r,g,b;
-	color_pots->get_rgb(r, g, b);
-	display->set_rgb(r, g, b);
-	display->update();
+/**
+ * @brief Returns if the frame rate is being measured.
+ * 
+ * The frame rate is measured in stress mode, and while fractional colors
+ * are dithered, as dithering is only applied if the strip is refreshed
+ * at DITHER_MIN_FPS or faster (See config.h).
+ * 
+ * @return bool True if strip frames are counted by the frame meter, false otherwise.
+ * 
+ */
+bool metering()
+{
+	return stress || dithered();
+}
+
+/**
+ * @brief Interleaves strip frames and display page flushes.
+ * 
+ * Transmitting a strip frame requires interrupts to be disabled,
+ * whereas the display is flushed in the background by the TWI
+ * interrupt. Rather than letting one stall the other, the following
+ * function schedules display pages into the gaps between strip frames:
+ * A pending strip frame is started once the display page in flight has
+ * been sent and the strip has latched the previous frame. Once the
+ * frame has been sent, the next display page is flushed while the
+ * strip latches the frame (see Strip::latched()).
+ * 
+ * Frames are aborted if an input changes during transmission (see
+ * Strip::set_input_watch()), in which case the frame stays pending
+ * and is restarted once the new input values have been read.
+ * 
+ * In stress mode, each frame alternates between STRESS_PATTERN_A
+ * and STRESS_PATTERN_B (See config.h). Frames are counted by the
+ * frame meter while metering() returns true.
+ * While the reset time is calibrated, frames are sent in bursts of
+ * RESET_CAL_BURST frames, so they are only separated by the tested reset time.
+ * In pattern mode, the shown RLE frame is transmitted instead (See Strip::rle_frame()).
+ * While the payload of a serial command is received (See SerialCmd::receive()),
+ * frames are held, as bytes arriving while interrupts are disabled would be lost.
+ * Logged records are passed on to Serial as the last step (See log_flush()).
+ * 
+ * Call this function on every loop iteration.
+ * 
+ */
+void service_outputs()
+{
+	if (strip_pending && !serial_cmd.receiving()) {
+		if (twi_busy() || !strip.latched() || !size_enc.ready() || strip_aborted)
+			return;
+
+		static bool odd_frame = false;
+		if (stress) {
+			uint8_t p = odd_frame ? STRESS_PATTERN_B : STRESS_PATTERN_A;
+			strip.set_rgb(p, p, p);
+		}
+
+		// Only user colors may leave the RGB channels of RGBW LEDs dark
+		strip.set_white_extraction(STRIP_WHITE_EXTRACT && !stress &&
+					   mode != MODE_PATTERN && mode != MODE_RESET_CAL);
+
+		if (mode == MODE_RESET_CAL) {
+			strip_aborted = !strip.repeat_strip(RESET_CAL_BURST);
+			strip_pending = strip_aborted;
+		} else if (mode == MODE_PATTERN) {
+			RleDecoder rle(rle_shown.data, rle_shown.len, rle_progmem);
+			strip_aborted = !strip.rle_frame(rle);
+			strip_pending = strip_aborted;
+
+			if (!strip_aborted && metering())
+				frame_meter.frame();
+		} else {
+			strip_aborted = !strip.update_strip();
+			strip_pending = strip_aborted;
+
+			if (!strip_aborted) {
+				if (metering())
+					frame_meter.frame();
+				odd_frame = !odd_frame;
+			}
+		}
+	}
+
+	display.flush();
+	log_flush();
+}
+
+/**
+ * @brief Shows the frame time of the strip on the display.
+ * 
+ * The following function passes the measured and the estimated time of
+ * the last completed frame to the display (See Strip::frame_time()).
+ * As the measured time jitters from frame to frame, the display is only
+ * redrawn once the estimate has changed (i.e. the frame length), or the
+ * measured time has changed by more than 1/16.
+ * 
+ */
+void show_frame_time()
+{
+	static unsigned long shown_us = 0, shown_est_us = 0;
+	unsigned long us = strip.frame_time();
+	unsigned long est_us = strip.frame_estimate();
+	unsigned long diff = (us > shown_us) ? us - shown_us : shown_us - us;
+
+	if (est_us == shown_est_us && diff <= shown_us / 16)
+		return;
+
+	shown_us = us;
+	shown_est_us = est_us;
+	display.set_frame_time(us, est_us);
+	display.update();
 }
 
 /**
@@ -80,41 +610,133 @@ void setup()
  */ 
 void loop()
 {
-	bool changed = false;
+	static unsigned long diag_tstamp = 0;
+
+	if (streaming) {
+		stream_frames();
+		return;
+	}
+
+	bool changed = force_update;
+	force_update = false;
+
+	// Collect the input events posted since the last iteration. Bursts are
+	// coalesced, so each iteration commits at most one frame for the net change.
+	InputEvents in = collect_events();
+	pots_pending = pots_pending || in.pots;
+
+	// Handle Rotary Encoder
+	if ((in.encoder || !size_enc.ready()) && size_enc.update())
+		strip.mark_input();
 
 	// Check if rotary encoder is "cooled down",
 	// then check if hardware inputs have changed.
-	if (size_enc->ready()) {
-		changed = (strip->get_n_leds() != size_enc->ready_pos()); // Check if encoder has changed
-		changed = changed || color_pots->update(); 		  // Check if color pots have changed
+	// While refreshing back to back, the pots are ignored so they don't hold up the frames.
+	if (size_enc.ready()) {
+		changed = changed || (size_enc.settled() && encoder_changed()); // Check if encoder has changed
+		if (pots_pending && !back_to_back()) {				 // Check if color pots have changed
+			pots_pending = false;
+			if (color_pots.update()) {
+				strip.mark_input();
+				changed = true;
+			}
+		}
+		strip_aborted = false;
 	}
 
+	// The hidden diagnostics page is shown while the LED
+	// count is 0 and all pots are maxed out.
+	bool diag = (mode == MODE_SIZE && size_enc.ready_pos() == 0 && color_pots.maxed());
+
 	// Enable screensaver if pots and rotary encoder remain 
 	// unchanged for SHOW_SCREENSAVER_TIMEOUT_MS ms (See config.h).
-	if (color_pots->t_since_last_change() >= SHOW_SCREENSAVER_AFTER_MSECS &&
-	    size_enc->t_since_last_change() >= SHOW_SCREENSAVER_AFTER_MSECS) {
-		display->start_screensaver();
+	// Not while bisecting or calibrating, as waking the display would answer
+	// a step, and not in stress mode, as the strip must keep being refreshed.
+	if (!diag && (mode == MODE_SIZE || mode == MODE_WINDOW) && !stress &&
+	    color_pots.t_since_last_change() >= SHOW_SCREENSAVER_AFTER_MSECS &&
+	    size_enc.t_since_last_change() >= SHOW_SCREENSAVER_AFTER_MSECS) {
+		display.start_screensaver();
 
-		// Display until hardware has changed 
-		while(!color_pots->update() && !size_enc->update())
-			display->update();
+		// Display until hardware has changed, keep dithering/animating meanwhile
+		for (;;) {
+			InputEvents in = collect_events();
+			bool enc_moved = in.encoder && size_enc.update();
+			bool pots_moved = in.pots && color_pots.update();
+			if (enc_moved || pots_moved)
+				break;
+
+			display.update();
+			strip_pending = strip_pending || dithered() || strip.animated();
+			service_outputs();
+		}
 		
-		display->stop_screensaver();
+		display.stop_screensaver();
+		frame_meter.start(); // Discard frames counted meanwhile
 		changed = true;
 	}
 
 	// Handle hardware changes
 	if (changed) {
-		uint8_t r,g,b;
-		color_pots->get_rgb(r, g, b); 	            // Get color from color pots
-		display->set_rgb(r, g, b); 		    // Update color values on display
-		display->set_n_leds(size_enc->ready_pos()); // Update LED count on display
-		strip->set_rgb(r, g, b);		    // Update color on strip
-		strip->set_n_leds(size_enc->ready_pos());   // Update LED count on strip
-		strip->update_strip();			    // Update strip
-		display->update();			    // Update display
-	}
-	
-	// Handle Rotary Encoder
-	size_enc->update();
+		apply_color();				    // Update color on strip and display
+		apply_encoder();			    // Update LED count/window on strip and display
+		strip_pending = true;			    // Update strip (See service_outputs())
+		display.show_diagnostics(diag);		    // Show/Hide diagnostics page
+		display.update();			    // Update display
+	}
+
+	// Refresh diagnostics page
+	if (diag && millis() - diag_tstamp >= DIAG_REFRESH_MSECS) {
+		display.set_mem_stats(mem_mon.max_stack(), mem_mon.min_free());
+		display.update();
+		diag_tstamp = millis();
+	}
+
+	// Measure the frame rate, dithering is optimistically
+	// applied until the first measurement has completed
+	static bool was_metering = false;
+	if (metering() && !was_metering)
+		frame_meter.start();
+	was_metering = metering();
+
+	if (was_metering && frame_meter.update()) {
+		// Only dither if the 4 frame cycle is fast enough to appear flicker-free,
+		// once disabled, the frame rate isn't measured again until the color changes
+		if (!stress && frame_meter.fps() < DITHER_MIN_FPS)
+			strip.set_dithering(false);
+
+		// Report the frame rate in stress mode
+		if (stress) {
+			display.set_stress(frame_meter.fps(), frame_meter.us_per_frame());
+			display.update();
+
+			log_event(LOG_STRESS, frame_meter.fps(), frame_meter.us_per_frame());
+		}
+	}
+
+	// Keep refreshing the strip in stress mode, while calibrating,
+	// while fractional colors are dithered and while the rainbow moves
+	strip_pending = strip_pending || back_to_back() || dithered() || strip.animated();
+
+#ifdef STRIP_CONTINUOUS_REFRESH
+	// Keep refreshing the strip while the encoder is idle
+	strip_pending = strip_pending || size_enc.ready();
+#endif
+
+	// Update strip and continue flushing the display
+	service_outputs();
+	show_frame_time();
+
+	// Handle serial commands (the USART is taken by the strip with STRIP_USART_SPI)
+#ifndef STRIP_USART_SPI
+	serial_cmd.update();
+#endif
+
+	// Switch the serial port to streaming once the reply has been sent
+	if (stream_pending) {
+		stream_pending = false;
+		start_stream();
+	}
+
+	// Continue stack scan
+	mem_mon.update();
 }
\ No newline at end of file
@@ -0,0 +1,196 @@
+/*
+ * Copyright (C) 2022 Patrick Pedersen, TU-DO Makerspace
+
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * @file RefSSD1306.cpp
+ * @author Patrick Pedersen
+ *
+ * @brief Adafruit_SSD1306 reference implementation of the PagedSSD1306 class.
+ *
+ * The following file implements the interface of the PagedSSD1306 class
+ * (See PagedSSD1306.h) the way the Adafruit_SSD1306 driver draws and
+ * sends a screen, which the firmware used before rendering page by page:
+ * Every pixel is drawn into a framebuffer of the whole screen, and a
+ * frame is sent as a whole once it has been drawn, in transmissions of
+ * at most 32 bytes (the Wire library's buffer). The init sequence is
+ * that of Adafruit_SSD1306::begin() with the internal charge pump.
+ *
+ * Built in place of src/PagedSSD1306.cpp, the Display class renders
+ * the reference output of the paged renderer (See display_test.cpp).
+ *
+ */
+
+#include <PagedSSD1306.h>
+#include <Twi.h>
+
+#define WIRE_MAX 32 // Bytes per transmission, including the control byte
+
+static uint8_t framebuf[SSD1306_WIDTH * 8]; // Adafruit_SSD1306's buffer, 1 byte per column and page
+
+// See header file for documentation.
+PagedSSD1306::PagedSSD1306(uint8_t h, uint8_t i2c_addr)
+: Adafruit_GFX(SSD1306_WIDTH, h), i2c_addr(i2c_addr)
+{
+}
+
+// See header file for documentation.
+void PagedSSD1306::command_list(const uint8_t *cmds, uint8_t n)
+{
+	// Adafruit_SSD1306::ssd1306_commandList()
+	while (n) {
+		uint8_t len = min(n, WIRE_MAX - 1);
+		twi_write(i2c_addr, 0x00, cmds, len);
+		cmds += len;
+		n -= len;
+	}
+}
+
+// See header file for documentation.
+void PagedSSD1306::command(uint8_t cmd)
+{
+	twi_write(i2c_addr, 0x00, &cmd, 1);
+}
+
+// See header file for documentation.
+void PagedSSD1306::begin(uint32_t i2c_clock)
+{
+	static const uint8_t init1[] = {0xAE, 0xD5, 0x80, 0xA8};
+	static const uint8_t init2[] = {0xD3, 0x00, 0x40, 0x8D};
+	static const uint8_t init3[] = {0x20, 0x00, 0xA1, 0xC8};
+	static const uint8_t init5[] = {0xDB, 0x40, 0xA4, 0xA6, 0x2E, 0xAF};
+
+	twi_init(i2c_clock);
+	memset(framebuf, 0, sizeof(framebuf));
+
+	command_list(init1, sizeof(init1));
+	command(HEIGHT - 1);
+	command_list(init2, sizeof(init2));
+	command(0x14); // SSD1306_SWITCHCAPVCC
+	command_list(init3, sizeof(init3));
+	command(0xDA);
+	command(HEIGHT > 32 ? 0x12 : 0x02);
+	command(0x81);
+	command(HEIGHT > 32 ? 0xCF : 0x8F);
+	command(0xD9);
+	command(0xF1);
+	command_list(init5, sizeof(init5));
+}
+
+// See header file for documentation.
+void PagedSSD1306::first_page()
+{
+	// Adafruit_SSD1306::clearDisplay()
+	memset(framebuf, 0, sizeof(framebuf));
+}
+
+// See header file for documentation.
+void PagedSSD1306::first_region(uint8_t x, uint8_t w, uint8_t p, uint8_t pages)
+{
+	// Adafruit_SSD1306 has no partial updates, the whole screen is redrawn
+	first_page();
+}
+
+// See header file for documentation.
+bool PagedSSD1306::next_page()
+{
+	// Adafruit_SSD1306::display()
+	static const uint8_t dlist[] = {0x22, 0x00, 0xFF, 0x21, 0x00};
+	uint16_t count = SSD1306_WIDTH * ((HEIGHT + 7) / 8);
+	const uint8_t *ptr = framebuf;
+
+	command_list(dlist, sizeof(dlist));
+	command(SSD1306_WIDTH - 1);
+
+	while (count) {
+		uint8_t len = min(count, WIRE_MAX - 1);
+		twi_write(i2c_addr, 0x40, ptr, len);
+		ptr += len;
+		count -= len;
+	}
+
+	return false;
+}
+
+// See header file for documentation.
+bool PagedSSD1306::ready()
+{
+	return true;
+}
+
+// See header file for documentation.
+int16_t PagedSSD1306::page_y()
+{
+	return 0;
+}
+
+// See header file for documentation.
+void PagedSSD1306::drawPixel(int16_t x, int16_t y, uint16_t color)
+{
+	// Adafruit_SSD1306::drawPixel() (no rotation)
+	if (x < 0 || x >= WIDTH || y < 0 || y >= HEIGHT)
+		return;
+
+	uint8_t &b = framebuf[x + (y / 8) * SSD1306_WIDTH];
+
+	switch (color) {
+	case SSD1306_WHITE:
+		b |= (1 << (y & 7));
+		break;
+	case SSD1306_BLACK:
+		b &= ~(1 << (y & 7));
+		break;
+	case SSD1306_INVERSE:
+		b ^= (1 << (y & 7));
+		break;
+	}
+}
+
+// See header file for documentation.
+void PagedSSD1306::blit(int16_t x, int16_t y, const uint8_t *sprite, uint8_t w, uint8_t pages, uint8_t color)
+{
+	// Pixel by pixel, like drawing the sprite through Adafruit_GFX
+	for (uint8_t p = 0; p < pages; p++)
+		for (uint8_t i = 0; i < w; i++)
+			for (uint8_t j = 0; j < 8; j++)
+				if (pgm_read_byte(sprite + p * w + i) & (1 << j))
+					drawPixel(x + i, y + p * 8 + j, color);
+}
+
+// See header file for documentation.
+void PagedSSD1306::blit(const PageSprite &sprite, uint8_t color)
+{
+	blit(sprite.x, sprite.page * 8, sprite.data, sprite.w, sprite.pages, color);
+}
+
+// See header file for documentation.
+int16_t PagedSSD1306::blit_char(int16_t x, int16_t y, const SpriteFont &font, char c)
+{
+	const char *pos = strchr_P(font.chars, c);
+
+	if (pos && c != '\0') {
+		uint16_t glyph_size = font.w * font.pages;
+		blit(x, y, font.glyphs + (pos - font.chars) * glyph_size, font.w, font.pages);
+	}
+
+	return x + font.advance;
+}
+
+// See header file for documentation.
+void PagedSSD1306::select_page(uint8_t p)
+{
+}
@@ -0,0 +1,181 @@
+/*
+ * Copyright (C) 2022 Patrick Pedersen, TU-DO Makerspace
+
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * @file Adafruit_SSD1306.cpp
+ * @author Patrick Pedersen
+ *
+ * @brief Host stand-in for the Adafruit SSD1306 library, as used by the baseline Display.
+ *
+ * The following file implements the Adafruit_SSD1306 and Wire stand-ins,
+ * following the library's code. See Adafruit_SSD1306.h for more information.
+ *
+ */
+
+#include <Adafruit_SSD1306.h>
+#include <Twi.h>
+
+TwoWire Wire;
+
+// See header file for documentation.
+void TwoWire::beginTransmission(uint8_t addr)
+{
+	this->addr = addr;
+	len = 0;
+}
+
+// See header file for documentation.
+size_t TwoWire::write(uint8_t b)
+{
+	if (len == BUFFER_LENGTH)
+		return 0;
+
+	buf[len++] = b;
+	return 1;
+}
+
+// See header file for documentation.
+uint8_t TwoWire::endTransmission(bool stop)
+{
+	if (len)
+		twi_write(addr, buf[0], buf + 1, len - 1);
+	return 0;
+}
+
+// See header file for documentation.
+Adafruit_SSD1306::Adafruit_SSD1306(uint8_t w, uint8_t h, TwoWire *twi, int8_t rst_pin)
+: Adafruit_GFX(w, h), wire(twi), buffer(new uint8_t[w * ((h + 7) / 8)])
+{
+}
+
+// See header file for documentation.
+Adafruit_SSD1306::~Adafruit_SSD1306()
+{
+	delete[] buffer;
+}
+
+// See header file for documentation.
+void Adafruit_SSD1306::command_list(const uint8_t *cmds, uint8_t n)
+{
+	// ssd1306_commandList()
+	wire->beginTransmission(i2c_addr);
+	wire->write(0x00);
+	uint8_t bytes_out = 1;
+	while (n--) {
+		if (bytes_out >= BUFFER_LENGTH) {
+			wire->endTransmission();
+			wire->beginTransmission(i2c_addr);
+			wire->write(0x00);
+			bytes_out = 1;
+		}
+		wire->write(pgm_read_byte(cmds++));
+		bytes_out++;
+	}
+	wire->endTransmission();
+}
+
+// See header file for documentation.
+void Adafruit_SSD1306::command(uint8_t cmd)
+{
+	// ssd1306_command1()
+	wire->beginTransmission(i2c_addr);
+	wire->write(0x00);
+	wire->write(cmd);
+	wire->endTransmission();
+}
+
+// See header file for documentation.
+bool Adafruit_SSD1306::begin(uint8_t vcs, uint8_t addr)
+{
+	static const uint8_t init1[] PROGMEM = { 0xAE, 0xD5, 0x80, 0xA8 };
+	static const uint8_t init2[] PROGMEM = { 0xD3, 0x00, 0x40, 0x8D };
+	static const uint8_t init3[] PROGMEM = { 0x20, 0x00, 0xA1, 0xC8 };
+	static const uint8_t init5[] PROGMEM = { 0xDB, 0x40, 0xA4, 0xA6, 0x2E, 0xAF };
+
+	i2c_addr = addr;
+	clearDisplay();
+	wire->begin();
+
+	command_list(init1, sizeof(init1));
+	command(HEIGHT - 1);
+	command_list(init2, sizeof(init2));
+	command(0x14); // Internal charge pump
+	command_list(init3, sizeof(init3));
+	command(0xDA); // Set COM pins
+	command(HEIGHT > 32 ? 0x12 : 0x02);
+	command(0x81); // Set contrast
+	command(HEIGHT > 32 ? 0xCF : 0x8F);
+	command(0xD9); // Set precharge
+	command(0xF1);
+	command_list(init5, sizeof(init5));
+
+	return true;
+}
+
+// See header file for documentation.
+void Adafruit_SSD1306::display()
+{
+	static const uint8_t dlist1[] PROGMEM = { 0x22, 0x00, 0xFF, 0x21, 0x00 };
+
+	command_list(dlist1, sizeof(dlist1));
+	command(WIDTH - 1);
+
+	uint16_t count = WIDTH * ((HEIGHT + 7) / 8);
+	const uint8_t *ptr = buffer;
+	wire->beginTransmission(i2c_addr);
+	wire->write(0x40);
+	uint8_t bytes_out = 1;
+	while (count--) {
+		if (bytes_out >= BUFFER_LENGTH) {
+			wire->endTransmission();
+			wire->beginTransmission(i2c_addr);
+			wire->write(0x40);
+			bytes_out = 1;
+		}
+		wire->write(*ptr++);
+		bytes_out++;
+	}
+	wire->endTransmission();
+}
+
+// See header file for documentation.
+void Adafruit_SSD1306::clearDisplay()
+{
+	memset(buffer, 0, WIDTH * ((HEIGHT + 7) / 8));
+}
+
+// See header file for documentation.
+void Adafruit_SSD1306::drawPixel(int16_t x, int16_t y, uint16_t color)
+{
+	if (x < 0 || x >= width() || y < 0 || y >= height())
+		return;
+
+	uint8_t &b = buffer[x + (y / 8) * WIDTH];
+	uint8_t bit = 1 << (y & 7);
+	switch (color) {
+	case SSD1306_WHITE:
+		b |= bit;
+		break;
+	case SSD1306_BLACK:
+		b &= ~bit;
+		break;
+	case SSD1306_INVERSE:
+		b ^= bit;
+		break;
+	}
+}
@@ -0,0 +1,67 @@
+/*
+ * Copyright (C) 2022 Patrick Pedersen, TU-DO Makerspace
+
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * @file Adafruit_SSD1306.h
+ * @author Patrick Pedersen
+ *
+ * @brief Host stand-in for the Adafruit SSD1306 library, as used by the baseline Display.
+ *
+ * The following file provides the parts of the Adafruit_SSD1306 driver
+ * used by the Display class of the baseline firmware. Like the library,
+ * it draws into a framebuffer of the whole screen, and display() sends
+ * the framebuffer through Wire in transmissions of at most 32 bytes,
+ * preceded by the library's addressing commands. begin() sends the
+ * library's init sequence for the internal charge pump. The splash
+ * screen is left out, as the baseline never sent it.
+ *
+ */
+
+#pragma once
+
+#include <Adafruit_GFX.h>
+#include <Wire.h>
+
+#define SSD1306_BLACK 0        /// Clears a pixel
+#define SSD1306_WHITE 1        /// Sets a pixel
+#define SSD1306_INVERSE 2      /// Inverts a pixel
+#define SSD1306_SWITCHCAPVCC 2 /// Internal charge pump
+
+#define BLACK SSD1306_BLACK
+#define WHITE SSD1306_WHITE
+#define INVERSE SSD1306_INVERSE
+
+class Adafruit_SSD1306 : public Adafruit_GFX
+{
+private:
+	TwoWire *wire;
+	uint8_t i2c_addr = 0;
+	uint8_t *buffer;
+
+	void command_list(const uint8_t *cmds, uint8_t n);
+	void command(uint8_t cmd);
+
+public:
+	Adafruit_SSD1306(uint8_t w, uint8_t h, TwoWire *twi, int8_t rst_pin);
+	~Adafruit_SSD1306();
+
+	bool begin(uint8_t vcs, uint8_t addr);
+	void display();
+	void clearDisplay();
+	void drawPixel(int16_t x, int16_t y, uint16_t color) override;
+};
@@ -0,0 +1,60 @@
+/*
+ * Copyright (C) 2022 Patrick Pedersen, TU-DO Makerspace
+
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * @file Arduino.h
+ * @author Patrick Pedersen
+ *
+ * @brief Host stand-in for the Arduino core, as used by the baseline Display.
+ *
+ * The following file extends the stand-in's Arduino core (See
+ * tools/client/standin/shim) by the String class, which the Display
+ * class of the baseline firmware used to compose its text. Only the
+ * parts used by the baseline are provided. Strings convert to C strings
+ * implicitly, so they can be printed without a String overload of Print.
+ *
+ */
+
+#pragma once
+
+#include <string> // Ahead of the core's min() and max() macros
+
+#include_next <Arduino.h>
+
+class String
+{
+private:
+	std::string s;
+
+public:
+	String(const char *str = "") : s(str) {}
+	String(const __FlashStringHelper *str) : s(reinterpret_cast<const char *>(str)) {}
+	String(unsigned char n) : s(std::to_string(n)) {}
+	String(int n) : s(std::to_string(n)) {}
+	String(unsigned int n) : s(std::to_string(n)) {}
+	String(long n) : s(std::to_string(n)) {}
+	String(unsigned long n) : s(std::to_string(n)) {}
+
+	String &operator+=(const String &rhs) { s += rhs.s; return *this; }
+	friend String operator+(String lhs, const String &rhs) { return lhs += rhs; }
+	friend String operator+(String lhs, const char *rhs) { return lhs += rhs; }
+	friend String operator+(const char *lhs, const String &rhs) { return String(lhs) += rhs; }
+
+	const char *c_str() const { return s.c_str(); }
+	operator const char *() const { return s.c_str(); }
+};
@@ -0,0 +1,56 @@
+/*
+ * Copyright (C) 2022 Patrick Pedersen, TU-DO Makerspace
+
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * @file Wire.h
+ * @author Patrick Pedersen
+ *
+ * @brief Host stand-in for the Wire library, as used by Adafruit_SSD1306.
+ *
+ * The following file provides the I2C transmissions of the Wire library
+ * to the baseline display driver (See Adafruit_SSD1306.h). Like on the
+ * tester, a transmission holds at most 32 bytes. Completed transmissions
+ * are passed on to the TWI stand-in, the first byte as the control byte
+ * (See Shim.h), so the same sink receives the output of the baseline
+ * and of the current firmware.
+ *
+ */
+
+#pragma once
+
+#include <Arduino.h>
+
+#define BUFFER_LENGTH 32 /// Size of the Wire library's transmit buffer
+
+class TwoWire
+{
+private:
+	uint8_t addr = 0;
+	uint8_t buf[BUFFER_LENGTH];
+	uint8_t len = 0;
+
+public:
+	void begin() {}
+	void setClock(uint32_t freq) {}
+
+	void beginTransmission(uint8_t addr);
+	size_t write(uint8_t b);
+	uint8_t endTransmission(bool stop = true);
+};
+
+extern TwoWire Wire;
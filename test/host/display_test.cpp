@@ -0,0 +1,351 @@
+/*
+ * Copyright (C) 2022 Patrick Pedersen, TU-DO Makerspace
+
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * @file display_test.cpp
+ * @author Patrick Pedersen
+ *
+ * @brief Host test of the paged display renderer (See PagedSSD1306.h).
+ *
+ * The following test runs a series of scenes through the Display class,
+ * from the main page to the screensaver, and passes the I2C transmissions
+ * to an emulated SSD1306. It prints the init commands and the contents
+ * of the display's memory (GDDRAM) each time a frame has been sent.
+ *
+ * The scenes are checked in two ways (See Makefile):
+ *  - The scenes which the baseline firmware could show, run with the
+ *    --baseline option, must match the output of the baseline's Display
+ *    class, which drew through Adafruit_GFX and sent full frames through
+ *    the Adafruit_SSD1306 driver. Built with BASELINE defined, the test
+ *    runs these scenes on the baseline's Display class (See baseline/),
+ *    which is how golden/display.out is generated.
+ *  - All scenes must match the output of a full framebuffer that draws
+ *    and sends the screen the way the Adafruit_SSD1306 driver does (See
+ *    RefSSD1306.cpp), which covers the pages the baseline did not have.
+ *  - All scenes, run with the --gfx option, must match the output with
+ *    the text fields drawn through Adafruit_GFX rather than sprites (See
+ *    Display::set_gfx_text()).
+ *
+ * With the --bench option, the test prints the render times of both ways
+ * of drawing the text fields on the host instead (See Display::benchmark()).
+ *
+ * Only GDDRAM is compared, not the transmissions that fill it: Unlike
+ * the driver, the paged renderer sends a frame as a page per transmission,
+ * and only the pages that changed.
+ *
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include <Arduino.h>
+#include <Shim.h>
+#include <config.h>
+#include <Display.h>
+
+#define SSD1306_PAGES (OLED_HEIGHT / 8)
+#define SAVER_STEP_MS 50 // Time step of the screensaver scene
+#define SAVER_STEPS 200  // Steps of the screensaver scene
+#define BENCH_REDRAWS 200 // Redraws per benchmark (See bench())
+
+/**
+ * @brief Emulated SSD1306 in horizontal addressing mode.
+ */
+static struct {
+	uint8_t ram[SSD1306_PAGES][OLED_WIDTH];
+	uint8_t col0 = 0, col1 = OLED_WIDTH - 1;
+	uint8_t page0 = 0, page1 = SSD1306_PAGES - 1;
+	uint8_t col = 0, page = 0;
+
+	uint8_t cmd = 0;   // Command awaiting arguments
+	uint8_t nargs = 0; // Arguments left for cmd
+	uint8_t arg0 = 0;  // First argument of cmd
+} ssd;
+
+static bool log_cmds = false; // Print the command bytes
+static bool changed = false;  // GDDRAM changed since the last dump
+
+/**
+ * @brief Returns the number of arguments of an SSD1306 command.
+ */
+static uint8_t cmd_args(uint8_t cmd)
+{
+	switch (cmd) {
+	case 0x20: case 0x81: case 0x8D: case 0xA8:
+	case 0xD3: case 0xD5: case 0xD9: case 0xDA: case 0xDB:
+		return 1;
+	case 0x21: case 0x22:
+		return 2;
+	default:
+		return 0;
+	}
+}
+
+/**
+ * @brief Passes a command byte to the emulated SSD1306.
+ */
+static void ssd_cmd(uint8_t b)
+{
+	if (log_cmds)
+		printf(" %02X", b);
+
+	if (!ssd.nargs) {
+		ssd.cmd = b;
+		ssd.nargs = cmd_args(b);
+		return;
+	}
+
+	if (--ssd.nargs) {
+		ssd.arg0 = b;
+		return;
+	}
+
+	switch (ssd.cmd) {
+	case 0x21:
+		ssd.col = ssd.col0 = ssd.arg0 & 0x7F;
+		ssd.col1 = b & 0x7F;
+		break;
+	case 0x22:
+		ssd.page = ssd.page0 = ssd.arg0 & 7;
+		ssd.page1 = b & 7;
+		break;
+	}
+}
+
+/**
+ * @brief Passes a data byte to the emulated SSD1306.
+ */
+static void ssd_data(uint8_t b)
+{
+	if (ssd.page < SSD1306_PAGES && ssd.ram[ssd.page][ssd.col] != b) {
+		ssd.ram[ssd.page][ssd.col] = b;
+		changed = true;
+	}
+
+	if (ssd.col++ < ssd.col1)
+		return;
+
+	ssd.col = ssd.col0;
+	ssd.page = ssd.page < ssd.page1 ? ssd.page + 1 : ssd.page0;
+}
+
+/**
+ * @brief Receives the transmissions of the TWI stand-in.
+ */
+static void twi_sink(uint8_t addr, uint8_t ctrl, const uint8_t *data, uint8_t len)
+{
+	if (addr != OLED_I2C_ADDRESS)
+		return;
+
+	for (uint8_t i = 0; i < len; i++) {
+		if (ctrl == 0x40)
+			ssd_data(data[i]);
+		else
+			ssd_cmd(data[i]);
+	}
+}
+
+/**
+ * @brief Prints the GDDRAM if it changed, one line per page.
+ */
+static void dump(const char *scene)
+{
+	if (!changed)
+		return;
+
+	printf("%s:\n", scene);
+	for (uint8_t p = 0; p < SSD1306_PAGES; p++) {
+		for (uint8_t x = 0; x < OLED_WIDTH; x++)
+			printf("%02X", ssd.ram[p][x]);
+		printf("\n");
+	}
+
+	changed = false;
+}
+
+static Display *display;
+
+#ifdef BASELINE
+
+/**
+ * @brief Initializes the baseline's display with the title composed by its main.cpp.
+ */
+static void display_begin()
+{
+	display = new Display(String(FW_NAME) + " v" + String(FW_REVISION) + "\n" + String(FW_AUTHORS));
+}
+
+/**
+ * @brief Sends a complete frame, and prints the GDDRAM.
+ */
+static void frame(const char *scene)
+{
+	display->update();
+	dump(scene);
+}
+
+#else
+
+/**
+ * @brief Initializes the display.
+ */
+static void display_begin()
+{
+	static Display d;
+	display = &d;
+	display->begin();
+}
+
+/**
+ * @brief Sends a complete frame, and prints the GDDRAM.
+ */
+static void frame(const char *scene)
+{
+	display->update();
+	do
+		display->flush();
+	while (display->flushing());
+
+	dump(scene);
+}
+
+/**
+ * @brief Runs the pages the baseline firmware did not have.
+ */
+static void extended_scenes()
+{
+	display->set_n_leds(144);
+	display->set_rgb(255, 128, 0);
+	display->set_frame_time(4620, 4400);
+	frame("frame time");
+	display->set_frame_time(0, 0);
+
+	display->set_window(10, 20);
+	display->set_rgb(0, 0, 0);
+	frame("window");
+
+	display->set_window(0, 0);
+	display->show_hsv(true);
+	display->set_hsv(720, 200, 99);
+	display->set_rgb(99, 50, 22);
+	frame("hsv");
+	display->show_hsv(false);
+
+	display->show_stress(true);
+	display->set_stress(214, 4673);
+	frame("stress");
+	display->show_stress(false);
+
+	display->show_bisect(true);
+	display->set_bisect(1024, 65535);
+	frame("bisect");
+	display->show_bisect(false);
+
+	display->show_reset_test(true);
+	display->set_reset_test(280);
+	frame("reset test");
+	display->show_reset_test(false);
+
+	display->show_stream(true);
+	frame("stream");
+	display->show_stream(false);
+
+	display->set_n_leds(1234567);
+	display->show_diagnostics(true);
+	display->set_mem_stats(432, 611);
+	frame("diagnostics");
+	display->show_diagnostics(false);
+}
+
+/**
+ * @brief Returns if an option was passed on the command line.
+ */
+static bool has_option(int argc, char *argv[], const char *opt)
+{
+	for (int i = 1; i < argc; i++)
+		if (!strcmp(argv[i], opt))
+			return true;
+
+	return false;
+}
+
+/**
+ * @brief Prints the render time of both ways of drawing the main page (See Display::benchmark()).
+ */
+static int bench()
+{
+	display_begin();
+	display->set_n_leds(144);
+	display->set_rgb(255, 128, 0);
+
+	unsigned long sprites_us = display->benchmark(false, BENCH_REDRAWS);
+	unsigned long gfx_us = display->benchmark(true, BENCH_REDRAWS);
+	printf("Sprites: %lu us, GFX: %lu us per redraw (host)\n", sprites_us, gfx_us);
+
+	return 0;
+}
+
+#endif
+
+int main(int argc, char *argv[])
+{
+#ifndef BASELINE
+	if (has_option(argc, argv, "--bench"))
+		return bench();
+#endif
+
+	shim_clock_set(0);
+	shim_twi_sink(twi_sink);
+
+	printf("init:");
+	log_cmds = true;
+	display_begin();
+	log_cmds = false;
+	printf("\n");
+
+#ifndef BASELINE
+	display->set_gfx_text(has_option(argc, argv, "--gfx"));
+#endif
+
+	display->set_n_leds(144);
+	display->set_rgb(255, 128, 0);
+	frame("main");
+
+	display->set_n_leds(0);
+	display->set_rgb(0, 0, 0);
+	frame("main");
+
+	display->set_n_leds(9999);
+	display->set_rgb(7, 42, 199);
+	frame("main");
+
+#ifndef BASELINE
+	if (!has_option(argc, argv, "--baseline"))
+		extended_scenes();
+#endif
+
+	display->start_screensaver();
+	for (unsigned i = 0; i < SAVER_STEPS; i++) {
+		shim_clock_set(i * SAVER_STEP_MS * 1000UL);
+		frame("screensaver");
+	}
+	display->stop_screensaver();
+	frame("main");
+
+	return 0;
+}
@@ -0,0 +1,117 @@
+/*
+ * Copyright (C) 2022 Patrick Pedersen, TU-DO Makerspace
+
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * @file hsv_test.cpp
+ * @author Patrick Pedersen
+ *
+ * @brief Host test of the integer HSV to RGB conversion (See Hsv.h).
+ *
+ * The following test sweeps all hues, and saturations and values in
+ * steps of HSV_TEST_STEP (plus 255), and compares each channel of
+ * hsv_to_rgb() against the floating-point conversion. The test fails
+ * if any channel is off by more than HSV_MAX_ERR steps.
+ *
+ */
+
+#include <math.h>
+#include <stdio.h>
+
+#include <Hsv.h>
+
+#define HSV_MAX_ERR 2   // Max. error per channel (See hsv_to_rgb())
+#define HSV_TEST_STEP 5 // Step of the saturation and value sweep
+
+/**
+ * @brief Floating-point HSV to RGB conversion.
+ *
+ * @param h Hue (0 to HSV_HUE_MAX-1, HSV_HUE_MAX / 6 per sextant).
+ * @param s Saturation (0-255).
+ * @param v Value (0-255).
+ * @param rgb Receives the red, green and blue value (0-255, unrounded).
+ *
+ */
+void hsv_to_rgb_ref(uint16_t h, uint8_t s, uint8_t v, double rgb[3])
+{
+	double sext = h / (HSV_HUE_MAX / 6.0);
+	int i = (int) sext;
+	double f = sext - i;
+	double sat = s / 255.0;
+	double val = v;
+
+	double p = val * (1 - sat);
+	double q = val * (1 - sat * f);
+	double t = val * (1 - sat * (1 - f));
+
+	const double table[6][3] = {
+		{val, t, p}, {q, val, p}, {p, val, t},
+		{p, q, val}, {t, p, val}, {val, p, q}
+	};
+
+	for (int c = 0; c < 3; c++)
+		rgb[c] = table[i][c];
+}
+
+/**
+ * @brief Returns the next value of a sweep from 0 to 255.
+ */
+unsigned next_step(unsigned x)
+{
+	return (x < 255 && x + HSV_TEST_STEP > 255) ? 255 : x + HSV_TEST_STEP;
+}
+
+int main()
+{
+	static const char names[] = "RGB";
+	double max_err[3] = {0, 0, 0};
+	unsigned long n = 0, fails = 0;
+
+	for (unsigned h = 0; h < HSV_HUE_MAX; h++) {
+		for (unsigned s = 0; s <= 255; s = next_step(s)) {
+			for (unsigned v = 0; v <= 255; v = next_step(v)) {
+				uint8_t out[3];
+				double ref[3];
+
+				hsv_to_rgb(h, s, v, out[0], out[1], out[2]);
+				hsv_to_rgb_ref(h, s, v, ref);
+				n++;
+
+				for (int c = 0; c < 3; c++) {
+					double err = fabs(out[c] - ref[c]);
+					if (err > max_err[c])
+						max_err[c] = err;
+
+					if (err > HSV_MAX_ERR && fails++ < 10)
+						printf("h=%u s=%u v=%u: %c=%u, expected %.2f\n",
+						       h, s, v, names[c], out[c], ref[c]);
+				}
+			}
+		}
+	}
+
+	printf("hsv_to_rgb: %lu colors, max. error R %.2f G %.2f B %.2f (limit %d)\n",
+	       n, max_err[0], max_err[1], max_err[2], HSV_MAX_ERR);
+
+	if (fails) {
+		printf("FAIL: %lu channels off by more than %d\n", fails, HSV_MAX_ERR);
+		return 1;
+	}
+
+	printf("PASS\n");
+	return 0;
+}
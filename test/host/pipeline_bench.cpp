@@ -0,0 +1,112 @@
+/*
+ * Copyright (C) 2022 Patrick Pedersen, TU-DO Makerspace
+
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * @file pipeline_bench.cpp
+ * @author Patrick Pedersen
+ *
+ * @brief Host benchmark of the pixel pipeline (See Pipeline.h).
+ *
+ * The following benchmark computes BENCH_PIXELS pixels through each
+ * combination of a generator and a stage chain, the way tx_pixels() in
+ * Strip.cpp does, and prints the time and host cycles (x86 TSC) per
+ * pixel. The stage chains are the one configured for the strip
+ * (StripStages), and one with all stages enabled. The results are
+ * host results: They compare generators and stages, the tester's
+ * cycle counts differ. For reference, the tester has 480 cycles per
+ * RGB LED at 800 kHz (16 MHz).
+ *
+ */
+
+#include <stdio.h>
+#include <time.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define HAVE_TSC
+#endif
+
+#include <config.h>
+#include <Pipeline.h>
+
+#define BENCH_PIXELS (1UL << 24) // Pixels per benchmark
+
+typedef PixelStages<Gamma<STRIP_GAMMA>, Dim<STRIP_MAX_LEVEL>, Order<WS2812_COLOR_ORDER>> StripStages;
+typedef PixelStages<Gamma<true>, Dim<128>, Order<grb>> AllStages;
+
+/**
+ * @brief Returns the time of the monotonic clock in ns.
+ */
+static unsigned long long now_ns()
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+/**
+ * @brief Returns the host's cycle counter, or 0 if there is none.
+ */
+static unsigned long long now_cycles()
+{
+#ifdef HAVE_TSC
+	return __rdtsc();
+#else
+	return 0;
+#endif
+}
+
+/**
+ * @brief Computes BENCH_PIXELS pixels through a pipeline and prints the time per pixel.
+ *
+ * @param name The name of the pipeline.
+ * @param pipe The pipeline.
+ *
+ */
+template <typename Pipe>
+static void bench(const char *name, Pipe pipe)
+{
+	ws2812_rgb px;
+	uint32_t sum = 0; // Keeps the pixels from being optimized away
+
+	unsigned long long t0 = now_ns();
+	unsigned long long c0 = now_cycles();
+
+	for (unsigned long i = 0; i < BENCH_PIXELS; i++) {
+		pipe.next(px);
+		sum = sum * 31 + (px.r | px.g << 8 | px.b << 16);
+	}
+
+	unsigned long long c1 = now_cycles();
+	unsigned long long t1 = now_ns();
+
+	printf("%-28s %6.2f ns %7.1f cycles per pixel (sum %08x)\n", name,
+	       (double) (t1 - t0) / BENCH_PIXELS, (double) (c1 - c0) / BENCH_PIXELS, sum);
+}
+
+int main()
+{
+	const ws2812_rgb color = {200, 100, 50};
+
+	bench("Solid, StripStages", PixelPipeline<SolidGen, StripStages>(SolidGen{color}));
+	bench("Solid, all stages", PixelPipeline<SolidGen, AllStages>(SolidGen{color}));
+	bench("Rainbow, StripStages", PixelPipeline<RainbowGen, StripStages>(RainbowGen{0, 7, 255, 255}));
+	bench("Rainbow, all stages", PixelPipeline<RainbowGen, AllStages>(RainbowGen{0, 7, 255, 255}));
+
+	return 0;
+}
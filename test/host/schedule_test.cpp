@@ -0,0 +1,330 @@
+/*
+ * Copyright (C) 2022 Patrick Pedersen, TU-DO Makerspace
+
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * @file schedule_test.cpp
+ * @author Patrick Pedersen
+ *
+ * @brief Host test of the boot order and of the strip/display scheduling.
+ *
+ * The following test runs the firmware's setup() and loop() (See
+ * main.cpp) on top of the host shim, and records when strip frames
+ * are sent and when display pages are transmitted over I2C.
+ *
+ * Time is simulated (See shim_clock_step()): The clock advances by
+ * STEP_US on every reading, strip frames take as long as on the wire,
+ * and I2C transmissions take as long as at OLED_I2C_CLOCK. The time the
+ * tester spends computing isn't simulated, so the times below are a
+ * lower bound, but the order of the events is the firmware's.
+ *
+ * The test checks that:
+ *  - The first strip frame has been sent before the display is
+ *    initialized. The boot timeline of DEBUG_BOOT_TIMELINE is printed.
+ *  - No strip frame is started while a display page is in flight, as
+ *    the frame would hold off the TWI interrupt.
+ *  - While the strip is refreshed continuously (rainbow) and the display
+ *    is redrawn (pots turned every POT_STEP_MS), a frame waits at most
+ *    for the one display page in flight once the strip has latched.
+ *
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <Arduino.h>
+#include <Shim.h>
+#include <config.h>
+#include <Strip.h>
+#include <MemMonitor.h>
+#include <Log.h>
+
+#define STEP_US 1             // Clock advance per reading (See shim_clock_step())
+#define ADC_CONVERSION_US 104 // ADC conversion time at a 125 kHz ADC clock (13 cycles)
+#define SCENE_MS 2000         // Simulated time per scene
+#define SCENE_LEDS 100        // LEDs of the strip during the scenes
+#define POT_STEP_MS 100       // Time between pot changes in the live display scene
+#define PAGE_US ((OLED_WIDTH + 2) * 9 * 1000000UL / OLED_I2C_CLOCK) // Time to send a display page
+#define WAIT_SLACK_US 500     // Allowed wait beyond PAGE_US, the clock readings of the loop (See STEP_US)
+
+extern Strip strip;
+void setup();
+void loop();
+
+// The stack scan relies on the tester's memory layout, it isn't run on the host
+void MemMonitor::update() {}
+uint16_t MemMonitor::max_stack() { return 0; }
+uint16_t MemMonitor::min_free() { return 0; }
+uint16_t MemMonitor::free_now() { return 0; }
+
+static int host_fd; // Host end of the serial port
+
+/**
+ * @brief Events recorded during a scene.
+ */
+static struct {
+	unsigned long frames;      // Frames sent
+	unsigned long aborted;     // Frames started, but not sent
+	unsigned long pages;       // Display pages sent
+	unsigned long twi_overlap; // Frames started while a display page was in flight
+	unsigned long max_wait_us; // Longest wait of a frame once the strip had latched
+	uint8_t max_pages_between; // Most display pages sent between two frames
+
+	unsigned long latch_us;    // Time the strip latches the last frame
+	uint8_t pages_between;     // Display pages sent since the last frame
+	bool open;                 // A frame is being sent
+	bool frame_sent;           // A frame has been sent since the start of the scene
+} rec;
+
+static unsigned long boot_frame_us = 0; // Time the first frame has been sent
+static unsigned long boot_twi = 0;      // I2C transmissions before the first frame had been sent
+static bool booted = false;             // The first frame has been sent
+
+/**
+ * @brief Records the frames sent by the strip (See shim_frame_sink()).
+ */
+static void frame_sink(bool open)
+{
+	unsigned long now = micros();
+
+	if (open) {
+		if (rec.open)
+			rec.aborted++;
+
+		if (shim_twi_remaining())
+			rec.twi_overlap++;
+
+		// The strip is refreshed back to back, so each frame is pending once the previous has latched
+		if (rec.frame_sent && now - rec.latch_us > rec.max_wait_us && now > rec.latch_us)
+			rec.max_wait_us = now - rec.latch_us;
+
+		rec.open = true;
+		return;
+	}
+
+	rec.open = false;
+	rec.frames++;
+	rec.frame_sent = true;
+	rec.latch_us = now + strip.get_reset_time();
+
+	if (rec.pages_between > rec.max_pages_between)
+		rec.max_pages_between = rec.pages_between;
+	rec.pages_between = 0;
+
+	if (!booted) {
+		booted = true;
+		boot_frame_us = now;
+	}
+}
+
+/**
+ * @brief Records the I2C transmissions to the display (See shim_twi_sink()).
+ */
+static void twi_sink(uint8_t addr, uint8_t ctrl, const uint8_t *data, uint8_t len)
+{
+	if (!booted)
+		boot_twi++;
+
+	if (ctrl == 0x40) {
+		rec.pages++;
+		rec.pages_between++;
+	}
+}
+
+/**
+ * @brief Stands in for the ADC, which samples the pots continuously.
+ *
+ * The following function completes as many conversions as the
+ * ADC would have completed since the last call (See shim_adc_convert()).
+ *
+ */
+static void sample_pots()
+{
+	static unsigned long adc_tstamp = 0;
+	unsigned long n = (micros() - adc_tstamp) / ADC_CONVERSION_US;
+
+	adc_tstamp += n * ADC_CONVERSION_US;
+	while (n--)
+		shim_adc_convert();
+}
+
+/**
+ * @brief Prints the serial output of the firmware, and returns the last line.
+ *
+ * @param print Print the lines, rather than discarding them.
+ * @return const char* The last line received, empty if none has been.
+ *
+ */
+static const char *serial_lines(bool print)
+{
+	static char line[128];
+	static uint8_t len = 0;
+	static char last[128];
+	static uint8_t rec_pos = 0, rec_len = 0; // Position in a log record (See Log.h)
+
+	last[0] = '\0';
+
+	uint8_t c;
+	while (read(host_fd, &c, 1) == 1) {
+		// Skip the binary log records
+		if (rec_pos || c == LOG_SYNC) {
+			if (++rec_pos == 3)
+				rec_len = c;
+			if (rec_pos >= 3 && rec_pos == 3 + rec_len)
+				rec_pos = 0;
+			continue;
+		}
+
+		if (c == '\r')
+			continue;
+
+		if (c != '\n') {
+			if (len < sizeof(line) - 1)
+				line[len++] = c;
+			continue;
+		}
+
+		line[len] = '\0';
+		len = 0;
+
+		if (print)
+			printf("  %s\n", line);
+		strcpy(last, line);
+	}
+
+	return last;
+}
+
+/**
+ * @brief Sends a serial command and runs the loop until it has been answered.
+ *
+ * @param cmd The command.
+ * @return bool True if the command has been answered with "ok".
+ *
+ */
+static bool command(const char *cmd)
+{
+	char buf[64];
+	snprintf(buf, sizeof(buf), "%s\n", cmd);
+	if (write(host_fd, buf, strlen(buf)) < 0)
+		return false;
+
+	unsigned long start = millis();
+	while (millis() - start < 1000) {
+		sample_pots();
+		loop();
+
+		const char *reply = serial_lines(false);
+		if (strcmp(reply, "ok") == 0)
+			return true;
+		if (strcmp(reply, "err") == 0)
+			return false;
+	}
+
+	return false;
+}
+
+/**
+ * @brief Runs the loop for SCENE_MS and checks the recorded events.
+ *
+ * @param name The name of the scene.
+ * @param turn_pots Turn a pot every POT_STEP_MS, so the display is redrawn.
+ * @return bool True if the scene has passed.
+ *
+ */
+static bool scene(const char *name, bool turn_pots)
+{
+	memset(&rec, 0, sizeof(rec));
+
+	unsigned long start = millis();
+	unsigned long pot_tstamp = start;
+	uint16_t pot = 0;
+
+	while (millis() - start < SCENE_MS) {
+		if (turn_pots && millis() - pot_tstamp >= POT_STEP_MS) {
+			pot_tstamp = millis();
+			pot = (pot + 97) % 1024;
+			shim_set_pot(POT_R, pot);
+		}
+
+		sample_pots();
+		loop();
+		serial_lines(false);
+	}
+
+	printf("%s: %lu frames (%lu fps), %lu aborted, %lu display pages\n", name,
+	       rec.frames, rec.frames * 1000 / SCENE_MS, rec.aborted, rec.pages);
+	printf("  frames started during a page: %lu, max. pages between frames: %u\n",
+	       rec.twi_overlap, rec.max_pages_between);
+	printf("  max. wait of a frame once latched: %lu us (page: %lu us)\n",
+	       rec.max_wait_us, PAGE_US);
+
+	bool pass = rec.frames > 0 && rec.twi_overlap == 0 && rec.max_pages_between <= 1 &&
+		    rec.max_wait_us <= PAGE_US + WAIT_SLACK_US && (!turn_pots || rec.pages > 0);
+
+	printf("  %s\n", pass ? "PASS" : "FAIL");
+	return pass;
+}
+
+int main()
+{
+	int fds[2];
+	if (socketpair(AF_UNIX, SOCK_STREAM, 0, fds) != 0) {
+		perror("Failed to open the serial port");
+		return 1;
+	}
+
+	fcntl(fds[0], F_SETFL, fcntl(fds[0], F_GETFL) | O_NONBLOCK);
+	fcntl(fds[1], F_SETFL, fcntl(fds[1], F_GETFL) | O_NONBLOCK);
+	Serial.attach(fds[0]);
+	host_fd = fds[1];
+
+	shim_clock_set(0);
+	shim_clock_step(STEP_US);
+	shim_twi_timed(true);
+	shim_frame_sink(frame_sink);
+	shim_twi_sink(twi_sink);
+
+	shim_set_pot(POT_R, 512);
+	shim_set_pot(POT_G, 256);
+	shim_set_pot(POT_B, 768);
+
+	printf("boot:\n");
+	setup();
+	serial_lines(true);
+
+	bool pass = booted && boot_twi == 0;
+	printf("  first frame sent at %lu us, %lu I2C transmissions before, setup() done at %lu us\n",
+	       boot_frame_us, boot_twi, micros());
+	printf("  %s\n", pass ? "PASS" : "FAIL");
+
+	char cmd[32];
+	snprintf(cmd, sizeof(cmd), "leds %u", SCENE_LEDS);
+	if (!command(cmd) || !command("color rainbow")) {
+		printf("Failed to set up the strip\n");
+		return 1;
+	}
+
+	pass = scene("rainbow", false) && pass;
+	pass = scene("rainbow, live display", true) && pass;
+
+	printf("%s\n", pass ? "PASS" : "FAIL");
+	return pass ? 0 : 1;
+}
@@ -0,0 +1,258 @@
+/*
+ * Copyright (C) 2022 Patrick Pedersen, TU-DO Makerspace
+
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * @file Link.cpp
+ * @author Patrick Pedersen
+ *
+ * @brief Pipelines serial commands to a tester.
+ *
+ * The following file contains the function definitions for the TesterLink
+ * class. See the Link.h file for more information.
+ *
+ */
+
+#include "Link.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <termios.h>
+#include <unistd.h>
+
+#define LOG_SYNC 0xFF             // First byte of a binary log record (See Log.h in the firmware)
+#define RESYNC_QUIET_US 100000UL  // Time (us) without data after which a lost link is in sync again
+
+/**
+ * @brief Returns the termios speed of a baud rate.
+ *
+ * @param baud The baud rate.
+ * @return speed_t The termios speed, or B0 if the baud rate isn't supported.
+ *
+ */
+static speed_t termios_speed(unsigned long baud)
+{
+	switch (baud) {
+	case 9600: return B9600;
+	case 19200: return B19200;
+	case 38400: return B38400;
+	case 57600: return B57600;
+	case 115200: return B115200;
+	case 230400: return B230400;
+	case 500000: return B500000;
+	case 1000000: return B1000000;
+	default: return B0;
+	}
+}
+
+// See header file for documentation.
+TesterLink::TesterLink(const std::string &path, unsigned int window, unsigned int window_bytes)
+: path(path), window(window), window_bytes(window_bytes)
+{
+}
+
+// See header file for documentation.
+TesterLink::~TesterLink()
+{
+	if (fd >= 0)
+		close(fd);
+}
+
+// See header file for documentation.
+bool TesterLink::open(unsigned long baud)
+{
+	speed_t speed = termios_speed(baud);
+	if (speed == B0) {
+		errno = EINVAL;
+		return false;
+	}
+
+	fd = ::open(path.c_str(), O_RDWR | O_NOCTTY | O_NONBLOCK);
+	if (fd < 0)
+		return false;
+
+	struct termios tio;
+	if (tcgetattr(fd, &tio) != 0) {
+		close(fd);
+		fd = -1;
+		return false;
+	}
+
+	cfmakeraw(&tio);
+	cfsetispeed(&tio, speed);
+	cfsetospeed(&tio, speed);
+	tio.c_cflag |= CLOCAL | CREAD;
+	tcsetattr(fd, TCSANOW, &tio);
+	tcflush(fd, TCIOFLUSH);
+
+	return true;
+}
+
+// See header file for documentation.
+bool TesterLink::can_send(const std::string &cmd)
+{
+	if (resyncing || in_flight.size() >= window)
+		return false;
+
+	// A command that exceeds the byte window on its own is sent alone
+	return in_flight.empty() || in_flight_bytes + cmd.size() + 1 <= window_bytes;
+}
+
+// See header file for documentation.
+bool TesterLink::send(const std::string &cmd, unsigned long now_us)
+{
+	std::string data = cmd + "\n";
+	size_t sent = 0;
+
+	while (sent < data.size()) {
+		ssize_t ret = ::write(fd, data.data() + sent, data.size() - sent);
+
+		if (ret > 0)
+			sent += ret;
+		else if (ret < 0 && errno != EAGAIN && errno != EINTR)
+			return false;
+	}
+
+	in_flight.push_back({cmd, now_us, ""});
+	in_flight_bytes += data.size();
+	return true;
+}
+
+// See header file for documentation.
+void TesterLink::receive(uint8_t c, unsigned long now_us, std::vector<Reply> &replies)
+{
+	// Skip log records: sync, id, length, payload
+	if (log_hdr) {
+		if (log_hdr++ == 2)
+			log_skip = c;
+		if (log_hdr == 3) {
+			log_hdr = 0;
+			log_records++;
+		}
+		return;
+	}
+
+	if (log_skip) {
+		log_skip--;
+		return;
+	}
+
+	if (c == LOG_SYNC) {
+		log_hdr = 1;
+		return;
+	}
+
+	if (c == '\r')
+		return;
+
+	if (c != '\n') {
+		line += (char) c;
+		return;
+	}
+
+	bool ok = (line == "ok");
+	if ((ok || line == "err") && !in_flight.empty()) {
+		InFlight &f = in_flight.front();
+		replies.push_back({f.cmd, ok, false, now_us - f.sent_us, f.output});
+		in_flight_bytes -= f.cmd.size() + 1;
+		in_flight.pop_front();
+	} else if (!in_flight.empty()) {
+		in_flight.front().output += line + "\n";
+	}
+
+	line.clear();
+}
+
+// See header file for documentation.
+bool TesterLink::read(unsigned long now_us, std::vector<Reply> &replies)
+{
+	uint8_t buf[256];
+
+	for (;;) {
+		ssize_t n = ::read(fd, buf, sizeof(buf));
+
+		if (n == 0)
+			return false;
+
+		if (n < 0)
+			return errno == EAGAIN || errno == EINTR;
+
+		rx_us = now_us;
+
+		// Data received while resyncing belongs to lost commands
+		if (resyncing)
+			continue;
+
+		for (ssize_t i = 0; i < n; i++)
+			receive(buf[i], now_us, replies);
+	}
+}
+
+// See header file for documentation.
+void TesterLink::expire(unsigned long now_us, unsigned long timeout_us, std::vector<Reply> &replies)
+{
+	if (resyncing) {
+		if (now_us - rx_us >= RESYNC_QUIET_US) {
+			resyncing = false;
+			line.clear();
+			log_hdr = 0;
+			log_skip = 0;
+		}
+		return;
+	}
+
+	if (in_flight.empty() || now_us - in_flight.front().sent_us < timeout_us)
+		return;
+
+	for (const InFlight &f : in_flight)
+		replies.push_back({f.cmd, false, true, now_us - f.sent_us, f.output});
+
+	in_flight.clear();
+	in_flight_bytes = 0;
+	resync(now_us);
+}
+
+// See header file for documentation.
+void TesterLink::resync(unsigned long now_us)
+{
+	resyncing = true;
+	rx_us = now_us;
+}
+
+// See header file for documentation.
+size_t TesterLink::pending()
+{
+	return in_flight.size();
+}
+
+// See header file for documentation.
+unsigned long TesterLink::logs()
+{
+	return log_records;
+}
+
+// See header file for documentation.
+int TesterLink::get_fd()
+{
+	return fd;
+}
+
+// See header file for documentation.
+const std::string &TesterLink::get_path()
+{
+	return path;
+}
@@ -0,0 +1,203 @@
+/*
+ * Copyright (C) 2022 Patrick Pedersen, TU-DO Makerspace
+
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * @file Link.h
+ * @author Patrick Pedersen
+ *
+ * @brief Provides the TesterLink class.
+ *
+ * The following file provides the TesterLink class, which pipelines
+ * serial commands to a tester.
+ *
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+#include <deque>
+#include <string>
+#include <vector>
+
+/**
+ * @brief The outcome of a command.
+ */
+struct Reply {
+	std::string cmd;          /// The command line
+	bool ok;                  /// The tester has answered "ok"
+	bool lost;                /// No answer has been received in time (See TesterLink::expire())
+	unsigned long latency_us; /// Time (us) from sending the command to its answer
+	std::string output;       /// Text printed by the command before its answer
+};
+
+/**
+ * @brief Pipelines serial commands to a tester.
+ *
+ * The tester answers every command line with "ok" or "err", in order
+ * (See SerialCmd in the firmware). Rather than waiting for each answer
+ * before sending the next command, up to a window of commands is kept
+ * in flight, and answers are matched to the oldest command in flight.
+ * The window is limited in commands and bytes, the latter must not
+ * exceed the tester's serial receive buffer (64 bytes on the Nano).
+ *
+ * Text printed by a command is collected as its output, binary log
+ * records (See Log.h in the firmware) are skipped. If no answer arrives
+ * in time, all commands in flight are reported as lost, and the link
+ * waits for the tester to go quiet before it accepts new commands, so
+ * late answers aren't matched to the wrong commands (See resync()).
+ */
+class TesterLink
+{
+private:
+	struct InFlight {
+		std::string cmd;
+		unsigned long sent_us;
+		std::string output;
+	};
+
+	std::string path;
+	int fd = -1;
+	unsigned int window;
+	unsigned int window_bytes;
+	std::deque<InFlight> in_flight;
+	unsigned int in_flight_bytes = 0;
+
+	std::string line;              // Text line being received
+	uint8_t log_hdr = 0;           // Bytes of the current log record's header received
+	uint8_t log_skip = 0;          // Payload bytes of the current log record left to skip
+	unsigned long log_records = 0; // Log records received
+	bool resyncing = false;        // Waiting for the tester to go quiet (See expire())
+	unsigned long rx_us = 0;       // Time (us) the last byte has been received
+
+	/**
+	 * @brief Handles a received byte.
+	 *
+	 * @param c The byte.
+	 * @param now_us The current time (us).
+	 * @param replies Receives the replies completed by the byte.
+	 *
+	 */
+	void receive(uint8_t c, unsigned long now_us, std::vector<Reply> &replies);
+
+public:
+	/**
+	 * @brief Constructor.
+	 *
+	 * @param path The path of the tester's serial port.
+	 * @param window Max. number of commands in flight.
+	 * @param window_bytes Max. number of bytes in flight.
+	 *
+	 */
+	TesterLink(const std::string &path, unsigned int window, unsigned int window_bytes);
+
+	~TesterLink();
+
+	/**
+	 * @brief Opens the serial port.
+	 *
+	 * @param baud The baud rate of the tester (SERIAL_BAUD).
+	 * @return bool True if the port has been opened, false otherwise (See errno).
+	 *
+	 */
+	bool open(unsigned long baud);
+
+	/**
+	 * @brief Returns if a command can be sent without exceeding the window.
+	 *
+	 * @param cmd The command line, without line ending.
+	 * @return bool True if the command fits into the window, false otherwise.
+	 *
+	 */
+	bool can_send(const std::string &cmd);
+
+	/**
+	 * @brief Sends a command.
+	 *
+	 * @param cmd The command line, without line ending.
+	 * @param now_us The current time (us).
+	 * @return bool True if the command has been sent, false on a write error.
+	 *
+	 */
+	bool send(const std::string &cmd, unsigned long now_us);
+
+	/**
+	 * @brief Reads and handles the received data.
+	 *
+	 * @param now_us The current time (us).
+	 * @param replies Receives the replies completed by the data.
+	 * @return bool True if the port is still open, false if it has been closed or failed.
+	 *
+	 */
+	bool read(unsigned long now_us, std::vector<Reply> &replies);
+
+	/**
+	 * @brief Reports the commands in flight as lost if their answer is overdue.
+	 *
+	 * @param now_us The current time (us).
+	 * @param timeout_us Max. time (us) to wait for the answer of the oldest command.
+	 * @param replies Receives the lost commands.
+	 *
+	 */
+	void expire(unsigned long now_us, unsigned long timeout_us, std::vector<Reply> &replies);
+
+	/**
+	 * @brief Discards the received data until the tester goes quiet.
+	 *
+	 * The following function is called once the port has been opened,
+	 * so leftovers of a previous session, such as the tail of a log
+	 * record, aren't mistaken for answers, and by expire(). No commands
+	 * can be sent meanwhile.
+	 *
+	 * @param now_us The current time (us).
+	 *
+	 */
+	void resync(unsigned long now_us);
+
+	/**
+	 * @brief Returns the number of commands in flight.
+	 *
+	 * @return size_t The number of commands waiting for an answer.
+	 *
+	 */
+	size_t pending();
+
+	/**
+	 * @brief Returns the number of log records skipped.
+	 *
+	 * @return unsigned long The number of binary log records received.
+	 *
+	 */
+	unsigned long logs();
+
+	/**
+	 * @brief Returns the file descriptor of the serial port, for poll().
+	 *
+	 * @return int The file descriptor, or -1 if the port isn't open.
+	 *
+	 */
+	int get_fd();
+
+	/**
+	 * @brief Returns the path of the serial port.
+	 *
+	 * @return const std::string& The path passed to the constructor.
+	 *
+	 */
+	const std::string &get_path();
+};
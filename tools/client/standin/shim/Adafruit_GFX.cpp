@@ -0,0 +1,282 @@
+/*
+ * Copyright (C) 2022 Patrick Pedersen, TU-DO Makerspace
+
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * @file Adafruit_GFX.cpp
+ * @author Patrick Pedersen
+ *
+ * @brief Host stand-in for the Adafruit GFX library.
+ *
+ * The following file implements the Adafruit_GFX stand-in, following
+ * the library's text rendering. See Adafruit_GFX.h for more information.
+ *
+ */
+
+#include <Adafruit_GFX.h>
+
+#define FONT_FIRST ' ' // First character of the font table
+#define FONT_LAST '~'  // Last character of the font table
+
+/**
+ * @brief Printable ASCII characters of the library's classic 5x7 font (glcdfont.c).
+ *
+ * One glyph per character, 5 columns each, top row in the LSB.
+ */
+static const uint8_t font[] = {
+	0x00, 0x00, 0x00, 0x00, 0x00, // ' '
+	0x00, 0x00, 0x5F, 0x00, 0x00, // '!'
+	0x00, 0x07, 0x00, 0x07, 0x00, // '"'
+	0x14, 0x7F, 0x14, 0x7F, 0x14, // '#'
+	0x24, 0x2A, 0x7F, 0x2A, 0x12, // '$'
+	0x23, 0x13, 0x08, 0x64, 0x62, // '%'
+	0x36, 0x49, 0x56, 0x20, 0x50, // '&'
+	0x00, 0x08, 0x07, 0x03, 0x00, // '\''
+	0x00, 0x1C, 0x22, 0x41, 0x00, // '('
+	0x00, 0x41, 0x22, 0x1C, 0x00, // ')'
+	0x2A, 0x1C, 0x7F, 0x1C, 0x2A, // '*'
+	0x08, 0x08, 0x3E, 0x08, 0x08, // '+'
+	0x00, 0x80, 0x70, 0x30, 0x00, // ','
+	0x08, 0x08, 0x08, 0x08, 0x08, // '-'
+	0x00, 0x00, 0x60, 0x60, 0x00, // '.'
+	0x20, 0x10, 0x08, 0x04, 0x02, // '/'
+	0x3E, 0x51, 0x49, 0x45, 0x3E, // '0'
+	0x00, 0x42, 0x7F, 0x40, 0x00, // '1'
+	0x72, 0x49, 0x49, 0x49, 0x46, // '2'
+	0x21, 0x41, 0x49, 0x4D, 0x33, // '3'
+	0x18, 0x14, 0x12, 0x7F, 0x10, // '4'
+	0x27, 0x45, 0x45, 0x45, 0x39, // '5'
+	0x3C, 0x4A, 0x49, 0x49, 0x31, // '6'
+	0x41, 0x21, 0x11, 0x09, 0x07, // '7'
+	0x36, 0x49, 0x49, 0x49, 0x36, // '8'
+	0x46, 0x49, 0x49, 0x29, 0x1E, // '9'
+	0x00, 0x00, 0x14, 0x00, 0x00, // ':'
+	0x00, 0x40, 0x34, 0x00, 0x00, // ';'
+	0x00, 0x08, 0x14, 0x22, 0x41, // '<'
+	0x14, 0x14, 0x14, 0x14, 0x14, // '='
+	0x00, 0x41, 0x22, 0x14, 0x08, // '>'
+	0x02, 0x01, 0x59, 0x09, 0x06, // '?'
+	0x3E, 0x41, 0x5D, 0x59, 0x4E, // '@'
+	0x7C, 0x12, 0x11, 0x12, 0x7C, // 'A'
+	0x7F, 0x49, 0x49, 0x49, 0x36, // 'B'
+	0x3E, 0x41, 0x41, 0x41, 0x22, // 'C'
+	0x7F, 0x41, 0x41, 0x41, 0x3E, // 'D'
+	0x7F, 0x49, 0x49, 0x49, 0x41, // 'E'
+	0x7F, 0x09, 0x09, 0x09, 0x01, // 'F'
+	0x3E, 0x41, 0x41, 0x51, 0x73, // 'G'
+	0x7F, 0x08, 0x08, 0x08, 0x7F, // 'H'
+	0x00, 0x41, 0x7F, 0x41, 0x00, // 'I'
+	0x20, 0x40, 0x41, 0x3F, 0x01, // 'J'
+	0x7F, 0x08, 0x14, 0x22, 0x41, // 'K'
+	0x7F, 0x40, 0x40, 0x40, 0x40, // 'L'
+	0x7F, 0x02, 0x1C, 0x02, 0x7F, // 'M'
+	0x7F, 0x04, 0x08, 0x10, 0x7F, // 'N'
+	0x3E, 0x41, 0x41, 0x41, 0x3E, // 'O'
+	0x7F, 0x09, 0x09, 0x09, 0x06, // 'P'
+	0x3E, 0x41, 0x51, 0x21, 0x5E, // 'Q'
+	0x7F, 0x09, 0x19, 0x29, 0x46, // 'R'
+	0x26, 0x49, 0x49, 0x49, 0x32, // 'S'
+	0x03, 0x01, 0x7F, 0x01, 0x03, // 'T'
+	0x3F, 0x40, 0x40, 0x40, 0x3F, // 'U'
+	0x1F, 0x20, 0x40, 0x20, 0x1F, // 'V'
+	0x3F, 0x40, 0x38, 0x40, 0x3F, // 'W'
+	0x63, 0x14, 0x08, 0x14, 0x63, // 'X'
+	0x03, 0x04, 0x78, 0x04, 0x03, // 'Y'
+	0x61, 0x59, 0x49, 0x4D, 0x43, // 'Z'
+	0x00, 0x7F, 0x41, 0x41, 0x41, // '['
+	0x02, 0x04, 0x08, 0x10, 0x20, // '\\'
+	0x00, 0x41, 0x41, 0x41, 0x7F, // ']'
+	0x04, 0x02, 0x01, 0x02, 0x04, // '^'
+	0x40, 0x40, 0x40, 0x40, 0x40, // '_'
+	0x00, 0x03, 0x07, 0x08, 0x00, // '`'
+	0x20, 0x54, 0x54, 0x78, 0x40, // 'a'
+	0x7F, 0x28, 0x44, 0x44, 0x38, // 'b'
+	0x38, 0x44, 0x44, 0x44, 0x28, // 'c'
+	0x38, 0x44, 0x44, 0x28, 0x7F, // 'd'
+	0x38, 0x54, 0x54, 0x54, 0x18, // 'e'
+	0x00, 0x08, 0x7E, 0x09, 0x02, // 'f'
+	0x18, 0xA4, 0xA4, 0x9C, 0x78, // 'g'
+	0x7F, 0x08, 0x04, 0x04, 0x78, // 'h'
+	0x00, 0x44, 0x7D, 0x40, 0x00, // 'i'
+	0x20, 0x40, 0x40, 0x3D, 0x00, // 'j'
+	0x7F, 0x10, 0x28, 0x44, 0x00, // 'k'
+	0x00, 0x41, 0x7F, 0x40, 0x00, // 'l'
+	0x7C, 0x04, 0x78, 0x04, 0x78, // 'm'
+	0x7C, 0x08, 0x04, 0x04, 0x78, // 'n'
+	0x38, 0x44, 0x44, 0x44, 0x38, // 'o'
+	0xFC, 0x18, 0x24, 0x24, 0x18, // 'p'
+	0x18, 0x24, 0x24, 0x18, 0xFC, // 'q'
+	0x7C, 0x08, 0x04, 0x04, 0x08, // 'r'
+	0x48, 0x54, 0x54, 0x54, 0x24, // 's'
+	0x04, 0x04, 0x3F, 0x44, 0x24, // 't'
+	0x3C, 0x40, 0x40, 0x20, 0x7C, // 'u'
+	0x1C, 0x20, 0x40, 0x20, 0x1C, // 'v'
+	0x3C, 0x40, 0x30, 0x40, 0x3C, // 'w'
+	0x44, 0x28, 0x10, 0x28, 0x44, // 'x'
+	0x4C, 0x90, 0x90, 0x90, 0x7C, // 'y'
+	0x44, 0x64, 0x54, 0x4C, 0x44, // 'z'
+	0x00, 0x08, 0x36, 0x41, 0x00, // '{'
+	0x00, 0x00, 0x77, 0x00, 0x00, // '|'
+	0x00, 0x41, 0x36, 0x08, 0x00, // '}'
+	0x02, 0x01, 0x02, 0x04, 0x02, // '~'
+};
+
+/**
+ * @brief Returns a column of a glyph of the classic font.
+ *
+ * @param c The character. Characters outside of the font table are blank.
+ * @param i The column (0-4).
+ * @return uint8_t The column, top row in the LSB.
+ *
+ */
+static uint8_t glyph_column(unsigned char c, uint8_t i)
+{
+	if (c < FONT_FIRST || c > FONT_LAST)
+		return 0;
+
+	return font[(c - FONT_FIRST) * 5 + i];
+}
+
+// See header file for documentation.
+Adafruit_GFX::Adafruit_GFX(int16_t w, int16_t h)
+: WIDTH(w), HEIGHT(h), _width(w), _height(h)
+{
+}
+
+// See header file for documentation.
+void Adafruit_GFX::fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color)
+{
+	for (int16_t i = x; i < x + w; i++)
+		for (int16_t j = y; j < y + h; j++)
+			drawPixel(i, j, color);
+}
+
+// See header file for documentation.
+void Adafruit_GFX::drawBitmap(int16_t x, int16_t y, const uint8_t bitmap[], int16_t w, int16_t h, uint16_t color)
+{
+	int16_t byte_w = (w + 7) / 8;
+
+	// Rows below the screen are skipped rather than read, as the
+	// bitmap may be shorter than the height it is drawn with
+	for (int16_t j = 0; j < h && y + j < _height; j++)
+		for (int16_t i = 0; i < w; i++)
+			if (pgm_read_byte(&bitmap[j * byte_w + i / 8]) & (0x80 >> (i & 7)))
+				drawPixel(x + i, y + j, color);
+}
+
+// See header file for documentation.
+void Adafruit_GFX::drawChar(int16_t x, int16_t y, unsigned char c, uint16_t color, uint16_t bg, uint8_t size_x, uint8_t size_y)
+{
+	if (x >= _width || y >= _height || x + 6 * size_x - 1 < 0 || y + 8 * size_y - 1 < 0)
+		return;
+
+	for (int8_t i = 0; i < 5; i++) {
+		uint8_t line = glyph_column(c, i);
+		for (int8_t j = 0; j < 8; j++, line >>= 1) {
+			if (line & 1) {
+				if (size_x == 1 && size_y == 1)
+					drawPixel(x + i, y + j, color);
+				else
+					fillRect(x + i * size_x, y + j * size_y, size_x, size_y, color);
+			} else if (bg != color) {
+				if (size_x == 1 && size_y == 1)
+					drawPixel(x + i, y + j, bg);
+				else
+					fillRect(x + i * size_x, y + j * size_y, size_x, size_y, bg);
+			}
+		}
+	}
+
+	// Spacing column
+	if (bg != color)
+		fillRect(x + 5 * size_x, y, size_x, 8 * size_y, bg);
+}
+
+// See header file for documentation.
+void Adafruit_GFX::setCursor(int16_t x, int16_t y)
+{
+	cursor_x = x;
+	cursor_y = y;
+}
+
+// See header file for documentation.
+void Adafruit_GFX::setTextSize(uint8_t s)
+{
+	textsize_x = textsize_y = (s > 0) ? s : 1;
+}
+
+// See header file for documentation.
+void Adafruit_GFX::setTextColor(uint16_t c)
+{
+	// Same colors: transparent background
+	textcolor = textbgcolor = c;
+}
+
+// See header file for documentation.
+void Adafruit_GFX::setTextColor(uint16_t c, uint16_t bg)
+{
+	textcolor = c;
+	textbgcolor = bg;
+}
+
+// See header file for documentation.
+void Adafruit_GFX::setTextWrap(bool w)
+{
+	wrap = w;
+}
+
+// See header file for documentation.
+int16_t Adafruit_GFX::getCursorX() const
+{
+	return cursor_x;
+}
+
+// See header file for documentation.
+int16_t Adafruit_GFX::getCursorY() const
+{
+	return cursor_y;
+}
+
+// See header file for documentation.
+int16_t Adafruit_GFX::width() const
+{
+	return _width;
+}
+
+// See header file for documentation.
+int16_t Adafruit_GFX::height() const
+{
+	return _height;
+}
+
+// See header file for documentation.
+size_t Adafruit_GFX::write(uint8_t c)
+{
+	if (c == '\n') {
+		cursor_x = 0;
+		cursor_y += textsize_y * 8;
+	} else if (c != '\r') {
+		if (wrap && cursor_x + textsize_x * 6 > _width) {
+			cursor_x = 0;
+			cursor_y += textsize_y * 8;
+		}
+		drawChar(cursor_x, cursor_y, c, textcolor, textbgcolor, textsize_x, textsize_y);
+		cursor_x += textsize_x * 6;
+	}
+
+	return 1;
+}
@@ -0,0 +1,72 @@
+/*
+ * Copyright (C) 2022 Patrick Pedersen, TU-DO Makerspace
+
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * @file Adafruit_GFX.h
+ * @author Patrick Pedersen
+ *
+ * @brief Host stand-in for the Adafruit GFX library.
+ *
+ * The following file provides the parts of Adafruit_GFX used by the
+ * PagedSSD1306 class (See PagedSSD1306.h) and by the Display class of
+ * earlier firmware revisions (See test/host): text printed through the
+ * classic 5x7 font, at any text size, with or without a background, and
+ * monochrome bitmaps. Like in the library, everything is drawn through
+ * drawPixel(). The font holds the printable ASCII characters of the
+ * library's font, other characters are drawn blank.
+ *
+ */
+
+#pragma once
+
+#include <Arduino.h>
+
+class Adafruit_GFX : public Print
+{
+protected:
+	const int16_t WIDTH, HEIGHT;
+	int16_t _width, _height;
+	int16_t cursor_x = 0, cursor_y = 0;
+	uint16_t textcolor = 0xFFFF, textbgcolor = 0xFFFF;
+	uint8_t textsize_x = 1, textsize_y = 1;
+	bool wrap = true;
+
+public:
+	Adafruit_GFX(int16_t w, int16_t h);
+	virtual ~Adafruit_GFX() {}
+
+	virtual void drawPixel(int16_t x, int16_t y, uint16_t color) = 0;
+	virtual void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color);
+
+	void drawBitmap(int16_t x, int16_t y, const uint8_t bitmap[], int16_t w, int16_t h, uint16_t color);
+	void drawChar(int16_t x, int16_t y, unsigned char c, uint16_t color, uint16_t bg, uint8_t size_x, uint8_t size_y);
+
+	void setCursor(int16_t x, int16_t y);
+	void setTextSize(uint8_t s);
+	void setTextColor(uint16_t c);
+	void setTextColor(uint16_t c, uint16_t bg);
+	void setTextWrap(bool w);
+
+	int16_t getCursorX() const;
+	int16_t getCursorY() const;
+	int16_t width() const;
+	int16_t height() const;
+
+	using Print::write;
+	size_t write(uint8_t c) override;
+};
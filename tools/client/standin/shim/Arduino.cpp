@@ -0,0 +1,575 @@
+/*
+ * Copyright (C) 2022 Patrick Pedersen, TU-DO Makerspace
+
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * @file Arduino.cpp
+ * @author Patrick Pedersen
+ *
+ * @brief Host stand-in for the Arduino core.
+ *
+ * The following file implements the Arduino core stand-in and the
+ * simulated hardware. See Arduino.h and Shim.h for more information.
+ *
+ */
+
+#include <deque>
+
+#include <Arduino.h>
+#include <Shim.h>
+#include <EEPROM.h>
+
+#include <errno.h>
+#include <poll.h>
+#include <sched.h>
+#include <stdio.h>
+#include <time.h>
+#include <unistd.h>
+
+HardwareSerial Serial;
+EEPROMClass EEPROM;
+
+volatile uint8_t SREG;
+volatile uint8_t PIND;
+volatile uint8_t TIFR1;
+volatile uint8_t TCCR1A;
+volatile uint8_t TCCR1B;
+volatile uint8_t TIMSK1;
+ShimUcsr0a UCSR0A;
+volatile uint8_t UCSR0B;
+volatile uint8_t UCSR0C;
+volatile uint16_t UBRR0;
+ShimUdr0 UDR0;
+volatile uint8_t ADMUX;
+ShimAdcsra ADCSRA;
+volatile uint16_t ADC;
+
+static uint16_t pots[4]; // Simulated pots on A0 to A3
+
+static bool clock_stopped = false; // Time is set by shim_clock_set()
+static unsigned long clock_set_us;
+static unsigned long clock_step_us;       // Advance per reading of the stopped clock (See shim_clock_step())
+static uint8_t adcsra;                    // Bits written to ADCSRA
+static uint32_t rand_state = 1;
+
+/**
+ * @brief Byte held by the simulated USART.
+ */
+struct UsartByte
+{
+	uint8_t c;
+	bool dor; // Bytes have been lost after this one
+};
+
+static int usart_fd = -1;                 // Pseudo terminal (See HardwareSerial::attach())
+static uint8_t usart_ctrl;                // Bits written to UCSR0A
+static bool usart_active = false;         // Receiver is enabled
+static std::deque<uint8_t> usart_wire;    // Bytes written by the host, still on the wire
+static std::deque<UsartByte> usart_rx;    // Bytes received, but not read from UDR0 yet
+static unsigned long long usart_wire_ns;  // Start of the next byte on the wire
+static bool usart_started;                // The next byte is being received
+static unsigned long usart_access_us;     // Last access of the USART registers
+
+extern "C" void ADC_vect(void) __attribute__((weak)); // Not linked into tests without ColorPots
+
+/**
+ * @brief Returns a clock in nanoseconds.
+ *
+ * @param id The clock.
+ * @return unsigned long long The time (ns).
+ *
+ */
+static unsigned long long clock_ns(clockid_t id)
+{
+	struct timespec ts;
+	clock_gettime(id, &ts);
+	return ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+/**
+ * @brief Returns the time since the first call in microseconds.
+ *
+ * While the USART is simulated (See avr/io.h), the time only advances
+ * while the stand-in runs, as the tester's USART would otherwise receive
+ * all bytes written by the host while the host deschedules the stand-in.
+ *
+ * @return unsigned long The time (us).
+ *
+ */
+static unsigned long clock_us()
+{
+	static unsigned long long wall_ns, cpu_ns, elapsed_ns;
+
+	if (clock_stopped)
+		return clock_set_us += clock_step_us;
+
+	unsigned long long wall = clock_ns(CLOCK_MONOTONIC);
+	unsigned long long cpu = clock_ns(CLOCK_THREAD_CPUTIME_ID);
+
+	if (wall_ns != 0 && (UCSR0B & _BV(RXEN0)))
+		elapsed_ns += min(cpu - cpu_ns, 10000ULL);
+	else if (wall_ns != 0)
+		elapsed_ns += wall - wall_ns;
+
+	wall_ns = wall;
+	cpu_ns = cpu;
+
+	return elapsed_ns / 1000;
+}
+
+/**
+ * @brief Moves the bytes that have arrived since the last call into the USART.
+ *
+ * The host writes bytes into the pseudo terminal at once, so bytes found
+ * on an idle line are assumed to have been written right after the
+ * last access, and then arrive back to back at the baud rate.
+ *
+ */
+static void usart_receive()
+{
+	unsigned long now = clock_us();
+
+	if (!usart_active) {
+		usart_active = true;
+		usart_wire.clear();
+		usart_rx.clear();
+		usart_started = false;
+		usart_access_us = now;
+	}
+
+	if (usart_wire.empty() && usart_wire_ns < usart_access_us * 1000ULL)
+		usart_wire_ns = usart_access_us * 1000ULL;
+
+	// Only look for new bytes once the line runs dry, reading takes longer than a register access
+	uint8_t buf[256];
+	ssize_t n;
+	while (usart_fd >= 0 && usart_wire.size() < 16 && (n = ::read(usart_fd, buf, sizeof(buf))) > 0)
+		usart_wire.insert(usart_wire.end(), buf, buf + n);
+
+	// Let the host write, the time only advances while the stand-in runs (See clock_us())
+	if (usart_wire.empty())
+		sched_yield();
+
+	// 10 bits (8N1) per byte
+	unsigned long long byte_ns = 10ULL * ((usart_ctrl & _BV(U2X0)) ? 8 : 16) * (UBRR0 + 1) * 1000 / (F_CPU / 1000000);
+
+	while (!usart_wire.empty()) {
+		// The byte in the shift register is lost once the next start bit arrives with the FIFO full
+		if (!usart_started) {
+			if (usart_wire_ns > now * 1000ULL)
+				break;
+
+			usart_started = true;
+			if (usart_rx.size() == 3) {
+				usart_rx.pop_back();
+				usart_rx.back().dor = true;
+			}
+		}
+
+		if (usart_wire_ns + byte_ns > now * 1000ULL)
+			break;
+
+		usart_rx.push_back({usart_wire.front(), false});
+		usart_wire.pop_front();
+		usart_wire_ns += byte_ns;
+		usart_started = false;
+	}
+
+	usart_access_us = now;
+}
+
+// See header file for documentation.
+ShimUcsr0a::operator uint8_t() const
+{
+	if (!(UCSR0B & _BV(RXEN0))) {
+		usart_active = false;
+		return usart_ctrl;
+	}
+
+	usart_receive();
+
+	uint8_t val = usart_ctrl | _BV(UDRE0);
+	if (!usart_rx.empty())
+		val |= _BV(RXC0) | (usart_rx.front().dor ? _BV(DOR0) : 0);
+
+	return val;
+}
+
+// See header file for documentation.
+ShimUcsr0a &ShimUcsr0a::operator=(uint8_t val)
+{
+	usart_ctrl = val & _BV(U2X0);
+	return *this;
+}
+
+// See header file for documentation.
+ShimUdr0::operator uint8_t() const
+{
+	if (!(UCSR0B & _BV(RXEN0)))
+		return 0;
+
+	usart_receive();
+	if (usart_rx.empty())
+		return 0;
+
+	uint8_t c = usart_rx.front().c;
+	usart_rx.pop_front();
+	return c;
+}
+
+// See header file for documentation.
+ShimUdr0 &ShimUdr0::operator=(uint8_t c)
+{
+	if (UCSR0B & _BV(TXEN0))
+		Serial.write(c);
+
+	return *this;
+}
+
+// See header file for documentation.
+ShimAdcsra::operator uint8_t() const
+{
+	// Conversions polled with the interrupt disabled are waited for
+	if ((adcsra & _BV(ADSC)) && !(adcsra & _BV(ADIE))) {
+		ADC = pots[ADMUX & 3];
+		adcsra &= ~_BV(ADSC);
+	}
+
+	return adcsra;
+}
+
+// See header file for documentation.
+ShimAdcsra &ShimAdcsra::operator=(uint8_t val)
+{
+	adcsra = val;
+	return *this;
+}
+
+// See header file for documentation.
+ShimAdcsra &ShimAdcsra::operator|=(uint8_t val)
+{
+	adcsra |= val;
+	return *this;
+}
+
+// See header file for documentation.
+ShimAdcsra &ShimAdcsra::operator&=(uint8_t val)
+{
+	adcsra &= val;
+	return *this;
+}
+
+// See header file for documentation.
+uint16_t shim_tcnt1()
+{
+	return clock_us() / 16;
+}
+
+// See header file for documentation.
+void pinMode(uint8_t pin, uint8_t mode)
+{
+}
+
+// See header file for documentation.
+int analogRead(uint8_t pin)
+{
+	return pots[(pin - A0) & 3];
+}
+
+// See header file for documentation.
+unsigned long millis()
+{
+	return clock_us() / 1000;
+}
+
+// See header file for documentation.
+unsigned long micros()
+{
+	return clock_us();
+}
+
+// See header file for documentation.
+void delay(unsigned long ms)
+{
+	if (clock_stopped)
+		clock_set_us += ms * 1000;
+	else
+		usleep(ms * 1000);
+}
+
+// See header file for documentation.
+void delayMicroseconds(unsigned int us)
+{
+	if (clock_stopped)
+		clock_set_us += us;
+	else
+		usleep(us);
+}
+
+// See header file for documentation.
+void attachInterrupt(uint8_t irq, void (*isr)(), int mode)
+{
+	// The simulated encoder never moves
+}
+
+// See header file for documentation.
+long random(long min, long max)
+{
+	// Same sequence on every host, so test runs can be compared
+	rand_state = rand_state * 1103515245UL + 12345;
+	return (max > min) ? min + (long) ((rand_state >> 16) % (max - min)) : min;
+}
+
+// See header file for documentation.
+void randomSeed(unsigned long seed)
+{
+	rand_state = seed;
+}
+
+// See header file for documentation.
+char *ultoa(unsigned long val, char *s, int radix)
+{
+	snprintf(s, 33, (radix == HEX) ? "%lx" : "%lu", val);
+	return s;
+}
+
+// See header file for documentation.
+void shim_clock_set(unsigned long us)
+{
+	clock_stopped = true;
+	clock_set_us = us;
+}
+
+// See header file for documentation.
+void shim_clock_step(unsigned long us)
+{
+	clock_step_us = us;
+}
+
+// See header file for documentation.
+void shim_set_pot(uint8_t pin, uint16_t val)
+{
+	pots[(pin - A0) & 3] = val;
+}
+
+// See header file for documentation.
+void shim_adc_convert()
+{
+	ADC = pots[ADMUX & 3];
+	adcsra &= ~_BV(ADSC);
+
+	if ((adcsra & _BV(ADIE)) && ADC_vect)
+		ADC_vect();
+}
+
+// See header file for documentation.
+size_t Print::write(const uint8_t *buf, size_t n)
+{
+	for (size_t i = 0; i < n; i++)
+		write(buf[i]);
+
+	return n;
+}
+
+// See header file for documentation.
+size_t Print::write(const char *str)
+{
+	return write((const uint8_t *) str, strlen(str));
+}
+
+// See header file for documentation.
+size_t Print::print(const char *str)
+{
+	return write(str);
+}
+
+// See header file for documentation.
+size_t Print::print(const __FlashStringHelper *str)
+{
+	return write((const char *) str);
+}
+
+// See header file for documentation.
+size_t Print::print(char c)
+{
+	return write((uint8_t) c);
+}
+
+// See header file for documentation.
+size_t Print::print(long n, int base)
+{
+	char buf[24];
+	snprintf(buf, sizeof(buf), (base == HEX) ? "%lX" : "%ld", n);
+	return write(buf);
+}
+
+// See header file for documentation.
+size_t Print::print(unsigned long n, int base)
+{
+	char buf[24];
+	snprintf(buf, sizeof(buf), (base == HEX) ? "%lX" : "%lu", n);
+	return write(buf);
+}
+
+// See header file for documentation.
+size_t Print::print(int n, int base)
+{
+	return print((long) n, base);
+}
+
+// See header file for documentation.
+size_t Print::print(unsigned int n, int base)
+{
+	return print((unsigned long) n, base);
+}
+
+// See header file for documentation.
+size_t Print::println()
+{
+	return write("\r\n");
+}
+
+// See header file for documentation.
+void Stream::setTimeout(unsigned long ms)
+{
+	timeout = ms;
+}
+
+// See header file for documentation.
+size_t Stream::readBytes(char *buf, size_t n)
+{
+	return readBytes((uint8_t *) buf, n);
+}
+
+// See header file for documentation.
+size_t Stream::readBytes(uint8_t *buf, size_t n)
+{
+	size_t i = 0;
+	unsigned long start = millis();
+
+	while (i < n && millis() - start < timeout) {
+		int c = read();
+		if (c >= 0)
+			buf[i++] = c;
+		else
+			usleep(100);
+	}
+
+	return i;
+}
+
+// See header file for documentation.
+void HardwareSerial::attach(int fd)
+{
+	this->fd = fd;
+	usart_fd = fd;
+}
+
+// See header file for documentation.
+void HardwareSerial::begin(unsigned long baud)
+{
+}
+
+// See header file for documentation.
+void HardwareSerial::end()
+{
+}
+
+// See header file for documentation.
+void HardwareSerial::flush()
+{
+}
+
+// See header file for documentation.
+int HardwareSerial::availableForWrite()
+{
+	return 63; // Writes block until the pseudo terminal has taken the data
+}
+
+// See header file for documentation.
+HardwareSerial::operator bool()
+{
+	return fd >= 0;
+}
+
+// See header file for documentation.
+void HardwareSerial::fill()
+{
+	if (fd < 0 || rx_len == sizeof(rx_buf))
+		return;
+
+	// Move the buffered bytes to the front, and append what's available
+	memmove(rx_buf, rx_buf + rx_head, rx_len);
+	rx_head = 0;
+
+	ssize_t n = ::read(fd, rx_buf + rx_len, sizeof(rx_buf) - rx_len);
+	if (n > 0)
+		rx_len += n;
+}
+
+// See header file for documentation.
+size_t HardwareSerial::write(uint8_t c)
+{
+	return write(&c, 1);
+}
+
+// See header file for documentation.
+size_t HardwareSerial::write(const uint8_t *buf, size_t n)
+{
+	size_t sent = 0;
+
+	while (fd >= 0 && sent < n) {
+		ssize_t ret = ::write(fd, buf + sent, n - sent);
+
+		if (ret > 0) {
+			sent += ret;
+		} else if (ret < 0 && errno == EAGAIN) {
+			struct pollfd pfd = {fd, POLLOUT, 0};
+			poll(&pfd, 1, 100);
+		} else {
+			break;
+		}
+	}
+
+	return sent;
+}
+
+// See header file for documentation.
+int HardwareSerial::available()
+{
+	fill();
+	return rx_len;
+}
+
+// See header file for documentation.
+int HardwareSerial::read()
+{
+	if (!available())
+		return -1;
+
+	rx_len--;
+	return rx_buf[rx_head++];
+}
+
+// See header file for documentation.
+int HardwareSerial::peek()
+{
+	if (!available())
+		return -1;
+
+	return rx_buf[rx_head];
+}
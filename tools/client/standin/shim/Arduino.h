@@ -0,0 +1,161 @@
+/*
+ * Copyright (C) 2022 Patrick Pedersen, TU-DO Makerspace
+
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * @file Arduino.h
+ * @author Patrick Pedersen
+ *
+ * @brief Host stand-in for the Arduino core.
+ *
+ * The following file provides the parts of the Arduino core used by the
+ * firmware modules built into the stand-in (See standin.cpp). Serial is
+ * connected to a pseudo terminal instead of the USART.
+ *
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <avr/io.h>
+#include <avr/pgmspace.h>
+#include <avr/interrupt.h>
+
+typedef bool boolean;
+typedef uint8_t byte;
+
+#define F_CPU 16000000UL
+
+#define INPUT 0
+#define OUTPUT 1
+#define INPUT_PULLUP 2
+
+#define CHANGE 1
+
+#define A0 14
+#define A1 15
+#define A2 16
+#define A3 17
+
+#define DEC 10
+#define HEX 16
+
+#define _BV(b) (1 << (b))
+
+// All pins map to PIND, the simulated encoder never moves
+#define digitalPinToPort(pin) (0)
+#define digitalPinToBitMask(pin) ((uint8_t)(1 << ((pin) & 7)))
+#define portInputRegister(port) (&PIND)
+#define digitalPinToInterrupt(pin) ((pin) - 2)
+#define min(a, b) ((a) < (b) ? (a) : (b))
+#define max(a, b) ((a) > (b) ? (a) : (b))
+
+class __FlashStringHelper;
+#define F(s) (reinterpret_cast<const __FlashStringHelper *>(PSTR(s)))
+
+void pinMode(uint8_t pin, uint8_t mode);
+int analogRead(uint8_t pin);
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+void attachInterrupt(uint8_t irq, void (*isr)(), int mode);
+
+long random(long min, long max);
+void randomSeed(unsigned long seed);
+char *ultoa(unsigned long val, char *s, int radix);
+
+class Print
+{
+public:
+	virtual size_t write(uint8_t c) = 0;
+	virtual size_t write(const uint8_t *buf, size_t n);
+	size_t write(const char *str);
+
+	size_t print(const char *str);
+	size_t print(const __FlashStringHelper *str);
+	size_t print(char c);
+	size_t print(long n, int base = DEC);
+	size_t print(unsigned long n, int base = DEC);
+	size_t print(int n, int base = DEC);
+	size_t print(unsigned int n, int base = DEC);
+
+	size_t println();
+	template <typename T>
+	size_t println(T val)
+	{
+		size_t n = print(val);
+		return n + println();
+	}
+	template <typename T>
+	size_t println(T val, int base)
+	{
+		size_t n = print(val, base);
+		return n + println();
+	}
+};
+
+class Stream : public Print
+{
+protected:
+	unsigned long timeout = 1000;
+
+public:
+	virtual int available() = 0;
+	virtual int read() = 0;
+	virtual int peek() = 0;
+
+	void setTimeout(unsigned long ms);
+	size_t readBytes(char *buf, size_t n);
+	size_t readBytes(uint8_t *buf, size_t n);
+};
+
+/**
+ * @brief Serial port connected to a file descriptor (See shim_serial_attach()).
+ */
+class HardwareSerial : public Stream
+{
+private:
+	int fd = -1;
+	uint8_t rx_buf[64]; // Same size as the tester's RX buffer
+	uint8_t rx_head = 0;
+	uint8_t rx_len = 0;
+
+	void fill();
+
+public:
+	void attach(int fd);
+
+	void begin(unsigned long baud);
+	void end();
+	void flush();
+	int availableForWrite();
+	operator bool();
+
+	using Print::write;
+	size_t write(uint8_t c) override;
+	size_t write(const uint8_t *buf, size_t n) override;
+	int available() override;
+	int read() override;
+	int peek() override;
+};
+
+extern HardwareSerial Serial;
@@ -0,0 +1,67 @@
+/*
+ * Copyright (C) 2022 Patrick Pedersen, TU-DO Makerspace
+
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * @file EEPROM.h
+ * @author Patrick Pedersen
+ *
+ * @brief Host stand-in for the Arduino EEPROM library.
+ *
+ * The EEPROM is simulated in RAM and erased (0xFF) on every start,
+ * so stored calibrations don't outlive the stand-in.
+ *
+ */
+
+#pragma once
+
+#include <string.h>
+
+#include <Arduino.h>
+
+#define E2END 0x3FF // Last EEPROM address of the ATmega328P
+
+/**
+ * @brief Simulated EEPROM.
+ */
+class EEPROMClass
+{
+private:
+	uint8_t data[E2END + 1];
+
+public:
+	EEPROMClass()
+	{
+		memset(data, 0xFF, sizeof(data));
+	}
+
+	template <typename T>
+	T &get(int idx, T &t)
+	{
+		memcpy(&t, data + idx, sizeof(T));
+		return t;
+	}
+
+	template <typename T>
+	const T &put(int idx, const T &t)
+	{
+		memcpy(data + idx, &t, sizeof(T));
+		return t;
+	}
+};
+
+extern EEPROMClass EEPROM;
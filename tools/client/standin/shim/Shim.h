@@ -0,0 +1,153 @@
+/*
+ * Copyright (C) 2022 Patrick Pedersen, TU-DO Makerspace
+
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * @file Shim.h
+ * @author Patrick Pedersen
+ *
+ * @brief Controls the simulated hardware of the stand-in.
+ *
+ * The following file declares the functions through which the stand-in
+ * (See standin.cpp) and the host tests (See test/host) set the simulated
+ * inputs and the clock, and inspect the frames and I2C transmissions
+ * sent by the firmware modules.
+ *
+ */
+
+#pragma once
+
+#include <Arduino.h>
+#include <ws2812.h>
+
+/**
+ * @brief Sets the value of a simulated pot.
+ *
+ * @param pin The pin of the pot (A0 to A3).
+ * @param val The 10-bit ADC value of the pot.
+ *
+ */
+void shim_set_pot(uint8_t pin, uint16_t val);
+
+/**
+ * @brief Completes an ADC conversion.
+ *
+ * The following function stores the value of the pot selected by ADMUX
+ * in ADC, and calls the ADC interrupt handler if it is enabled. It
+ * stands in for the ADC, which converts continuously on the tester.
+ *
+ */
+void shim_adc_convert();
+
+/**
+ * @brief Returns the last frame transmitted through the TinyWS2812 stand-in.
+ *
+ * @param len Receives the size of the frame in bytes, in the configured color order.
+ * @return const uint8_t* The bytes of the frame.
+ *
+ */
+const uint8_t *shim_frame(size_t &len);
+
+/**
+ * @brief Stops the clock at the given time.
+ *
+ * By default, millis() and micros() follow the host's clock. Once
+ * this function has been called, they return the given time instead,
+ * so tests can step through time independently of the host's speed.
+ *
+ * @param us The time in microseconds.
+ *
+ */
+void shim_clock_set(unsigned long us);
+
+/**
+ * @brief Lets the stopped clock advance on its own.
+ *
+ * Once this function has been called, each reading of millis() or
+ * micros() advances the clock set by shim_clock_set() by the given step,
+ * so busy waits terminate, and time only depends on the code that runs.
+ * While the clock is stopped, delay() advances it instead of sleeping.
+ *
+ * @param us The step in microseconds, 0 to stop the clock again.
+ *
+ */
+void shim_clock_step(unsigned long us);
+
+/**
+ * @brief Receives the frames of the TinyWS2812 stand-in (See ws2812.h).
+ *
+ * @param open True once a frame is started (ws2812_prep_tx()),
+ *             false once it has been sent (ws2812_close_tx()).
+ *
+ */
+typedef void (*ShimFrameSink)(bool open);
+
+/**
+ * @brief Sets the receiver of the TinyWS2812 stand-in's frames.
+ *
+ * @param sink The receiver, or nullptr to stop reporting frames.
+ *
+ */
+void shim_frame_sink(ShimFrameSink sink);
+
+/**
+ * @brief Receives the transmissions of the TWI stand-in (See Twi.h).
+ *
+ * @param addr The 7-bit address of the device.
+ * @param ctrl The control byte sent ahead of the data.
+ * @param data The data bytes.
+ * @param len The number of data bytes.
+ *
+ */
+typedef void (*ShimTwiSink)(uint8_t addr, uint8_t ctrl, const uint8_t *data, uint8_t len);
+
+/**
+ * @brief Sets the receiver of the TWI stand-in's transmissions.
+ *
+ * twi_busy() reports each transmission as in progress once. The
+ * transmission is passed on once it completes, that is once twi_busy()
+ * reports it as completed, twi_wait() is called, or the next transmission
+ * is started. Data that is modified before then is passed on modified,
+ * as it would be sent on the tester.
+ *
+ * @param sink The receiver, or nullptr to discard transmissions.
+ *
+ */
+void shim_twi_sink(ShimTwiSink sink);
+
+/**
+ * @brief Lets transmissions of the TWI stand-in take time.
+ *
+ * By default, transmissions complete once twi_busy() has reported them
+ * as in progress. Once timed, they take as long as they would at the
+ * clock passed to twi_init(), with 9 bits per byte (8 bits and the ACK)
+ * for the address, the control byte and the data.
+ *
+ * @param timed True to time transmissions.
+ *
+ */
+void shim_twi_timed(bool timed);
+
+/**
+ * @brief Returns the time left of the TWI transmission in flight.
+ *
+ * @return unsigned long The time (us) until the transmission in
+ *         flight has been sent, 0 if none is in flight or if
+ *         transmissions aren't timed (See shim_twi_timed()).
+ *
+ */
+unsigned long shim_twi_remaining();
@@ -0,0 +1,140 @@
+/*
+ * Copyright (C) 2022 Patrick Pedersen, TU-DO Makerspace
+
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * @file Twi.cpp
+ * @author Patrick Pedersen
+ *
+ * @brief Host stand-in for the interrupt driven I2C transmitter.
+ *
+ * The following file implements the firmware's TWI interface (See Twi.h)
+ * on the host. Rather than being sent over I2C, transmissions are passed
+ * on to the sink set by shim_twi_sink() once they complete (See Shim.h).
+ *
+ */
+
+#include <Arduino.h>
+#include <Shim.h>
+#include <Twi.h>
+
+static ShimTwiSink sink = nullptr;
+static bool timed = false;   // Transmissions take time (See shim_twi_timed())
+static uint32_t bus_hz = 100000;
+
+// Transmission in progress
+static bool busy = false;
+static bool polled = false; // twi_busy() has reported the transmission in progress
+static uint8_t tx_addr, tx_ctrl, tx_len;
+static const uint8_t *tx_data;
+static unsigned long tx_start, tx_us; // Time of a timed transmission
+
+/**
+ * @brief Completes the transmission in progress.
+ */
+static void complete()
+{
+	if (!busy)
+		return;
+
+	busy = false;
+	if (sink)
+		sink(tx_addr, tx_ctrl, tx_data, tx_len);
+}
+
+// See header file for documentation.
+void shim_twi_sink(ShimTwiSink s)
+{
+	sink = s;
+}
+
+// See header file for documentation.
+void twi_init(uint32_t freq)
+{
+	bus_hz = freq;
+}
+
+// See header file for documentation.
+void twi_write_async(uint8_t addr, uint8_t ctrl, const uint8_t *data, uint8_t len)
+{
+	twi_wait();
+
+	tx_addr = addr;
+	tx_ctrl = ctrl;
+	tx_data = data;
+	tx_len = len;
+	busy = true;
+	polled = false;
+
+	// Address, control byte and data, 9 bits each
+	tx_start = micros();
+	tx_us = (len + 2) * 9 * 1000000UL / bus_hz;
+}
+
+// See header file for documentation.
+bool twi_write(uint8_t addr, uint8_t ctrl, const uint8_t *data, uint8_t len)
+{
+	twi_write_async(addr, ctrl, data, len);
+	return twi_wait();
+}
+
+// See header file for documentation.
+bool twi_busy()
+{
+	if (timed) {
+		if (busy && micros() - tx_start < tx_us)
+			return true;
+
+		complete();
+		return false;
+	}
+
+	// Report each transmission as in progress once, like the
+	// tester does while it is still sent in the background
+	if (busy && !polled) {
+		polled = true;
+		return true;
+	}
+
+	complete();
+	return false;
+}
+
+// See header file for documentation.
+bool twi_wait()
+{
+	while (timed && twi_busy());
+
+	complete();
+	return true;
+}
+
+// See header file for documentation.
+void shim_twi_timed(bool t)
+{
+	timed = t;
+}
+
+// See header file for documentation.
+unsigned long shim_twi_remaining()
+{
+	if (!timed || !busy)
+		return 0;
+
+	unsigned long us = micros() - tx_start;
+	return (us < tx_us) ? tx_us - us : 0;
+}
@@ -0,0 +1,35 @@
+/*
+ * Copyright (C) 2022 Patrick Pedersen, TU-DO Makerspace
+
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * @file avr/interrupt.h
+ * @author Patrick Pedersen
+ *
+ * @brief Host stand-in for avr/interrupt.h.
+ *
+ * The stand-in is single threaded, interrupt handlers are plain
+ * functions which are called from the main loop (See shim_adc_convert()).
+ *
+ */
+
+#pragma once
+
+#define ISR(vector) extern "C" void vector(void); void vector(void)
+
+#define cli()
+#define sei()
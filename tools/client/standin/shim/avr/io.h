@@ -0,0 +1,111 @@
+/*
+ * Copyright (C) 2022 Patrick Pedersen, TU-DO Makerspace
+
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * @file avr/io.h
+ * @author Patrick Pedersen
+ *
+ * @brief Host stand-in for the AVR I/O registers.
+ *
+ * The following file provides the registers accessed by the firmware
+ * modules built into the stand-in as plain variables. Timer1 counts
+ * the host's clock at 16 us per tick (See FrameMeter::begin()), so
+ * frames are timed like on the tester.
+ *
+ * While its receiver is enabled (RXEN0 in UCSR0B), the USART is
+ * simulated on top of the pseudo terminal Serial is attached to, as
+ * it is polled directly by the firmware (See Adalight). Bytes written
+ * by the host arrive at the baud rate set in UBRR0, and only 3 bytes
+ * (the 2 byte FIFO and the shift register) are held until UDR0 is read.
+ * Further bytes are lost, and flagged by DOR0 like on the tester.
+ *
+ * The ADC converts when told to by shim_adc_convert() (See Shim.h).
+ * Conversions started with the ADC interrupt disabled are polled for
+ * by the firmware (See InputWatch), and complete once ADCSRA is read.
+ *
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+extern volatile uint8_t SREG;
+extern volatile uint8_t PIND;
+extern volatile uint8_t TIFR1;
+extern volatile uint8_t TCCR1A;
+extern volatile uint8_t TCCR1B;
+extern volatile uint8_t TIMSK1;
+extern volatile uint8_t UCSR0B;
+extern volatile uint8_t UCSR0C;
+extern volatile uint16_t UBRR0;
+extern volatile uint8_t ADMUX;
+extern volatile uint16_t ADC;
+
+/**
+ * @brief Status register of the simulated USART.
+ */
+struct ShimUcsr0a
+{
+	operator uint8_t() const;
+	ShimUcsr0a &operator=(uint8_t val);
+};
+
+/**
+ * @brief Data register of the simulated USART.
+ */
+struct ShimUdr0
+{
+	operator uint8_t() const;
+	ShimUdr0 &operator=(uint8_t c);
+};
+
+/**
+ * @brief Control and status register of the simulated ADC.
+ */
+struct ShimAdcsra
+{
+	operator uint8_t() const;
+	ShimAdcsra &operator=(uint8_t val);
+	ShimAdcsra &operator|=(uint8_t val);
+	ShimAdcsra &operator&=(uint8_t val);
+};
+
+extern ShimUcsr0a UCSR0A;
+extern ShimUdr0 UDR0;
+extern ShimAdcsra ADCSRA;
+
+uint16_t shim_tcnt1();
+#define TCNT1 (shim_tcnt1())
+
+#define RAMEND 0x8FF // Last address of the ATmega328P's RAM (See MemMonitor)
+
+#define TOV1 0
+#define CS12 2
+#define RXC0 7
+#define UDRE0 5
+#define DOR0 3
+#define U2X0 1
+#define RXEN0 4
+#define TXEN0 3
+#define UCSZ01 2
+#define UCSZ00 1
+#define UDRIE0 5
+#define ADSC 6
+#define ADIF 4
+#define ADIE 3
+#define REFS0 6
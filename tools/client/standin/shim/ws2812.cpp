@@ -0,0 +1,105 @@
+/*
+ * Copyright (C) 2022 Patrick Pedersen, TU-DO Makerspace
+
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * @file ws2812.cpp
+ * @author Patrick Pedersen
+ *
+ * @brief Host stand-in for the TinyWS2812 library.
+ *
+ * The following file implements the TinyWS2812 stand-in.
+ * See ws2812.h for more information.
+ *
+ */
+
+#include <vector>
+
+#include <Arduino.h>
+#include <config.h>
+#include <Shim.h>
+#include <ws2812.h>
+
+static std::vector<uint8_t> tx_frame; // Frame being transmitted
+static std::vector<uint8_t> frame;    // Last completed frame
+static ShimFrameSink sink = nullptr;
+
+// See header file for documentation.
+uint8_t ws2812_config(ws2812 *dev, ws2812_cfg *cfg)
+{
+	if (cfg->n_dev != 1)
+		return 1;
+
+	dev->order = cfg->order;
+	return 0;
+}
+
+// See header file for documentation.
+void ws2812_prep_tx(ws2812 *dev)
+{
+	tx_frame.clear();
+
+	if (sink)
+		sink(true);
+}
+
+// See header file for documentation.
+void ws2812_tx(ws2812 *dev, ws2812_rgb *leds, size_t n)
+{
+	unsigned long start = micros();
+
+	for (size_t i = 0; i < n; i++) {
+		uint8_t px[3];
+
+		switch (dev->order) {
+		case rgb: px[0] = leds[i].r; px[1] = leds[i].g; px[2] = leds[i].b; break;
+		case rbg: px[0] = leds[i].r; px[1] = leds[i].b; px[2] = leds[i].g; break;
+		case grb: px[0] = leds[i].g; px[1] = leds[i].r; px[2] = leds[i].b; break;
+		case gbr: px[0] = leds[i].g; px[1] = leds[i].b; px[2] = leds[i].r; break;
+		case brg: px[0] = leds[i].b; px[1] = leds[i].r; px[2] = leds[i].g; break;
+		case bgr: px[0] = leds[i].b; px[1] = leds[i].g; px[2] = leds[i].r; break;
+		}
+
+		tx_frame.insert(tx_frame.end(), px, px + 3);
+	}
+
+	// Like the bit-banged transmission, return once the LEDs have been sent
+	unsigned long wire_us = n * 3 * 8 * WS2812_BIT_NS / 1000;
+	while (micros() - start < wire_us);
+}
+
+// See header file for documentation.
+void ws2812_close_tx(ws2812 *dev)
+{
+	frame.swap(tx_frame);
+
+	if (sink)
+		sink(false);
+}
+
+// See header file for documentation.
+void shim_frame_sink(ShimFrameSink s)
+{
+	sink = s;
+}
+
+// See header file for documentation.
+const uint8_t *shim_frame(size_t &len)
+{
+	len = frame.size();
+	return frame.data();
+}
@@ -0,0 +1,66 @@
+/*
+ * Copyright (C) 2022 Patrick Pedersen, TU-DO Makerspace
+
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * @file ws2812.h
+ * @author Patrick Pedersen
+ *
+ * @brief Host stand-in for the TinyWS2812 library.
+ *
+ * The following file provides the TinyWS2812 C API used by the Strip
+ * class. Instead of driving a pin, transmitted frames are captured (See
+ * shim_frame()), and each transmission takes as long as it would on the
+ * wire (WS2812_BIT_NS per bit).
+ *
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+typedef struct {
+	uint8_t r;
+	uint8_t g;
+	uint8_t b;
+} ws2812_rgb;
+
+typedef enum {
+	rgb,
+	rbg,
+	grb,
+	gbr,
+	brg,
+	bgr
+} ws2812_order;
+
+typedef struct {
+	uint8_t *pins;
+	uint8_t n_dev;
+	unsigned int rst_time_us;
+	ws2812_order order;
+} ws2812_cfg;
+
+typedef struct {
+	ws2812_order order;
+} ws2812;
+
+uint8_t ws2812_config(ws2812 *dev, ws2812_cfg *cfg);
+void ws2812_prep_tx(ws2812 *dev);
+void ws2812_tx(ws2812 *dev, ws2812_rgb *leds, size_t n);
+void ws2812_close_tx(ws2812 *dev);
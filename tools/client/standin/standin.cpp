@@ -0,0 +1,396 @@
+/*
+ * Copyright (C) 2022 Patrick Pedersen, TU-DO Makerspace
+
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * @file standin.cpp
+ * @author Patrick Pedersen
+ *
+ * @brief Firmware stand-in for testing host tools without a tester.
+ *
+ * The following file contains a stand-in for the tester's firmware,
+ * which runs on the host and talks through a pseudo terminal. It is
+ * built from the firmware's modules on top of a host shim of the Arduino
+ * core (See shim/), and answers the tester's serial commands through the
+ * same handlers as the firmware (See Commands.h):
+ * 	"leds", "lat", "win", "bisect", "stress", "rstcal", "dither",
+ * 	"color", "pattern", "rle", "stream"
+ * Frames take as long as they would on the wire, and streamed frames
+ * are received through a simulation of the tester's USART (See
+ * shim/avr/io.h), so the streaming frame rate and lost bytes can be
+ * measured with scripts/adalight_send.py. As the tester's pots
+ * can't be turned remotely, the stand-in adds two commands of its own:
+ * 	"pots <r> <g> <b>" - Sets the simulated pots (10-bit ADC values)
+ * 	"frame"            - Prints the size and checksum of the last frame
+ *
+ * Usage:
+ * 	standin [-l <link>]
+ * The path of the pseudo terminal is printed on startup, and
+ * optionally linked to <link>.
+ *
+ */
+
+#include <fcntl.h>
+#include <signal.h>
+#include <stdio.h>
+#include <termios.h>
+#include <unistd.h>
+#include <poll.h>
+
+#include <Arduino.h>
+#include <config.h>
+#include <Shim.h>
+#include <Strip.h>
+#include <SizeEncoder.h>
+#include <ColorPots.h>
+#include <Display.h>
+#include <Bisect.h>
+#include <FrameMeter.h>
+#include <ResetCal.h>
+#include <EventQueue.h>
+#include <SerialCmd.h>
+#include <Rle.h>
+#include <Log.h>
+#include <Commands.h>
+
+#define ADC_CONVERSION_US 104 // ADC conversion time at a 125 kHz ADC clock (13 cycles)
+
+EventQueue events;
+Strip strip(WS2812_PIN);
+SizeEncoder size_enc(ENC_A, ENC_B, ROT_ENC_APPLY_TIME);
+ColorPots color_pots(POT_R, POT_G, POT_B);
+TesterDisplay display;
+Bisect bisect;
+FrameMeter frame_meter;
+ResetCal reset_cal;
+Adalight adalight;
+
+bool strip_pending = false;
+
+static volatile sig_atomic_t quit = 0;
+
+/**
+ * @brief Handles the "pots" serial command.
+ *
+ * The following function sets the simulated pots:
+ * 	"pots <r> <g> <b>"
+ * The new values are sampled in the background like on the tester,
+ * so it takes a full averaging period until they are applied.
+ *
+ * @param args The command arguments.
+ * @return bool True if the arguments are valid, false otherwise.
+ *
+ */
+bool cmd_pots(char *args)
+{
+	const uint8_t pins[3] = {POT_R, POT_G, POT_B};
+	unsigned long val[3];
+
+	for (uint8_t i = 0; i < 3; i++) {
+		char *end;
+		val[i] = strtoul(args, &end, 10);
+		if (end == args || val[i] > 1023)
+			return false;
+		args = end;
+	}
+
+	if (*args != '\0')
+		return false;
+
+	for (uint8_t i = 0; i < 3; i++)
+		shim_set_pot(pins[i], val[i]);
+
+	return true;
+}
+
+/**
+ * @brief Handles the "frame" serial command.
+ *
+ * The following function prints the number of bytes of the last
+ * transmitted frame and their FNV-1a checksum, so hosts can verify
+ * which frame has been shown.
+ *
+ * @param args Unused.
+ * @return bool Always true.
+ *
+ */
+bool cmd_frame(char *args)
+{
+	size_t len;
+	const uint8_t *data = shim_frame(len);
+	uint32_t hash = 2166136261UL;
+
+	for (size_t i = 0; i < len; i++)
+		hash = (hash ^ data[i]) * 16777619UL;
+
+	Serial.print((unsigned long) len);
+	Serial.print(F(" bytes, fnv1a "));
+	Serial.println((unsigned long) hash, HEX);
+	return true;
+}
+
+const char cmd_pots_name[] PROGMEM = "pots";
+const char cmd_frame_name[] PROGMEM = "frame";
+
+const SerialCmdEntry serial_cmds[] PROGMEM = {
+	{cmd_leds_name, cmd_leds},
+	{cmd_lat_name, cmd_lat},
+	{cmd_win_name, cmd_win},
+	{cmd_bisect_name, cmd_bisect},
+	{cmd_stress_name, cmd_stress},
+	{cmd_rstcal_name, cmd_rstcal},
+	{cmd_dither_name, cmd_dither},
+	{cmd_color_name, cmd_color},
+	{cmd_pattern_name, cmd_pattern},
+	{cmd_rle_name, cmd_rle},
+	{cmd_stream_name, cmd_stream},
+	{cmd_pots_name, cmd_pots},
+	{cmd_frame_name, cmd_frame},
+};
+
+SerialCmd serial_cmd(serial_cmds, sizeof(serial_cmds)/sizeof(SerialCmdEntry));
+
+/**
+ * @brief Returns if the strip is refreshed back to back.
+ *
+ * @return bool True in stress mode and while calibrating the reset time, false otherwise.
+ *
+ */
+bool back_to_back()
+{
+	return stress || mode == MODE_RESET_CAL;
+}
+
+/**
+ * @brief Transmits a strip frame.
+ *
+ * Like on the tester (See service_outputs() in main.cpp), stress
+ * frames alternate between STRESS_PATTERN_A and STRESS_PATTERN_B,
+ * frames are sent in bursts while the reset time is calibrated, and
+ * the shown RLE frame is sent in pattern mode. As the stand-in's inputs
+ * only change between frames, frames are never aborted.
+ *
+ * @param metering Count the frame with the frame meter.
+ *
+ */
+void show_frame(bool metering)
+{
+	static bool odd_frame = false;
+
+	if (stress) {
+		uint8_t p = odd_frame ? STRESS_PATTERN_B : STRESS_PATTERN_A;
+		strip.set_rgb(p, p, p);
+	}
+
+	strip.set_white_extraction(STRIP_WHITE_EXTRACT && !stress &&
+				   mode != MODE_PATTERN && mode != MODE_RESET_CAL);
+
+	if (mode == MODE_RESET_CAL) {
+		strip.repeat_strip(RESET_CAL_BURST);
+		return;
+	}
+
+	if (mode == MODE_PATTERN) {
+		RleDecoder rle(rle_shown.data, rle_shown.len, rle_progmem);
+		strip.rle_frame(rle);
+	} else {
+		strip.update_strip();
+		odd_frame = !odd_frame;
+	}
+
+	if (metering)
+		frame_meter.frame();
+}
+
+/**
+ * @brief Opens the pseudo terminal the stand-in talks through.
+ *
+ * @param slave Receives the file descriptor of the slave side, which is
+ *              kept open so the master side survives hosts disconnecting.
+ * @return int The file descriptor of the master side, or -1 on failure.
+ *
+ */
+int open_pty(int &slave)
+{
+	int master = posix_openpt(O_RDWR | O_NOCTTY);
+	if (master < 0 || grantpt(master) != 0 || unlockpt(master) != 0)
+		return -1;
+
+	slave = open(ptsname(master), O_RDWR | O_NOCTTY);
+	if (slave < 0)
+		return -1;
+
+	struct termios tio;
+	tcgetattr(slave, &tio);
+	cfmakeraw(&tio);
+	tcsetattr(slave, TCSANOW, &tio);
+
+	fcntl(master, F_SETFL, fcntl(master, F_GETFL) | O_NONBLOCK);
+	return master;
+}
+
+/**
+ * @brief Stands in for the ADC, which samples the pots continuously.
+ *
+ * The following function completes as many conversions as the
+ * ADC would have completed since the last call (See shim_adc_convert()).
+ *
+ */
+void sample_pots()
+{
+	static unsigned long adc_tstamp = 0;
+	unsigned long n = (micros() - adc_tstamp) / ADC_CONVERSION_US;
+
+	if (n > 3UL * AVG_ADC_SAMPLES)
+		n = 3UL * AVG_ADC_SAMPLES;
+
+	adc_tstamp += n * ADC_CONVERSION_US;
+	while (n--)
+		shim_adc_convert();
+}
+
+/**
+ * @brief Signal handler to exit the main loop.
+ */
+void stop(int sig)
+{
+	quit = 1;
+}
+
+int main(int argc, char **argv)
+{
+	const char *link = nullptr;
+
+	int opt;
+	while ((opt = getopt(argc, argv, "l:")) != -1) {
+		if (opt != 'l') {
+			fprintf(stderr, "Usage: %s [-l <link>]\n", argv[0]);
+			return 1;
+		}
+		link = optarg;
+	}
+
+	int slave;
+	int master = open_pty(slave);
+	if (master < 0) {
+		perror("Failed to open pseudo terminal");
+		return 1;
+	}
+
+	const char *path = ptsname(master);
+	if (link) {
+		unlink(link);
+		if (symlink(path, link) != 0) {
+			perror("Failed to link pseudo terminal");
+			return 1;
+		}
+	}
+
+	printf("%s\n", path);
+	fflush(stdout);
+
+	signal(SIGINT, stop);
+	signal(SIGTERM, stop);
+
+	Serial.attach(master);
+	strip.begin();
+	strip.set_reset_time(ResetCal::load(STRIP_PROFILE_ID));
+	frame_meter.begin();
+	size_enc.begin(events);
+	color_pots.begin(events);
+	display.begin();
+	force_update = true;
+
+	bool pots_pending = false;
+	bool was_metering = false;
+
+	while (!quit) {
+		// Poll the USART without waiting while streaming, like the tester
+		if (streaming) {
+			stream_frames();
+			continue;
+		}
+
+		serial_cmd.update();
+		sample_pots();
+
+		bool changed = force_update;
+		force_update = false;
+
+		Event ev;
+		while (events.pop(ev))
+			pots_pending = pots_pending || ev.type == EVENT_POT;
+
+		// The simulated encoder never moves, but settles after commands like on the tester
+		size_enc.update();
+		if (size_enc.ready()) {
+			changed = changed || (size_enc.settled() && encoder_changed());
+			if (pots_pending && !back_to_back()) {
+				pots_pending = false;
+				if (color_pots.update()) {
+					strip.mark_input();
+					changed = true;
+				}
+			}
+		}
+
+		if (changed) {
+			apply_color();
+			apply_encoder();
+			strip_pending = true;
+			display.update();
+		}
+
+		// Stop dithering if the frame rate is too low, like the tester
+		bool dithered = strip.fractional() && strip.dithering();
+		bool metering = stress || dithered;
+		if (metering && !was_metering)
+			frame_meter.start();
+		was_metering = metering;
+
+		if (metering && frame_meter.update() && !stress && frame_meter.fps() < DITHER_MIN_FPS)
+			strip.set_dithering(false);
+
+		strip_pending = strip_pending || back_to_back() || dithered || strip.animated();
+
+		if (strip_pending && strip.latched()) {
+			show_frame(metering);
+			strip_pending = false;
+		}
+
+		display.flush();
+		log_flush();
+
+		// Switch the serial port to streaming once the reply has been sent
+		if (stream_pending) {
+			stream_pending = false;
+			start_stream();
+			continue;
+		}
+
+		// Wait for commands while idle
+		struct pollfd pfd = {master, POLLIN, 0};
+		poll(&pfd, 1, strip_pending ? 0 : 1);
+	}
+
+	if (link)
+		unlink(link);
+
+	close(slave);
+	close(master);
+	return 0;
+}
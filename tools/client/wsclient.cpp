@@ -0,0 +1,368 @@
+/*
+ * Copyright (C) 2022 Patrick Pedersen, TU-DO Makerspace
+
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * @file wsclient.cpp
+ * @author Patrick Pedersen
+ *
+ * @brief Runs scripted test sequences on one or more testers.
+ *
+ * The following file contains a command-line client which sends a
+ * script of serial commands (See the firmware's serial commands) to
+ * several testers at once. Commands are pipelined (See TesterLink), and
+ * the latency of every command as well as the sustained throughput
+ * are reported per tester.
+ *
+ * A script holds one command per line. Empty lines and lines starting
+ * with '#' are ignored, and
+ * 	"wait <ms>"
+ * waits for all commands in flight to be answered, and then pauses for
+ * ms milliseconds (ex. to let the pots settle on the stand-in).
+ *
+ * Usage:
+ * 	wsclient [options] -s <script> <port>...
+ * Options:
+ * 	-n <n>     Runs the script n times (default: 1)
+ * 	-w <n>     Max. commands in flight per tester (default: 4, 1: stop-and-wait)
+ * 	-W <n>     Max. bytes in flight per tester (default: 63, the Nano's RX buffer - 1)
+ * 	-b <baud>  Baud rate (default: 9600, SERIAL_BAUD)
+ * 	-d <ms>    Delay after opening the ports, as the Nano resets (default: 2000)
+ * 	-t <ms>    Timeout for the answer of a command (default: 1000)
+ * 	-v         Prints every command with its answer and output
+ * The exit status is 0 if every command has been answered with "ok".
+ *
+ */
+
+#include <errno.h>
+#include <poll.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Link.h"
+
+/**
+ * @brief A line of a script.
+ */
+struct Step {
+	std::string cmd;       /// The command, empty for a wait
+	unsigned long wait_ms; /// Pause (ms) of a wait
+};
+
+/**
+ * @brief The state and statistics of a tester running the script.
+ */
+struct Tester {
+	std::unique_ptr<TesterLink> link;
+	size_t step = 0;              // Next step of the script
+	unsigned long wait_until = 0; // End (us) of the current wait
+	bool waiting = false;         // A wait is in progress
+	bool failed = false;          // The port has failed
+
+	std::vector<unsigned long> latencies; // Latencies (us) of the answered commands
+	unsigned long n_ok = 0;
+	unsigned long n_err = 0;
+	unsigned long n_lost = 0;
+	unsigned long bytes = 0;      // Bytes sent
+	unsigned long start_us = 0;   // Time (us) the first command has been sent
+	unsigned long end_us = 0;     // Time (us) the last answer has been received
+};
+
+/**
+ * @brief Returns the time since the first call in microseconds.
+ *
+ * @return unsigned long The time (us).
+ *
+ */
+static unsigned long now_us()
+{
+	static struct timespec start;
+	struct timespec now;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	if (start.tv_sec == 0 && start.tv_nsec == 0)
+		start = now;
+
+	return (now.tv_sec - start.tv_sec) * 1000000UL + (now.tv_nsec - start.tv_nsec) / 1000;
+}
+
+/**
+ * @brief Loads a script.
+ *
+ * @param path The path of the script.
+ * @param repeat The number of times to repeat the script.
+ * @param steps Receives the steps of the script.
+ * @return bool True if the script has been loaded, false otherwise.
+ *
+ */
+static bool load_script(const char *path, unsigned long repeat, std::vector<Step> &steps)
+{
+	std::ifstream in(path);
+	if (!in)
+		return false;
+
+	std::vector<Step> once;
+	std::string line;
+
+	while (std::getline(in, line)) {
+		line.erase(std::remove(line.begin(), line.end(), '\r'), line.end());
+		if (line.empty() || line[0] == '#')
+			continue;
+
+		if (line.compare(0, 5, "wait ") == 0)
+			once.push_back({"", strtoul(line.c_str() + 5, nullptr, 10)});
+		else
+			once.push_back({line, 0});
+	}
+
+	for (unsigned long i = 0; i < repeat; i++)
+		steps.insert(steps.end(), once.begin(), once.end());
+
+	return true;
+}
+
+/**
+ * @brief Sends the next steps of the script, as far as the window allows.
+ *
+ * @param t The tester.
+ * @param steps The script.
+ *
+ */
+static void advance(Tester &t, const std::vector<Step> &steps)
+{
+	while (!t.failed && t.step < steps.size()) {
+		const Step &s = steps[t.step];
+		unsigned long now = now_us();
+
+		if (s.cmd.empty()) {
+			if (t.link->pending())
+				return;
+
+			if (!t.waiting) {
+				t.waiting = true;
+				t.wait_until = now + s.wait_ms * 1000;
+			}
+
+			if (now < t.wait_until)
+				return;
+
+			t.waiting = false;
+			t.step++;
+			continue;
+		}
+
+		if (!t.link->can_send(s.cmd))
+			return;
+
+		if (!t.link->send(s.cmd, now)) {
+			fprintf(stderr, "%s: %s\n", t.link->get_path().c_str(), strerror(errno));
+			t.failed = true;
+			return;
+		}
+
+		if (t.bytes == 0)
+			t.start_us = now;
+
+		t.bytes += s.cmd.size() + 1;
+		t.step++;
+	}
+}
+
+/**
+ * @brief Records the replies of a tester.
+ *
+ * @param t The tester.
+ * @param replies The replies.
+ * @param verbose True to print every reply.
+ *
+ */
+static void record(Tester &t, const std::vector<Reply> &replies, bool verbose)
+{
+	for (const Reply &r : replies) {
+		if (r.lost) {
+			t.n_lost++;
+		} else {
+			t.latencies.push_back(r.latency_us);
+			(r.ok ? t.n_ok : t.n_err)++;
+			t.end_us = now_us();
+		}
+
+		if (verbose || !r.ok) {
+			printf("%s: %-24s %-4s %8.2f ms\n", t.link->get_path().c_str(), r.cmd.c_str(),
+			       r.lost ? "lost" : (r.ok ? "ok" : "err"), r.latency_us / 1000.0);
+			if (verbose && !r.output.empty())
+				printf("%s", r.output.c_str());
+		}
+	}
+}
+
+/**
+ * @brief Prints the statistics of a tester.
+ *
+ * @param name The name of the tester.
+ * @param t The tester.
+ *
+ */
+static void report(const char *name, Tester &t)
+{
+	unsigned long n = t.n_ok + t.n_err + t.n_lost;
+	printf("%s: %lu commands, %lu ok, %lu err, %lu lost\n", name, n, t.n_ok, t.n_err, t.n_lost);
+
+	if (t.latencies.empty())
+		return;
+
+	std::vector<unsigned long> &l = t.latencies;
+	std::sort(l.begin(), l.end());
+
+	unsigned long long sum = 0;
+	for (unsigned long us : l)
+		sum += us;
+
+	printf("  latency: min %.2f ms, avg %.2f ms, p50 %.2f ms, p95 %.2f ms, max %.2f ms\n",
+	       l.front() / 1000.0, sum / 1000.0 / l.size(), l[l.size() / 2] / 1000.0,
+	       l[(l.size() * 95 - 1) / 100] / 1000.0, l.back() / 1000.0);
+
+	double secs = (t.end_us - t.start_us) / 1e6;
+	if (t.end_us > t.start_us)
+		printf("  throughput: %.1f commands/s, %.0f bytes/s over %.3f s\n",
+		       l.size() / secs, t.bytes / secs, secs);
+}
+
+/**
+ * @brief Prints the usage of the client.
+ *
+ * @param name The name of the executable.
+ *
+ */
+static void usage(const char *name)
+{
+	fprintf(stderr, "Usage: %s [-n repeat] [-w window] [-W window bytes] [-b baud] [-d boot delay ms]\n"
+			"       %*s [-t timeout ms] [-v] -s <script> <port>...\n", name, (int) strlen(name), "");
+}
+
+int main(int argc, char **argv)
+{
+	const char *script = nullptr;
+	unsigned long repeat = 1;
+	unsigned int window = 4;
+	unsigned int window_bytes = 63;
+	unsigned long baud = 9600;
+	unsigned long boot_ms = 2000;
+	unsigned long timeout_ms = 1000;
+	bool verbose = false;
+
+	int opt;
+	while ((opt = getopt(argc, argv, "s:n:w:W:b:d:t:v")) != -1) {
+		switch (opt) {
+		case 's': script = optarg; break;
+		case 'n': repeat = strtoul(optarg, nullptr, 10); break;
+		case 'w': window = strtoul(optarg, nullptr, 10); break;
+		case 'W': window_bytes = strtoul(optarg, nullptr, 10); break;
+		case 'b': baud = strtoul(optarg, nullptr, 10); break;
+		case 'd': boot_ms = strtoul(optarg, nullptr, 10); break;
+		case 't': timeout_ms = strtoul(optarg, nullptr, 10); break;
+		case 'v': verbose = true; break;
+		default: usage(argv[0]); return 2;
+		}
+	}
+
+	if (!script || optind == argc || window == 0) {
+		usage(argv[0]);
+		return 2;
+	}
+
+	std::vector<Step> steps;
+	if (!load_script(script, repeat, steps)) {
+		fprintf(stderr, "%s: %s\n", script, strerror(errno));
+		return 2;
+	}
+
+	std::vector<Tester> testers(argc - optind);
+	for (size_t i = 0; i < testers.size(); i++) {
+		testers[i].link.reset(new TesterLink(argv[optind + i], window, window_bytes));
+		if (!testers[i].link->open(baud)) {
+			fprintf(stderr, "%s: %s\n", argv[optind + i], strerror(errno));
+			return 2;
+		}
+	}
+
+	// Opening the port resets the Nano, wait for the bootloader to hand over
+	usleep(boot_ms * 1000);
+
+	std::vector<struct pollfd> fds(testers.size());
+	for (size_t i = 0; i < testers.size(); i++) {
+		fds[i] = {testers[i].link->get_fd(), POLLIN, 0};
+		testers[i].link->resync(now_us());
+	}
+
+	for (;;) {
+		bool done = true;
+
+		for (Tester &t : testers) {
+			advance(t, steps);
+			done = done && (t.failed || (t.step == steps.size() && !t.link->pending()));
+		}
+
+		if (done)
+			break;
+
+		poll(fds.data(), fds.size(), 1);
+
+		for (Tester &t : testers) {
+			std::vector<Reply> replies;
+
+			if (!t.failed && !t.link->read(now_us(), replies)) {
+				fprintf(stderr, "%s: port closed\n", t.link->get_path().c_str());
+				t.failed = true;
+			}
+
+			t.link->expire(now_us(), timeout_ms * 1000, replies);
+			record(t, replies, verbose);
+		}
+	}
+
+	Tester total;
+	total.start_us = testers[0].start_us;
+	bool ok = true;
+
+	for (Tester &t : testers) {
+		report(t.link->get_path().c_str(), t);
+		ok = ok && !t.failed && t.n_err == 0 && t.n_lost == 0;
+
+		total.latencies.insert(total.latencies.end(), t.latencies.begin(), t.latencies.end());
+		total.n_ok += t.n_ok;
+		total.n_err += t.n_err;
+		total.n_lost += t.n_lost;
+		total.bytes += t.bytes;
+		total.start_us = std::min(total.start_us, t.start_us);
+		total.end_us = std::max(total.end_us, t.end_us);
+	}
+
+	if (testers.size() > 1)
+		report("Total", total);
+
+	return ok ? 0 : 1;
+}